@@ -0,0 +1,485 @@
+#ifndef CLOSURE_DATABASE_H
+#define CLOSURE_DATABASE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CLOSURE_DATABASE_MMAP
+#endif
+
+#include "ProofEngine.h"
+#include "ProofSearch.h"
+
+// Closure of the expressions that have a proof of at most k steps, which is built once by taking the steps of the
+// laws from TRUE and FALSE, since every law is two-way. Each expression of the closure is stored with its fewest
+// steps to TRUE or FALSE and the law and index of a first step, in a perfect hash table that is memory-mapped
+// from a file, so that a minimal proof takes one lookup for each step instead of a search.
+// The laws do not depend on the names of variables, so expressions are stored with their variables renamed in
+// order of first occurrence, and the closure is for proofs without substitution, whose steps do not depend on
+// the variables in use. Operands that steps introduce are TRUE, FALSE, a variable in use or a new variable
+
+// Renames the variables of an expression in order of first occurrence, into one byte for each symbol, or returns
+// false if the expression is longer than maxLength or has more than maxVariables variables
+inline bool closureKey(const int f[], int fStop, int maxLength, int maxVariables, std::string& key) {
+    if (fStop > maxLength) {
+        return false;
+    }
+    key.resize(fStop);
+    int names[256];
+    int nameCount = 0;
+    for (int i = 0; i < fStop; i++) {
+        int symbol = f[i];
+        if (isVariable(symbol)) {
+            int k = 0;
+            while (k < nameCount && names[k] != symbol) {
+                k++;
+            }
+            if (k == nameCount) {
+                if (nameCount == maxVariables) {
+                    return false;
+                }
+                names[nameCount++] = symbol;
+            }
+            symbol = minVariable + k;
+        }
+        key[i] = (char) symbol;
+    }
+    return true;
+}
+
+inline uint64_t closureHash(const std::string& key, uint32_t seed) {
+    uint64_t hash = ((uint64_t) seed << 32) | (uint64_t) key.size();
+    for (char symbol : key) {
+        hash = mixStateHash(hash, (uint8_t) symbol);
+    }
+    return mixStateHash(hash, 0x9E3779B97F4A7C15ULL);
+}
+
+// Layout of a closure file, in the byte order of the machine: this header, a seed for each bucket of the perfect
+// hash, then a record for each slot with the length of its expression, or 0 if the slot is empty, the steps to
+// the target, the law and index of the first step, the target, and the symbols padded to maxLength
+class ClosureHeader {
+    public:
+        uint32_t magic;
+        uint32_t version;
+        uint32_t maxSteps;
+        uint32_t maxLength;
+        uint32_t maxVariables;
+        uint32_t recordSize;
+        uint32_t formulaCount;
+        uint32_t bucketCount;
+        uint32_t slotCount;
+};
+
+const uint32_t closureMagic = 0x42435342; // "BSCB"
+const uint32_t closureVersion = 1;
+const int closureRecordFields = 5;
+
+// Builder of the closure, by a breadth-first search from TRUE and FALSE, and of its perfect hash table
+template <class LawSet>
+class ClosureBuilder {
+    public:
+        ClosureBuilder();
+        void setMaxSteps(int steps);
+        void setMaxLength(int length);
+        void setMaxVariables(int variables);
+        size_t build();
+        void serialize(std::vector<uint8_t>& image) const;
+        bool save(const char* path) const;
+    private:
+        class ClosureEntry {
+            public:
+                uint8_t distance;
+                uint8_t law;
+                uint8_t index;
+                uint8_t target;
+        };
+        int maxSteps;
+        int maxLength;
+        int maxVariables;
+        std::unordered_map<std::string, ClosureEntry> entries;
+        StepExpander<LawSet> steps;
+};
+
+template <class LawSet>
+ClosureBuilder<LawSet>::ClosureBuilder() {
+    maxSteps = 3;
+    maxLength = 9;
+    maxVariables = 2;
+    steps.generator().allowNewVariables(true);
+}
+
+template <class LawSet>
+void ClosureBuilder<LawSet>::setMaxSteps(int stepCount) {
+    maxSteps = std::min(std::max(stepCount, 0), 254);
+}
+
+template <class LawSet>
+void ClosureBuilder<LawSet>::setMaxLength(int length) {
+    maxLength = std::min(std::max(length, 1), 255);
+}
+
+template <class LawSet>
+void ClosureBuilder<LawSet>::setMaxVariables(int variables) {
+    maxVariables = std::min(std::max(variables, 0), 255 - minVariable);
+}
+
+template <class LawSet>
+size_t ClosureBuilder<LawSet>::build() {
+    entries.clear();
+    std::vector<std::string> frontier;
+    for (int target : {FALSE, TRUE}) {
+        std::string key(1, (char) target);
+        entries[key] = ClosureEntry{0, (uint8_t) noLaw, 0, (uint8_t) target};
+        frontier.push_back(key);
+    }
+    int arrayLength = maxLength + 1;
+    std::vector<int> f(arrayLength);
+    std::vector<VariableRecord> variables;
+    std::string nextKey;
+    for (int distance = 1; distance <= maxSteps && !frontier.empty(); distance++) {
+        std::vector<std::string> nextFrontier;
+        for (const std::string& key : frontier) {
+            uint8_t target = entries[key].target;
+            std::fill(f.begin(), f.end(), STOP);
+            for (size_t i = 0; i < key.size(); i++) {
+                f[i] = (uint8_t) key[i];
+            }
+            steps.initialVariables(f.data(), variables);
+            steps.expand(f.data(), (int) key.size(), arrayLength, variables.data(), (int) variables.size(),
+                [&](int law, int index, const int g[], int gStop, const std::vector<VariableRecord>& nextVariables) {
+                    (void) nextVariables;
+                    if (LawSet::rules[law].matcher == substitutionMatcher || !closureKey(g, gStop, maxLength, maxVariables, nextKey)) {
+                        return;
+                    }
+                    if (entries.find(nextKey) == entries.end()) {
+                        // The law also takes the next expression back to this one at the same index
+                        entries[nextKey] = ClosureEntry{(uint8_t) distance, (uint8_t) law, (uint8_t) index, target};
+                        nextFrontier.push_back(nextKey);
+                    }
+                });
+        }
+        frontier.swap(nextFrontier);
+    }
+    return entries.size();
+}
+
+template <class LawSet>
+void ClosureBuilder<LawSet>::serialize(std::vector<uint8_t>& image) const {
+    // Hash and displace: the keys are split into buckets of about 4 by one hash, and from the largest bucket
+    // down, each bucket gets the first seed of a second hash that puts its keys into empty slots
+    std::vector<const std::string*> keys;
+    for (const auto& entry : entries) {
+        keys.push_back(&entry.first);
+    }
+    ClosureHeader header;
+    header.magic = closureMagic;
+    header.version = closureVersion;
+    header.maxSteps = (uint32_t) maxSteps;
+    header.maxLength = (uint32_t) maxLength;
+    header.maxVariables = (uint32_t) maxVariables;
+    header.recordSize = (uint32_t) (closureRecordFields + maxLength);
+    header.formulaCount = (uint32_t) keys.size();
+    header.bucketCount = (uint32_t) (keys.size() / 4 + 1);
+    header.slotCount = (uint32_t) (keys.size() + keys.size() / 16 + 1);
+    std::vector<std::vector<int>> buckets(header.bucketCount);
+    for (int k = 0; k < (int) keys.size(); k++) {
+        buckets[closureHash(*keys[k], 0) % header.bucketCount].push_back(k);
+    }
+    std::vector<int> order(header.bucketCount);
+    for (int b = 0; b < (int) header.bucketCount; b++) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+    std::vector<uint32_t> seeds(header.bucketCount, 0);
+    std::vector<int> slotKeys(header.slotCount, -1);
+    std::vector<uint32_t> slots;
+    for (int b : order) {
+        if (buckets[b].empty()) {
+            break;
+        }
+        for (uint32_t seed = 1; ; seed++) {
+            slots.clear();
+            bool placed = true;
+            for (int k : buckets[b]) {
+                uint32_t slot = (uint32_t) (closureHash(*keys[k], seed) % header.slotCount);
+                if (slotKeys[slot] >= 0 || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                    placed = false;
+                    break;
+                }
+                slots.push_back(slot);
+            }
+            if (placed) {
+                for (size_t k = 0; k < slots.size(); k++) {
+                    slotKeys[slots[k]] = buckets[b][k];
+                }
+                seeds[b] = seed;
+                break;
+            }
+        }
+    }
+    size_t seedsStart = sizeof(ClosureHeader);
+    size_t recordsStart = seedsStart + seeds.size() * sizeof(uint32_t);
+    image.assign(recordsStart + (size_t) header.slotCount * header.recordSize, 0);
+    std::memcpy(image.data(), &header, sizeof(ClosureHeader));
+    std::memcpy(image.data() + seedsStart, seeds.data(), seeds.size() * sizeof(uint32_t));
+    for (uint32_t slot = 0; slot < header.slotCount; slot++) {
+        if (slotKeys[slot] < 0) {
+            continue;
+        }
+        const std::string& key = *keys[slotKeys[slot]];
+        const ClosureEntry& entry = entries.find(key)->second;
+        uint8_t* record = image.data() + recordsStart + (size_t) slot * header.recordSize;
+        record[0] = (uint8_t) key.size();
+        record[1] = entry.distance;
+        record[2] = entry.law;
+        record[3] = entry.index;
+        record[4] = entry.target;
+        std::memcpy(record + closureRecordFields, key.data(), key.size());
+    }
+}
+
+template <class LawSet>
+bool ClosureBuilder<LawSet>::save(const char* path) const {
+    std::vector<uint8_t> image;
+    serialize(image);
+    std::ofstream output(path, std::ios::binary);
+    output.write((const char*) image.data(), (std::streamsize) image.size());
+    return (bool) output;
+}
+
+// Closure that is read from a file, or from an image in memory, which finds minimal proofs by lookups
+template <class LawSet>
+class ClosureDatabase {
+    public:
+        ClosureDatabase();
+        ~ClosureDatabase();
+        ClosureDatabase(const ClosureDatabase&) = delete;
+        ClosureDatabase& operator=(const ClosureDatabase&) = delete;
+        bool open(const char* path);
+        bool attach(const uint8_t* image, size_t size);
+        void close();
+        int maxSteps() const;
+        size_t size() const;
+        int distance(int f[], int fLength, int* target) const;
+        bool findProof(int formula[], int fLength, int target, SearchProof* proof);
+    private:
+        const uint8_t* data;
+        size_t dataSize;
+        void* mapping; // Memory-mapped file, or nullptr
+        std::vector<uint8_t> contents; // File that is read without memory mapping
+        ClosureHeader header;
+        const uint32_t* seeds;
+        const uint8_t* records;
+        StepExpander<LawSet> steps;
+        std::string key;
+        const uint8_t* lookup(const std::string& formulaKey) const;
+};
+
+template <class LawSet>
+ClosureDatabase<LawSet>::ClosureDatabase() {
+    data = nullptr;
+    dataSize = 0;
+    mapping = nullptr;
+    header = ClosureHeader{};
+    seeds = nullptr;
+    records = nullptr;
+    steps.generator().allowNewVariables(true);
+}
+
+template <class LawSet>
+ClosureDatabase<LawSet>::~ClosureDatabase() {
+    close();
+}
+
+template <class LawSet>
+bool ClosureDatabase<LawSet>::open(const char* path) {
+    close();
+#ifdef CLOSURE_DATABASE_MMAP
+    int descriptor = ::open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        ::close(descriptor);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    // The mapping stays valid after the file is closed
+    ::close(descriptor);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    if (!attach((const uint8_t*) mapped, (size_t) status.st_size)) {
+        munmap(mapped, (size_t) status.st_size);
+        return false;
+    }
+    mapping = mapped;
+    return true;
+#else
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    contents.swap(bytes);
+    return attach(contents.data(), contents.size());
+#endif
+}
+
+template <class LawSet>
+bool ClosureDatabase<LawSet>::attach(const uint8_t* image, size_t size) {
+    // The image must outlive the database
+    if (size < sizeof(ClosureHeader)) {
+        return false;
+    }
+    ClosureHeader stored;
+    std::memcpy(&stored, image, sizeof(ClosureHeader));
+    // The builder keeps the lengths, indices and renamed variables of expressions within one byte each
+    if (stored.magic != closureMagic || stored.version != closureVersion || stored.bucketCount == 0 || stored.slotCount == 0
+        || stored.maxLength > 255 || stored.maxVariables > 255 - minVariable || stored.recordSize != closureRecordFields + stored.maxLength
+        || size != sizeof(ClosureHeader) + (size_t) stored.bucketCount * sizeof(uint32_t) + (size_t) stored.slotCount * stored.recordSize) {
+        return false;
+    }
+    header = stored;
+    data = image;
+    dataSize = size;
+    seeds = (const uint32_t*) (image + sizeof(ClosureHeader));
+    records = image + sizeof(ClosureHeader) + (size_t) header.bucketCount * sizeof(uint32_t);
+    return true;
+}
+
+template <class LawSet>
+void ClosureDatabase<LawSet>::close() {
+#ifdef CLOSURE_DATABASE_MMAP
+    if (mapping != nullptr) {
+        munmap(mapping, dataSize);
+    }
+#endif
+    mapping = nullptr;
+    contents.clear();
+    data = nullptr;
+    dataSize = 0;
+    header = ClosureHeader{};
+    seeds = nullptr;
+    records = nullptr;
+}
+
+template <class LawSet>
+int ClosureDatabase<LawSet>::maxSteps() const {
+    return (int) header.maxSteps;
+}
+
+template <class LawSet>
+size_t ClosureDatabase<LawSet>::size() const {
+    return header.formulaCount;
+}
+
+template <class LawSet>
+const uint8_t* ClosureDatabase<LawSet>::lookup(const std::string& formulaKey) const {
+    // The record of an expression, or nullptr if the expression is not in the closure
+    if (data == nullptr) {
+        return nullptr;
+    }
+    uint32_t seed = seeds[closureHash(formulaKey, 0) % header.bucketCount];
+    const uint8_t* record = records + (size_t) (closureHash(formulaKey, seed) % header.slotCount) * header.recordSize;
+    if (record[0] != (uint8_t) formulaKey.size() || std::memcmp(record + closureRecordFields, formulaKey.data(), formulaKey.size()) != 0) {
+        return nullptr;
+    }
+    return record;
+}
+
+template <class LawSet>
+int ClosureDatabase<LawSet>::distance(int f[], int fLength, int* target) const {
+    // The fewest steps to TRUE or FALSE, which is stored into target, or -1 if the expression is not in the closure
+    int fStop = indexOfStop(f, fLength);
+    std::string formulaKey;
+    if (fStop < 1 || !closureKey(f, fStop, (int) header.maxLength, (int) header.maxVariables, formulaKey)) {
+        return -1;
+    }
+    const uint8_t* record = lookup(formulaKey);
+    if (record == nullptr) {
+        return -1;
+    }
+    if (target != nullptr) {
+        *target = record[4];
+    }
+    return record[1];
+}
+
+template <class LawSet>
+bool ClosureDatabase<LawSet>::findProof(int formula[], int fLength, int target, SearchProof* proof) {
+    int fStop = indexOfStop(formula, fLength);
+    if (fStop < 1 || !closureKey(formula, fStop, (int) header.maxLength, (int) header.maxVariables, key)) {
+        return false;
+    }
+    const uint8_t* record = lookup(key);
+    if (record == nullptr || record[4] != target || record[1] == 0) {
+        // Not in the closure, a proof of the other truth value, or already the target
+        return false;
+    }
+    int arrayLength = std::max(fLength, (int) header.maxLength + 1);
+    std::vector<int> f(arrayLength, STOP);
+    std::copy(formula, formula + fStop, f.begin());
+    std::vector<VariableRecord> variables;
+    steps.initialVariables(f.data(), variables);
+    std::vector<int> next(arrayLength);
+    int nextStop = 0;
+    std::vector<VariableRecord> nextVariables;
+    if (proof != nullptr) {
+        proof->fLength = arrayLength;
+        proof->formula = f;
+        proof->laws.clear();
+        proof->formulas.clear();
+    }
+    for (int remaining = record[1]; remaining > 0; remaining--) {
+        // The stored law and index give a few steps, and one of them leads to an expression with one step less
+        const uint8_t* nextRecord = nullptr;
+        steps.generator().focus(record[2], record[3]);
+        steps.expand(f.data(), fStop, arrayLength, variables.data(), (int) variables.size(),
+            [&](int law, int index, const int g[], int gStop, const std::vector<VariableRecord>& gVariables) {
+                (void) law;
+                (void) index;
+                if (nextRecord != nullptr || !closureKey(g, gStop, (int) header.maxLength, (int) header.maxVariables, key)) {
+                    return;
+                }
+                const uint8_t* candidate = lookup(key);
+                if (candidate != nullptr && candidate[1] == remaining - 1 && candidate[4] == target) {
+                    nextRecord = candidate;
+                    std::copy(g, g + arrayLength, next.begin());
+                    nextStop = gStop;
+                    nextVariables = gVariables;
+                }
+            });
+        steps.generator().focus(-1, -1);
+        if (nextRecord == nullptr) {
+            // The closure was built for another law set
+            return false;
+        }
+        if (proof != nullptr) {
+            proof->laws.push_back(record[2]);
+            proof->formulas.push_back(next);
+        }
+        f.swap(next);
+        fStop = nextStop;
+        variables.swap(nextVariables);
+        record = nextRecord;
+    }
+    // A corrupt record can claim that an expression other than the target is 0 steps from it
+    return fStop == 1 && f[0] == target;
+}
+
+#endif
@@ -0,0 +1,91 @@
+// CompactProofCache rewrites a proof cache with only the best proof of each expression, in a table that lookups
+// probe without reading the records that were appended since. Given a proof corpus, it first adds each proof of the
+// corpus to the cache with its verdict, creating the cache if there is none, so the proofs of one run are found by
+// the next. Processes that have the cache mapped keep reading the old file until they refresh.
+// The law set is PE21LF, or PE12L when compiled with CORPUS_PE12L.
+// Usage: CompactProofCache <cache> [<corpus> [<rules>]]
+
+#include <chrono>
+#include <iostream>
+
+#ifdef CORPUS_PE12L
+#include "PE12L.h"
+typedef PE12L CorpusLawSet;
+#else
+#include "PE21LF.h"
+typedef PE21LF CorpusLawSet;
+#endif
+#include "ProofCache.h"
+#include "ProofCorpus.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <cache> [<corpus> [<rules>]]\n";
+        return 2;
+    }
+    if (argc >= 3 && !ProofCache::create(argv[1], CorpusLawSet::lawCount)) {
+        std::cerr << "Cannot create the proof cache " << argv[1] << "\n";
+        return 2;
+    }
+    ProofCache cache;
+    if (!cache.open(argv[1])) {
+        std::cerr << "Cannot read the proof cache " << argv[1] << "\n";
+        return 2;
+    }
+    if (cache.lawCount() != CorpusLawSet::lawCount) {
+        std::cerr << "The proof cache is for a law set with " << cache.lawCount() << " laws instead of "
+            << CorpusLawSet::lawCount << "\n";
+        return 2;
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (argc >= 3) {
+        ProofCorpus corpus;
+        if (!corpus.open(argv[2])) {
+            std::cerr << "Cannot read the proof corpus " << argv[2] << "\n";
+            return 2;
+        }
+        if (corpus.lawCount() != CorpusLawSet::lawCount) {
+            std::cerr << "The proof corpus is for a law set with " << corpus.lawCount() << " laws instead of "
+                << CorpusLawSet::lawCount << "\n";
+            return 2;
+        }
+        DeltaVerifier<CorpusLawSet> verifier;
+        RuleSet rules;
+        if (argc == 4) {
+            if (!rules.load(argv[3])) {
+                if (rules.errorLine() == 0) {
+                    std::cerr << "Cannot read the rewrite rules " << argv[3] << "\n";
+                } else {
+                    std::cerr << "Cannot compile the rewrite rule on line " << rules.errorLine() << " of " << argv[3] << "\n";
+                }
+                return 2;
+            }
+            verifier.setRules(&rules);
+        }
+        CorpusProof proof;
+        DeltaProof steps;
+        for (size_t i = 0; i < corpus.size(); i++) {
+            corpus.advance(i);
+            if (!corpus.proof(i, &proof)) {
+                std::cerr << "Cannot read proof " << i << " of the proof corpus " << argv[2] << "\n";
+                return 2;
+            }
+            steps.steps.assign(proof.steps, proof.steps + proof.stepCount);
+            steps.inserted.assign(proof.inserted, proof.inserted + proof.insertedLength);
+            bool correct = verifier.isProofSequence(proof.formula, proof.fLength, steps, proof.target);
+            if (!cache.add(proof.formula, proof.fLength, steps, proof.target, correct)) {
+                std::cerr << "Cannot write the proof cache " << argv[1] << "\n";
+                return 2;
+            }
+        }
+    }
+    size_t bytes = cache.bytes();
+    if (!cache.compact()) {
+        std::cerr << "Cannot compact the proof cache " << argv[1] << "\n";
+        return 2;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << cache.size() << " expressions: " << bytes << " bytes compacted into " << cache.bytes()
+        << ", in " << seconds << " seconds\n";
+    return 0;
+}
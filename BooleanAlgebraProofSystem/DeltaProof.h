@@ -0,0 +1,233 @@
+#ifndef DELTA_PROOF_H
+#define DELTA_PROOF_H
+
+#include <algorithm>
+#include <vector>
+
+#include "ProofEngine.h"
+
+// Proofs where each step holds only the change to the previous Boolean expression: a law, the index of the change,
+// the number of removed symbols and the inserted symbols. A DeltaVerifier keeps the one expression of the proof in
+// a gap buffer and checks each step by a ProofChecker on the symbols around the change only, so a step takes time
+// in the size of the change and in the distance of the gap to the change, and no expression of the proof is copied
+
+// Step of a delta proof, whose inserted symbols are in the pool of its proof
+class DeltaStep {
+    public:
+        int law;
+        int index;
+        int removedLength;
+        int insertedStart;
+        int insertedLength;
+};
+
+class DeltaProof {
+    public:
+        std::vector<DeltaStep> steps;
+        std::vector<int> inserted; // Inserted symbols of every step
+        void clear();
+        void addStep(int law, int index, int removedLength, const int insertedSymbols[], int insertedLength);
+        bool addTransformation(int f[], int g[], int fLength, int law);
+        bool encode(int formula[], int fLength, Tuple sequence[], int sequenceLength);
+};
+
+inline void DeltaProof::clear() {
+    steps.clear();
+    inserted.clear();
+}
+
+inline void DeltaProof::addStep(int law, int index, int removedLength, const int insertedSymbols[], int insertedLength) {
+    steps.push_back(DeltaStep{law, index, removedLength, (int) inserted.size(), insertedLength});
+    inserted.insert(inserted.end(), insertedSymbols, insertedSymbols + insertedLength);
+}
+
+inline bool DeltaProof::addTransformation(int f[], int g[], int fLength, int law) {
+    // The change is what is left of both expressions without their common prefix and suffix
+    int fStop = indexOfStop(f, fLength);
+    int gStop = indexOfStop(g, fLength);
+    if (fStop < 1 || gStop < 1) {
+        return false;
+    }
+    int shortest = std::min(fStop, gStop);
+    int prefix = firstMismatch(f, g, shortest);
+    int suffix = 0;
+    while (prefix + suffix < shortest && f[fStop - 1 - suffix] == g[gStop - 1 - suffix]) {
+        suffix++;
+    }
+    addStep(law, prefix, fStop - prefix - suffix, g + prefix, gStop - prefix - suffix);
+    return true;
+}
+
+inline bool DeltaProof::encode(int formula[], int fLength, Tuple sequence[], int sequenceLength) {
+    // Converts a proof for isProofSequence, whose steps are checked when the delta proof is verified
+    clear();
+    int* previous = formula;
+    for (int i = 0; i < sequenceLength; i++) {
+        if (!addTransformation(previous, sequence[i].formula, fLength, sequence[i].law)) {
+            return false;
+        }
+        previous = sequence[i].formula;
+    }
+    return true;
+}
+
+template <class LawSet>
+class DeltaVerifier {
+    public:
+        DeltaVerifier();
+        DeltaVerifier(const DeltaVerifier&) = delete;
+        DeltaVerifier& operator=(const DeltaVerifier&) = delete;
+        void setRules(const RuleSet* ruleSet);
+        bool isProofSequence(const int formula[], int fLength, const DeltaProof& proof, int target);
+        bool isProofSequence(const int formula[], int fLength, const DeltaStep steps[], int stepCount,
+            const int inserted[], int insertedLength, int target);
+        int length() const;
+        void formula(std::vector<int>& f) const;
+        VariableTable& variables();
+    private:
+        ProofChecker<LawSet> checker;
+        const RuleSet* rules;
+        std::vector<int> text; // Symbols before the gap, the gap, and symbols after the gap
+        int gapStart;
+        int gapEnd;
+        std::vector<int> previousWindow;
+        std::vector<int> nextWindow;
+        int symbolAt(int i) const;
+        void moveGap(int position);
+        void reserveGap(int gapLength);
+        bool applyStep(const DeltaStep& step, const int inserted[], int insertedLength);
+};
+
+template <class LawSet>
+DeltaVerifier<LawSet>::DeltaVerifier() {
+    rules = nullptr;
+    gapStart = 0;
+    gapEnd = 0;
+}
+
+template <class LawSet>
+void DeltaVerifier<LawSet>::setRules(const RuleSet* ruleSet) {
+    rules = ruleSet;
+    checker.setRules(ruleSet);
+}
+
+template <class LawSet>
+int DeltaVerifier<LawSet>::length() const {
+    return (int) text.size() - (gapEnd - gapStart);
+}
+
+template <class LawSet>
+void DeltaVerifier<LawSet>::formula(std::vector<int>& f) const {
+    f.assign(text.begin(), text.begin() + gapStart);
+    f.insert(f.end(), text.begin() + gapEnd, text.end());
+    f.push_back(STOP);
+}
+
+template <class LawSet>
+VariableTable& DeltaVerifier<LawSet>::variables() {
+    return checker.variables();
+}
+
+template <class LawSet>
+int DeltaVerifier<LawSet>::symbolAt(int i) const {
+    return i < gapStart ? text[i] : text[i + gapEnd - gapStart];
+}
+
+template <class LawSet>
+void DeltaVerifier<LawSet>::moveGap(int position) {
+    if (position < gapStart) {
+        std::copy_backward(text.begin() + position, text.begin() + gapStart, text.begin() + gapEnd);
+        gapEnd -= gapStart - position;
+        gapStart = position;
+    } else if (position > gapStart) {
+        std::copy(text.begin() + gapEnd, text.begin() + gapEnd + position - gapStart, text.begin() + gapStart);
+        gapEnd += position - gapStart;
+        gapStart = position;
+    }
+}
+
+template <class LawSet>
+void DeltaVerifier<LawSet>::reserveGap(int gapLength) {
+    if (gapEnd - gapStart >= gapLength) {
+        return;
+    }
+    // The gap grows with the expression, so that growing is amortized over the steps
+    int added = std::max(gapLength, length() / 4 + 16);
+    text.insert(text.begin() + gapEnd, added, STOP);
+    gapEnd += added;
+}
+
+template <class LawSet>
+bool DeltaVerifier<LawSet>::applyStep(const DeltaStep& step, const int inserted[], int insertedLength) {
+    int fStop = length();
+    if (step.index < 0 || step.removedLength < 0 || step.insertedLength < 0 || step.insertedStart < 0
+        || step.index > fStop || step.removedLength > fStop - step.index
+        || step.insertedStart > insertedLength || step.insertedLength > insertedLength - step.insertedStart)
+    {
+        // Differences are compared instead of sums, which a step read from a file could overflow
+        return false;
+    }
+    // Like loadWindows, the windows start 1 symbol before the change for matchers that step back,
+    // and have the 8 symbols after it that the laws may look at, or more for rewrite rules
+    int longestSide = rules == nullptr ? 0 : rules->longestSideLength();
+    int lookBehind = std::min(step.index, std::max(1, longestSide));
+    int lookAhead = std::min(std::max(8, longestSide), fStop - step.index - step.removedLength);
+    int start = step.index - lookBehind;
+    int windowLength = lookBehind + std::max(step.removedLength, step.insertedLength) + lookAhead + 1;
+    previousWindow.assign(windowLength, STOP);
+    nextWindow.assign(windowLength, STOP);
+    int afterRemoved = step.index + step.removedLength;
+    for (int i = start; i < afterRemoved + lookAhead; i++) {
+        previousWindow[i - start] = symbolAt(i);
+    }
+    for (int i = start; i < step.index; i++) {
+        nextWindow[i - start] = symbolAt(i);
+    }
+    const int* insertedSymbols = inserted + step.insertedStart;
+    std::copy(insertedSymbols, insertedSymbols + step.insertedLength, nextWindow.begin() + lookBehind);
+    for (int i = 0; i < lookAhead; i++) {
+        nextWindow[lookBehind + step.insertedLength + i] = symbolAt(afterRemoved + i);
+    }
+    if (!checker.isTransformationByLaw(previousWindow.data(), nextWindow.data(), windowLength, step.law)) {
+        return false;
+    }
+    // The removed symbols are just before the gap, which then takes them and the inserted symbols take its start
+    moveGap(afterRemoved);
+    gapStart -= step.removedLength;
+    reserveGap(step.insertedLength);
+    std::copy(insertedSymbols, insertedSymbols + step.insertedLength, text.begin() + gapStart);
+    gapStart += step.insertedLength;
+    return true;
+}
+
+template <class LawSet>
+bool DeltaVerifier<LawSet>::isProofSequence(const int formula[], int fLength, const DeltaProof& proof, int target) {
+    return isProofSequence(formula, fLength, proof.steps.data(), (int) proof.steps.size(),
+        proof.inserted.data(), (int) proof.inserted.size(), target);
+}
+
+template <class LawSet>
+bool DeltaVerifier<LawSet>::isProofSequence(const int formula[], int fLength, const DeltaStep steps[], int stepCount,
+    const int inserted[], int insertedLength, int target)
+{
+    // The steps and inserted symbols are only read, so they may be in a mapped file
+    int fStop = findStop(formula, fLength);
+    if (fStop < 1 || fStop == fLength || stepCount < 1 || (target != TRUE && target != FALSE)) {
+        // The Boolean expression or sequence length must be at least 1, and the target must be a truth value
+        return false;
+    }
+    checker.storeInitialVariables(formula);
+    text.assign(formula, formula + fStop);
+    gapStart = fStop;
+    gapEnd = fStop;
+    for (int i = 0; i < stepCount; i++) {
+        if (!applyStep(steps[i], inserted, insertedLength)) {
+            return false;
+        } else if (length() == 1 && symbolAt(0) == target) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,545 @@
+#ifndef EQUALITY_SATURATION_H
+#define EQUALITY_SATURATION_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "ProofEngine.h"
+#include "ProofSearch.h"
+
+// Equality saturation of a Boolean expression under the laws of a law set, with an e-graph whose classes are
+// sets of equal sub-expressions. Every rewrite applies to every class at once, so commutative and associative
+// variants share their classes instead of multiplying the states of a search. Like the laws of the checker, a
+// rewrite binds its operands a, b and c to classes that hold a variable, TRUE or FALSE, and substitution is
+// left to the proof searches.
+// Each node of the e-graph stands for one expression, built from the nodes of its operands, and each union
+// is recorded in a proof forest with its law, or as a congruence of nodes whose operands are equal. The proof
+// that the expression equals TRUE or FALSE is the path between both nodes in the forest, where every law
+// replaces one expression by another at one index and every congruence is the proofs of its operands
+
+// Node of an e-graph, whose operands a and b are nodes, or -1 for no operand
+class EGraphNode {
+    public:
+        int op;
+        int a;
+        int b;
+        bool operator==(const EGraphNode& other) const {
+            return op == other.op && a == other.a && b == other.b;
+        }
+};
+
+class EGraphNodeHash {
+    public:
+        size_t operator()(const EGraphNode& node) const {
+            uint64_t hash = ((uint64_t) (uint32_t) node.op << 32) ^ (uint32_t) node.a;
+            hash = (hash ^ ((uint64_t) (uint32_t) node.b << 17)) * 0xBF58476D1CE4E5B9ULL;
+            return (size_t) (hash ^ (hash >> 31));
+        }
+};
+
+template <class LawSet>
+class EqualitySaturation {
+    public:
+        EqualitySaturation();
+        void setMaxIterations(int iterations);
+        void setNodeLimit(size_t limit);
+        bool findProof(int formula[], int fLength, int target, SearchProof* proof);
+        size_t nodeCount() const;
+        size_t classCount() const;
+        int iterations() const;
+    private:
+        // One direction of a law, where -1, -2 and -3 are the operands a, b and c
+        class LawSide {
+            public:
+                int law;
+                std::vector<int> from;
+                std::vector<int> to;
+        };
+        class RewriteMatch {
+            public:
+                int side;
+                int operands[3]; // Leaf node bound to a, b and c
+        };
+        static constexpr int congruence = -1;
+        std::vector<LawSide> sides;
+        int maxIterations;
+        size_t nodeLimit;
+        int iterationCount;
+        std::vector<EGraphNode> nodes;
+        std::vector<int> lengths; // Symbols in the expression of each node
+        std::vector<int> classParents; // Union-find of the classes
+        std::vector<int> classSizes;
+        std::vector<int> proofParents; // Proof forest, with the law or congruence of the edge to the parent
+        std::vector<int> proofReasons;
+        std::unordered_map<EGraphNode, int, EGraphNodeHash> nodeOf; // Node of each expression
+        std::unordered_map<EGraphNode, int, EGraphNodeHash> classNodes; // A node of each node with canonical operands
+        std::vector<int> leaves; // Nodes of variables, TRUE and FALSE
+        std::vector<std::vector<int>> members; // Nodes of each class, after rebuilding
+        std::vector<int> leafOf; // Leaf node of each class, or -1
+        std::vector<RewriteMatch> matches;
+        std::vector<int> marks;
+        int markStamp;
+        // Proof being written, as the whole expression after each step
+        std::vector<int> current;
+        std::vector<int> proofLaws;
+        std::vector<std::vector<int>> proofFormulas;
+        void addSides(int law, const std::vector<int>& left, const std::vector<int>& right);
+        void addLaw(int law, int matcher, int op);
+        int find(int node);
+        EGraphNode canonicalOf(const EGraphNode& node);
+        int add(int op, int a, int b);
+        bool merge(int x, int y, int reason);
+        void reroot(int node);
+        bool rebuild();
+        void matchClass(const std::vector<int>& pattern, int position, int cls, int operands[3], const std::function<void(int)>& found);
+        void collectMatches(int side);
+        int instantiate(const std::vector<int>& pattern, int& position, const int operands[3]);
+        void appendExpression(int node, std::vector<int>& symbols) const;
+        void explain(int from, int to, int index);
+};
+
+template <class LawSet>
+EqualitySaturation<LawSet>::EqualitySaturation() {
+    maxIterations = 16;
+    nodeLimit = 1 << 18;
+    iterationCount = 0;
+    markStamp = 0;
+    for (int law = 0; law < LawSet::lawCount; law++) {
+        int matcher = LawSet::rules[law].matcher;
+        int form = LawSet::rules[law].form;
+        if (matcher == substitutionMatcher) {
+            continue;
+        }
+        if (form != AND) {
+            addLaw(law, matcher, OR);
+        }
+        if (form != OR && matcher != doubleNegationMatcher && matcher != negationMatcher) {
+            addLaw(law, matcher, AND);
+        }
+    }
+}
+
+template <class LawSet>
+void EqualitySaturation<LawSet>::addSides(int law, const std::vector<int>& left, const std::vector<int>& right) {
+    // Both directions, since every law is two-way
+    sides.push_back(LawSide{law, left, right});
+    sides.push_back(LawSide{law, right, left});
+}
+
+template <class LawSet>
+void EqualitySaturation<LawSet>::addLaw(int law, int matcher, int op) {
+    const int a = -1;
+    const int b = -2;
+    const int c = -3;
+    int other = otherOperator(op);
+    int identity = identityElement(op);
+    int dominating = dominatingElement(op);
+    if (matcher == identityMatcher) {
+        addSides(law, {op, a, identity}, {a});
+    } else if (matcher == idempotentMatcher) {
+        addSides(law, {op, a, a}, {a});
+    } else if (matcher == commutativeMatcher) {
+        sides.push_back(LawSide{law, {op, a, b}, {op, b, a}});
+    } else if (matcher == associativeMatcher) {
+        addSides(law, {op, a, op, b, c}, {op, op, a, b, c});
+    } else if (matcher == distributiveMatcher) {
+        addSides(law, {op, a, other, b, c}, {other, op, a, b, op, a, c});
+    } else if (matcher == deMorganMatcher) {
+        addSides(law, {NOT, op, a, b}, {other, NOT, a, NOT, b});
+    } else if (matcher == complementMatcher) {
+        addSides(law, {op, a, NOT, a}, {dominating});
+    } else if (matcher == dominationMatcher) {
+        addSides(law, {op, a, dominating}, {dominating});
+    } else if (matcher == absorptionMatcher) {
+        addSides(law, {op, a, other, a, b}, {a});
+    } else if (matcher == doubleNegationMatcher) {
+        addSides(law, {NOT, NOT, a}, {a});
+    } else if (matcher == negationMatcher) {
+        addSides(law, {NOT, TRUE}, {FALSE});
+        addSides(law, {NOT, FALSE}, {TRUE});
+    }
+}
+
+template <class LawSet>
+void EqualitySaturation<LawSet>::setMaxIterations(int iterations) {
+    maxIterations = iterations;
+}
+
+template <class LawSet>
+void EqualitySaturation<LawSet>::setNodeLimit(size_t limit) {
+    nodeLimit = limit;
+}
+
+template <class LawSet>
+size_t EqualitySaturation<LawSet>::nodeCount() const {
+    return nodes.size();
+}
+
+template <class LawSet>
+size_t EqualitySaturation<LawSet>::classCount() const {
+    size_t count = 0;
+    for (int node = 0; node < (int) classParents.size(); node++) {
+        count += classParents[node] == node;
+    }
+    return count;
+}
+
+template <class LawSet>
+int EqualitySaturation<LawSet>::iterations() const {
+    return iterationCount;
+}
+
+template <class LawSet>
+int EqualitySaturation<LawSet>::find(int node) {
+    while (classParents[node] != node) {
+        // Path halving
+        classParents[node] = classParents[classParents[node]];
+        node = classParents[node];
+    }
+    return node;
+}
+
+template <class LawSet>
+EGraphNode EqualitySaturation<LawSet>::canonicalOf(const EGraphNode& node) {
+    return EGraphNode{node.op, node.a >= 0 ? find(node.a) : -1, node.b >= 0 ? find(node.b) : -1};
+}
+
+template <class LawSet>
+int EqualitySaturation<LawSet>::add(int op, int a, int b) {
+    // The node of an expression, which is added to the class of a node with equal operands if there is one
+    EGraphNode node{op, a, b};
+    typename std::unordered_map<EGraphNode, int, EGraphNodeHash>::iterator existing = nodeOf.find(node);
+    if (existing != nodeOf.end()) {
+        return existing->second;
+    }
+    int id = (int) nodes.size();
+    nodes.push_back(node);
+    lengths.push_back(1 + (a >= 0 ? lengths[a] : 0) + (b >= 0 ? lengths[b] : 0));
+    classParents.push_back(id);
+    classSizes.push_back(1);
+    proofParents.push_back(-1);
+    proofReasons.push_back(congruence);
+    nodeOf[node] = id;
+    if (isBoolean(op)) {
+        leaves.push_back(id);
+    }
+    EGraphNode key = canonicalOf(node);
+    typename std::unordered_map<EGraphNode, int, EGraphNodeHash>::iterator equal = classNodes.find(key);
+    if (equal == classNodes.end()) {
+        classNodes[key] = id;
+    } else {
+        merge(id, equal->second, congruence);
+    }
+    return id;
+}
+
+template <class LawSet>
+void EqualitySaturation<LawSet>::reroot(int node) {
+    // Reverses the edges from the node to the root of its proof tree, so that the node becomes the root
+    int child = node;
+    int parent = proofParents[node];
+    int reason = proofReasons[node];
+    proofParents[node] = -1;
+    while (parent >= 0) {
+        int nextParent = proofParents[parent];
+        int nextReason = proofReasons[parent];
+        proofParents[parent] = child;
+        proofReasons[parent] = reason;
+        child = parent;
+        parent = nextParent;
+        reason = nextReason;
+    }
+}
+
+template <class LawSet>
+bool EqualitySaturation<LawSet>::merge(int x, int y, int reason) {
+    int xClass = find(x);
+    int yClass = find(y);
+    if (xClass == yClass) {
+        return false;
+    }
+    reroot(x);
+    proofParents[x] = y;
+    proofReasons[x] = reason;
+    if (classSizes[xClass] < classSizes[yClass]) {
+        std::swap(xClass, yClass);
+    }
+    classParents[yClass] = xClass;
+    classSizes[xClass] += classSizes[yClass];
+    return true;
+}
+
+template <class LawSet>
+bool EqualitySaturation<LawSet>::rebuild() {
+    // Merges the classes of nodes whose operands became equal, until no more do, and returns whether any did
+    bool mergedAny = false;
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        classNodes.clear();
+        for (int node = 0; node < (int) nodes.size(); node++) {
+            EGraphNode key = canonicalOf(nodes[node]);
+            typename std::unordered_map<EGraphNode, int, EGraphNodeHash>::iterator equal = classNodes.find(key);
+            if (equal == classNodes.end()) {
+                classNodes[key] = node;
+            } else if (merge(node, equal->second, congruence)) {
+                merged = true;
+            }
+        }
+        mergedAny = mergedAny || merged;
+    }
+    members.assign(nodes.size(), std::vector<int>());
+    leafOf.assign(nodes.size(), -1);
+    for (int node = 0; node < (int) nodes.size(); node++) {
+        int cls = find(node);
+        members[cls].push_back(node);
+        if (isBoolean(nodes[node].op)) {
+            leafOf[cls] = node;
+        }
+    }
+    return mergedAny;
+}
+
+template <class LawSet>
+void EqualitySaturation<LawSet>::matchClass(const std::vector<int>& pattern, int position, int cls, int operands[3], const std::function<void(int)>& found) {
+    // Calls found with the end of the sub-pattern at the position for each way that it matches the class
+    int symbol = pattern[position];
+    if (symbol < 0) {
+        int& operand = operands[-symbol - 1];
+        int leaf = leafOf[cls];
+        if (leaf < 0) {
+            // The operands of a law are single Booleans
+            return;
+        }
+        if (operand >= 0) {
+            if (operand == leaf) {
+                found(position + 1);
+            }
+            return;
+        }
+        operand = leaf;
+        found(position + 1);
+        operand = -1;
+        return;
+    }
+    if (isBoolean(symbol)) {
+        if (leafOf[cls] >= 0 && nodes[leafOf[cls]].op == symbol) {
+            found(position + 1);
+        }
+        return;
+    }
+    for (int node : members[cls]) {
+        const EGraphNode& candidate = nodes[node];
+        if (candidate.op != symbol) {
+            continue;
+        }
+        if (symbol == NOT) {
+            matchClass(pattern, position + 1, find(candidate.a), operands, found);
+        } else {
+            int second = find(candidate.b);
+            matchClass(pattern, position + 1, find(candidate.a), operands, [&](int middle) {
+                matchClass(pattern, middle, second, operands, found);
+            });
+        }
+    }
+}
+
+template <class LawSet>
+void EqualitySaturation<LawSet>::collectMatches(int side) {
+    const LawSide& law = sides[side];
+    // Operands that only the replacing side has, such as b in a = a + (a * b), can be any leaf
+    int freeOperand = 0;
+    for (int symbol : law.to) {
+        if (symbol < 0 && std::find(law.from.begin(), law.from.end(), symbol) == law.from.end()) {
+            freeOperand = symbol;
+        }
+    }
+    int operands[3] = {-1, -1, -1};
+    for (int cls = 0; cls < (int) nodes.size(); cls++) {
+        if (find(cls) != cls) {
+            continue;
+        }
+        matchClass(law.from, 0, cls, operands, [&](int end) {
+            (void) end;
+            RewriteMatch match{side, {operands[0], operands[1], operands[2]}};
+            if (freeOperand == 0) {
+                matches.push_back(match);
+                return;
+            }
+            for (int leaf : leaves) {
+                match.operands[-freeOperand - 1] = leaf;
+                matches.push_back(match);
+            }
+        });
+    }
+}
+
+template <class LawSet>
+int EqualitySaturation<LawSet>::instantiate(const std::vector<int>& pattern, int& position, const int operands[3]) {
+    int symbol = pattern[position++];
+    if (symbol < 0) {
+        return operands[-symbol - 1];
+    }
+    if (isBoolean(symbol)) {
+        return add(symbol, -1, -1);
+    }
+    int a = instantiate(pattern, position, operands);
+    if (symbol == NOT) {
+        return add(NOT, a, -1);
+    }
+    int b = instantiate(pattern, position, operands);
+    return add(symbol, a, b);
+}
+
+template <class LawSet>
+void EqualitySaturation<LawSet>::appendExpression(int node, std::vector<int>& symbols) const {
+    symbols.push_back(nodes[node].op);
+    if (nodes[node].a >= 0) {
+        appendExpression(nodes[node].a, symbols);
+    }
+    if (nodes[node].b >= 0) {
+        appendExpression(nodes[node].b, symbols);
+    }
+}
+
+template <class LawSet>
+void EqualitySaturation<LawSet>::explain(int from, int to, int index) {
+    // Steps that turn the expression of one node at the index of the current expression into that of the other
+    if (from == to) {
+        return;
+    }
+    markStamp++;
+    for (int node = from; node >= 0; node = proofParents[node]) {
+        marks[node] = markStamp;
+    }
+    int ancestor = to;
+    while (marks[ancestor] != markStamp) {
+        ancestor = proofParents[ancestor];
+    }
+    // Edges of the path from the first node up to the common ancestor and down to the other node
+    std::vector<int> path;
+    for (int node = from; node != ancestor; node = proofParents[node]) {
+        path.push_back(node);
+    }
+    path.push_back(ancestor);
+    size_t upward = path.size();
+    for (int node = to; node != ancestor; node = proofParents[node]) {
+        path.push_back(node);
+    }
+    std::reverse(path.begin() + upward, path.end());
+    for (size_t k = 0; k + 1 < path.size(); k++) {
+        int x = path[k];
+        int y = path[k + 1];
+        int reason = k + 1 < upward ? proofReasons[x] : proofReasons[y];
+        if (reason == congruence) {
+            explain(nodes[x].a, nodes[y].a, index + 1);
+            if (nodes[x].b >= 0) {
+                explain(nodes[x].b, nodes[y].b, index + 1 + lengths[nodes[y].a]);
+            }
+            continue;
+        }
+        std::vector<int> replacement;
+        appendExpression(y, replacement);
+        current.erase(current.begin() + index, current.begin() + index + lengths[x]);
+        current.insert(current.begin() + index, replacement.begin(), replacement.end());
+        proofLaws.push_back(reason);
+        proofFormulas.push_back(current);
+    }
+}
+
+template <class LawSet>
+bool EqualitySaturation<LawSet>::findProof(int formula[], int fLength, int target, SearchProof* proof) {
+    int fStop = indexOfStop(formula, fLength);
+    if (fStop < 1 || (target != TRUE && target != FALSE)) {
+        // The Boolean expression must not be empty, and the target must be a truth value
+        return false;
+    }
+    std::vector<int> symbols(formula, formula + fStop);
+    if (!isPolishExpression(symbols)) {
+        return false;
+    }
+    nodes.clear();
+    lengths.clear();
+    classParents.clear();
+    classSizes.clear();
+    proofParents.clear();
+    proofReasons.clear();
+    nodeOf.clear();
+    classNodes.clear();
+    leaves.clear();
+    iterationCount = 0;
+    // The operand stack is only needed once, while adding the expression from right to left
+    std::vector<int> operands;
+    for (int i = fStop - 1; i >= 0; i--) {
+        if (symbols[i] == NOT) {
+            operands.back() = add(NOT, operands.back(), -1);
+        } else if (symbols[i] == OR || symbols[i] == AND) {
+            int a = operands.back();
+            operands.pop_back();
+            operands.back() = add(symbols[i], a, operands.back());
+        } else {
+            operands.push_back(add(symbols[i], -1, -1));
+        }
+    }
+    int root = operands.back();
+    add(FALSE, -1, -1);
+    add(TRUE, -1, -1);
+    int goal = add(target, -1, -1);
+    rebuild();
+    while (find(root) != find(goal) && iterationCount < maxIterations && nodes.size() < nodeLimit) {
+        iterationCount++;
+        matches.clear();
+        for (int side = 0; side < (int) sides.size(); side++) {
+            collectMatches(side);
+        }
+        size_t nodesBefore = nodes.size();
+        bool merged = false;
+        for (const RewriteMatch& match : matches) {
+            const LawSide& law = sides[match.side];
+            int position = 0;
+            int replaced = instantiate(law.from, position, match.operands);
+            position = 0;
+            int replacement = instantiate(law.to, position, match.operands);
+            merged = merge(replaced, replacement, law.law) || merged;
+            if (nodes.size() >= nodeLimit) {
+                break;
+            }
+        }
+        merged = rebuild() || merged;
+        if (!merged && nodes.size() == nodesBefore) {
+            // Saturated, so no law can show anything more
+            break;
+        }
+    }
+    if (find(root) != find(goal)) {
+        return false;
+    }
+    marks.assign(nodes.size(), 0);
+    markStamp = 0;
+    current = symbols;
+    proofLaws.clear();
+    proofFormulas.clear();
+    explain(root, goal, 0);
+    if (proof != nullptr) {
+        // Every expression is padded with STOP to the length of the longest one
+        int arrayLength = fStop + 1;
+        for (const std::vector<int>& step : proofFormulas) {
+            arrayLength = std::max(arrayLength, (int) step.size() + 1);
+        }
+        proof->fLength = arrayLength;
+        proof->formula.assign(arrayLength, STOP);
+        std::copy(symbols.begin(), symbols.end(), proof->formula.begin());
+        proof->laws = proofLaws;
+        proof->formulas.clear();
+        for (const std::vector<int>& step : proofFormulas) {
+            proof->formulas.push_back(std::vector<int>(arrayLength, STOP));
+            std::copy(step.begin(), step.end(), proof->formulas.back().begin());
+        }
+    }
+    return true;
+}
+
+#endif
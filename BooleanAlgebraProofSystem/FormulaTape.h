@@ -0,0 +1,263 @@
+#ifndef FORMULA_TAPE_H
+#define FORMULA_TAPE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ProofEngine.h"
+
+// Compiler from a Boolean expression in Polish notation to a straight-line tape of register instructions,
+// which is evaluated repeatedly without parsing or an operand stack. Registers 0 to variableCount() - 1 hold the
+// variables, and instruction i writes register variableCount() + i from lower registers. While compiling,
+// constants are folded, double negations are dropped, a + a, a * a, a + -a and a * -a are simplified, and
+// common subexpressions share one register
+
+// Output of a tape whose expression folds to a constant
+const int tapeFalse = -1;
+const int tapeTrue = -2;
+
+// Assignments of one evaluation, as 1, 4 or 8 words of 64 bits
+template <int words>
+class AssignmentBlock {
+    public:
+        uint64_t bits[words];
+};
+
+// Instruction that computes (left & right) | ((left | right) & orMask), inverted by invertMask,
+// which covers NOT, OR and AND without branches
+class TapeInstruction {
+    public:
+        int left;
+        int right;
+        uint64_t orMask;
+        uint64_t invertMask;
+};
+
+class FormulaTape {
+    public:
+        FormulaTape();
+        bool compile(int f[], int fLength);
+        int variableCount() const;
+        const std::vector<int>& variables() const;
+        int registerCount() const;
+        int output() const;
+        const std::vector<TapeInstruction>& instructions() const;
+        template <int words> void run(AssignmentBlock<words>* registers) const;
+        template <int words> AssignmentBlock<words> result(const AssignmentBlock<words>* registers) const;
+        bool evaluate(const std::vector<char>& assignment) const;
+    private:
+        std::vector<int> variableNames; // Symbol of each variable register, in increasing order
+        std::vector<TapeInstruction> tape;
+        int outputRegister;
+        // While compiling: the symbol and operands of each instruction, and the instruction of each operation
+        std::vector<int> operation;
+        std::unordered_map<uint64_t, int> instructionOf;
+        int makeNot(int a);
+        int makeBinary(int symbol, int a, int b);
+        int makeInstruction(int symbol, int a, int b);
+        int negationOf(int a) const;
+        void removeDeadInstructions();
+};
+
+inline FormulaTape::FormulaTape() {
+    outputRegister = tapeFalse;
+}
+
+inline int FormulaTape::negationOf(int a) const {
+    // The operand of a register that holds a NOT instruction, or -1
+    if (a < variableCount() || operation[a - variableCount()] != NOT) {
+        return -1;
+    }
+    return tape[a - variableCount()].left;
+}
+
+inline int FormulaTape::makeInstruction(int symbol, int a, int b) {
+    if ((symbol == OR || symbol == AND) && a > b) {
+        // OR and AND are commutative, so both orders share one instruction
+        std::swap(a, b);
+    }
+    uint64_t key = ((uint64_t) symbol << 62) | ((uint64_t) (uint32_t) a << 31) | (uint64_t) (uint32_t) b;
+    std::unordered_map<uint64_t, int>::iterator existing = instructionOf.find(key);
+    if (existing != instructionOf.end()) {
+        // Common subexpression
+        return existing->second;
+    }
+    int destination = variableCount() + (int) tape.size();
+    tape.push_back(TapeInstruction{a, b, symbol == OR ? ~0ULL : 0, symbol == NOT ? ~0ULL : 0});
+    operation.push_back(symbol);
+    instructionOf[key] = destination;
+    return destination;
+}
+
+inline int FormulaTape::makeNot(int a) {
+    if (a == tapeFalse || a == tapeTrue) {
+        // -0 = 1, -1 = 0
+        return a == tapeFalse ? tapeTrue : tapeFalse;
+    }
+    int negated = negationOf(a);
+    if (negated >= 0) {
+        // -(-a) = a
+        return negated;
+    }
+    return makeInstruction(NOT, a, a);
+}
+
+inline int FormulaTape::makeBinary(int symbol, int a, int b) {
+    int identity = symbol == OR ? tapeFalse : tapeTrue;
+    int dominating = symbol == OR ? tapeTrue : tapeFalse;
+    if (a == dominating || b == dominating) {
+        // a + 1 = 1, a * 0 = 0
+        return dominating;
+    }
+    if (a == identity || a == b) {
+        // 0 + b = b, 1 * b = b, b + b = b, b * b = b
+        return b;
+    }
+    if (b == identity) {
+        return a;
+    }
+    if (negationOf(a) == b || negationOf(b) == a) {
+        // a + -a = 1, a * -a = 0
+        return dominating;
+    }
+    return makeInstruction(symbol, a, b);
+}
+
+inline bool FormulaTape::compile(int f[], int fLength) {
+    int fStop = indexOfStop(f, fLength);
+    if (fStop < 1) {
+        return false;
+    }
+    std::vector<int> symbols(f, f + fStop);
+    if (!isPolishExpression(symbols)) {
+        // The expression must be a single Polish expression
+        return false;
+    }
+    variableNames.clear();
+    for (int symbol : symbols) {
+        if (isVariable(symbol)) {
+            variableNames.push_back(symbol);
+        }
+    }
+    std::sort(variableNames.begin(), variableNames.end());
+    variableNames.erase(std::unique(variableNames.begin(), variableNames.end()), variableNames.end());
+    tape.clear();
+    operation.clear();
+    instructionOf.clear();
+    // The operand stack is only needed once, while compiling from right to left
+    std::vector<int> operands;
+    for (int i = fStop - 1; i >= 0; i--) {
+        int symbol = symbols[i];
+        if (symbol == NOT) {
+            operands.back() = makeNot(operands.back());
+        } else if (symbol == OR || symbol == AND) {
+            int a = operands.back();
+            operands.pop_back();
+            operands.back() = makeBinary(symbol, a, operands.back());
+        } else if (symbol == TRUE || symbol == FALSE) {
+            operands.push_back(symbol == TRUE ? tapeTrue : tapeFalse);
+        } else {
+            operands.push_back((int) (std::lower_bound(variableNames.begin(), variableNames.end(), symbol) - variableNames.begin()));
+        }
+    }
+    outputRegister = operands.back();
+    removeDeadInstructions();
+    instructionOf.clear();
+    return true;
+}
+
+inline void FormulaTape::removeDeadInstructions() {
+    // Folding can leave instructions that the output does not use, such as the operand of a * 0
+    int variableTotal = variableCount();
+    std::vector<char> live(variableTotal + tape.size(), false);
+    if (outputRegister >= 0) {
+        live[outputRegister] = true;
+    }
+    for (int i = (int) tape.size() - 1; i >= 0; i--) {
+        if (live[variableTotal + i]) {
+            live[tape[i].left] = true;
+            live[tape[i].right] = true;
+        }
+    }
+    std::vector<int> renamed(variableTotal + tape.size());
+    for (int v = 0; v < variableTotal; v++) {
+        renamed[v] = v;
+    }
+    int kept = 0;
+    for (int i = 0; i < (int) tape.size(); i++) {
+        if (live[variableTotal + i]) {
+            TapeInstruction instruction = tape[i];
+            instruction.left = renamed[instruction.left];
+            instruction.right = renamed[instruction.right];
+            renamed[variableTotal + i] = variableTotal + kept;
+            operation[kept] = operation[i];
+            tape[kept] = instruction;
+            kept++;
+        }
+    }
+    tape.resize(kept);
+    operation.resize(kept);
+    if (outputRegister >= 0) {
+        outputRegister = renamed[outputRegister];
+    }
+}
+
+inline int FormulaTape::variableCount() const {
+    return (int) variableNames.size();
+}
+
+inline const std::vector<int>& FormulaTape::variables() const {
+    return variableNames;
+}
+
+inline int FormulaTape::registerCount() const {
+    return variableCount() + (int) tape.size();
+}
+
+inline int FormulaTape::output() const {
+    return outputRegister;
+}
+
+inline const std::vector<TapeInstruction>& FormulaTape::instructions() const {
+    return tape;
+}
+
+template <int words>
+__attribute__((always_inline)) inline void FormulaTape::run(AssignmentBlock<words>* registers) const {
+    // The variable registers must be set, and every instruction register is written in order
+    AssignmentBlock<words>* destination = registers + variableCount();
+    for (const TapeInstruction& instruction : tape) {
+        const AssignmentBlock<words>& left = registers[instruction.left];
+        const AssignmentBlock<words>& right = registers[instruction.right];
+        for (int w = 0; w < words; w++) {
+            destination->bits[w] = ((left.bits[w] & right.bits[w]) | ((left.bits[w] | right.bits[w]) & instruction.orMask)) ^ instruction.invertMask;
+        }
+        destination++;
+    }
+}
+
+template <int words>
+inline AssignmentBlock<words> FormulaTape::result(const AssignmentBlock<words>* registers) const {
+    if (outputRegister >= 0) {
+        return registers[outputRegister];
+    }
+    AssignmentBlock<words> constant;
+    for (int w = 0; w < words; w++) {
+        constant.bits[w] = outputRegister == tapeTrue ? ~0ULL : 0;
+    }
+    return constant;
+}
+
+inline bool FormulaTape::evaluate(const std::vector<char>& assignment) const {
+    // A single assignment, with the value of each variable register
+    std::vector<AssignmentBlock<1>> registers(registerCount());
+    for (int v = 0; v < variableCount(); v++) {
+        registers[v].bits[0] = assignment[v] ? ~0ULL : 0;
+    }
+    run<1>(registers.data());
+    return result<1>(registers.data()).bits[0] & 1;
+}
+
+#endif
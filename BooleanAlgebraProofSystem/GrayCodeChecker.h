@@ -0,0 +1,395 @@
+#ifndef GRAY_CODE_CHECKER_H
+#define GRAY_CODE_CHECKER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TruthTable.h"
+
+// Multithreaded tautology checker that walks the assignments in Gray-code order, so that consecutive
+// assignments differ in one variable and only the operators above the occurrences of that variable are
+// recomputed, skipping those whose operands did not change. Each node of the expression holds a block of 64,
+// 256 or 512 assignments like a TruthTable, where the first variables are fixed bit patterns. The other variables
+// are split into chunk variables, which are fixed for a chunk of the assignments that a thread claims, and
+// Gray-code variables, which a thread walks within its chunk. Every thread stops as soon as any thread finds an
+// assignment with the wanted value
+
+// Gray-code variables that can be walked in one chunk, on top of the bit-pattern variables and the chunk variables
+const int maxGrayCodeVariables = 63;
+
+// Class of an expression whose search was cancelled before it covered every assignment, next to the classes of TruthTable
+const int cancelledSearch = 4;
+
+// Recomputation of one operator as (left & right) | ((left | right) & orMask), inverted by invertMask,
+// which covers NOT, OR and AND without branches
+class GrayCodeUpdate {
+    public:
+        int node;
+        int left;
+        int right;
+        uint64_t orMask;
+        uint64_t invertMask;
+};
+
+class GrayCodeChecker {
+    public:
+        GrayCodeChecker(int threadCount);
+        bool load(int f[], int fLength);
+        int variableCount() const;
+        const std::vector<int>& variables() const;
+        int lanes() const;
+        void selectLanes(int laneCount);
+        bool findAssignment(bool value, std::vector<char>* assignment);
+        bool isTautology(std::vector<char>* counterexample);
+        bool isContradiction(std::vector<char>* counterexample);
+        int classify();
+        void cancel();
+        bool wasCancelled() const;
+        void reset();
+    private:
+        int threads;
+        bool loaded; // The last load succeeded
+        int laneCount; // Assignments per block
+        std::vector<int> symbols; // Symbols of the expression, with variables replaced by -1 - (dense variable id)
+        std::vector<GrayCodeUpdate> operators; // Recomputation of every operator, from the highest index down
+        std::vector<int> variableNames; // Symbol of each dense variable, in increasing order
+        std::vector<std::vector<int>> occurrences; // Indices of the occurrences of each variable
+        std::vector<GrayCodeUpdate> updates; // Operators above the occurrences of each variable, operands first
+        std::vector<int> firstUpdate; // Range of the updates of each variable, ending at the first update of the next
+        int laneBits; // Number of bit-pattern variables
+        int chunkBits; // Number of chunk variables
+        int grayBits; // Number of Gray-code variables
+        std::atomic<bool> stopping; // A thread found an assignment with the wanted value
+        std::atomic<bool> cancelled; // Set by cancel and cleared only by reset, so that no search misses it
+        std::atomic<uint64_t> nextChunk;
+        std::mutex resultMutex;
+        bool wantedValue;
+        bool found;
+        std::vector<char> result;
+        template <int words> void work();
+        void recordAssignment(int lane, uint64_t chunk, uint64_t gray);
+#ifdef SYMBOL_KERNELS_X86
+        __attribute__((target("avx2"))) void workAvx2();
+        __attribute__((target("avx512f"))) void workAvx512();
+#endif
+};
+
+inline GrayCodeChecker::GrayCodeChecker(int threadCount) {
+    threads = std::max(1, threadCount);
+    loaded = false;
+    int level = supportedKernelLevel();
+    laneCount = level >= avx512Kernels ? 512 : level >= avx2Kernels ? 256 : 64;
+    laneBits = 0;
+    chunkBits = 0;
+    grayBits = 0;
+    stopping = false;
+    cancelled = false;
+    nextChunk = 0;
+    wantedValue = false;
+    found = false;
+}
+
+inline bool GrayCodeChecker::load(int f[], int fLength) {
+    loaded = false;
+    int fStop = indexOfStop(f, fLength);
+    if (fStop < 1) {
+        return false;
+    }
+    std::vector<int> expression(f, f + fStop);
+    if (!isPolishExpression(expression)) {
+        // The expression must be a single Polish expression
+        return false;
+    }
+    std::vector<int> names;
+    for (int symbol : expression) {
+        if (isVariable(symbol)) {
+            names.push_back(symbol);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    if ((int) names.size() > 6 + maxGrayCodeVariables + 63) {
+        // The chunk variables and the Gray-code variables must each fit in a counter
+        return false;
+    }
+    variableNames = names;
+    symbols = expression;
+    occurrences.assign(variableNames.size(), std::vector<int>());
+    for (int i = 0; i < fStop; i++) {
+        if (isVariable(symbols[i])) {
+            int variable = (int) (std::lower_bound(variableNames.begin(), variableNames.end(), symbols[i]) - variableNames.begin());
+            symbols[i] = -1 - variable;
+            occurrences[variable].push_back(i);
+        }
+    }
+    // In Polish notation, the operands of an operator come after it, so each operator has a lower index than its operands
+    std::vector<GrayCodeUpdate> updateOf(fStop);
+    std::vector<int> parent(fStop, -1);
+    std::vector<int> open; // Operators whose operands are not complete yet
+    std::vector<int> needed;
+    for (int i = 0; i < fStop; i++) {
+        if (!open.empty()) {
+            int top = open.back();
+            parent[i] = top;
+            if (needed.back() == 1) {
+                // The last operand of the operator, which is the only operand of NOT
+                updateOf[top].right = i;
+            }
+            if (--needed.back() == 0) {
+                open.pop_back();
+                needed.pop_back();
+            }
+        }
+        int symbol = symbols[i];
+        if (symbol == NOT || symbol == OR || symbol == AND) {
+            updateOf[i] = GrayCodeUpdate{i, i + 1, i + 1, symbol == OR ? ~0ULL : 0, symbol == NOT ? ~0ULL : 0};
+            open.push_back(i);
+            needed.push_back(symbol == NOT ? 1 : 2);
+        }
+    }
+    operators.clear();
+    for (int i = fStop - 1; i >= 0; i--) {
+        if (symbols[i] == NOT || symbols[i] == OR || symbols[i] == AND) {
+            operators.push_back(updateOf[i]);
+        }
+    }
+    // The operators above a variable are recomputed from the highest index down, so operands come first
+    updates.clear();
+    firstUpdate.assign(variableNames.size() + 1, 0);
+    std::vector<int> mark(fStop, -1);
+    std::vector<int> above;
+    for (int variable = 0; variable < (int) variableNames.size(); variable++) {
+        above.clear();
+        for (int occurrence : occurrences[variable]) {
+            for (int node = parent[occurrence]; node >= 0 && mark[node] != variable; node = parent[node]) {
+                mark[node] = variable;
+                above.push_back(node);
+            }
+        }
+        std::sort(above.rbegin(), above.rend());
+        firstUpdate[variable] = (int) updates.size();
+        for (int node : above) {
+            updates.push_back(updateOf[node]);
+        }
+    }
+    firstUpdate[variableNames.size()] = (int) updates.size();
+    loaded = true;
+    return true;
+}
+
+inline int GrayCodeChecker::variableCount() const {
+    return (int) variableNames.size();
+}
+
+inline const std::vector<int>& GrayCodeChecker::variables() const {
+    return variableNames;
+}
+
+inline int GrayCodeChecker::lanes() const {
+    return laneCount;
+}
+
+inline void GrayCodeChecker::selectLanes(int lanes) {
+    // A lower width than the processor supports, such as for benchmarks
+    int level = supportedKernelLevel();
+    laneCount = lanes >= 512 && level >= avx512Kernels ? 512 : lanes >= 256 && level >= avx2Kernels ? 256 : 64;
+}
+
+inline void GrayCodeChecker::recordAssignment(int lane, uint64_t chunk, uint64_t gray) {
+    std::lock_guard<std::mutex> lock(resultMutex);
+    if (found) {
+        // Another thread found an assignment first
+        return;
+    }
+    found = true;
+    result.assign(variableNames.size(), false);
+    for (int v = 0; v < laneBits; v++) {
+        result[v] = (lane >> v) & 1;
+    }
+    for (int v = 0; v < grayBits; v++) {
+        result[laneBits + v] = (gray >> v) & 1;
+    }
+    for (int v = 0; v < chunkBits; v++) {
+        result[laneBits + grayBits + v] = (chunk >> v) & 1;
+    }
+}
+
+template <int words>
+__attribute__((always_inline)) inline void GrayCodeChecker::work() {
+    const uint64_t patterns[6] = {0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+    int nodeCount = (int) symbols.size();
+    uint64_t chunkCount = 1ULL << chunkBits;
+    uint64_t stepCount = grayBits == 0 ? 1 : 1ULL << grayBits;
+    std::vector<AssignmentBlock<words>> values(nodeCount);
+    std::vector<uint64_t> changedAt(nodeCount, 0); // Last step where the value of each node changed
+    uint64_t tick = 0;
+    uint64_t chunk;
+    while (!stopping.load(std::memory_order_relaxed) && !cancelled.load(std::memory_order_relaxed) && (chunk = nextChunk.fetch_add(1)) < chunkCount) {
+        // Evaluate the whole expression once for the first assignment of the chunk
+        for (int node = nodeCount - 1; node >= 0; node--) {
+            int symbol = symbols[node];
+            for (int w = 0; w < words; w++) {
+                uint64_t value = 0;
+                if (symbol < 0) {
+                    int variable = -1 - symbol;
+                    if (variable < laneBits) {
+                        value = variable < 6 ? patterns[variable] : ((w >> (variable - 6)) & 1 ? ~0ULL : 0);
+                    } else if (variable >= laneBits + grayBits) {
+                        value = (chunk >> (variable - laneBits - grayBits)) & 1 ? ~0ULL : 0;
+                    }
+                } else if (symbol == TRUE) {
+                    value = ~0ULL;
+                }
+                values[node].bits[w] = value;
+            }
+        }
+        for (const GrayCodeUpdate& update : operators) {
+            for (int w = 0; w < words; w++) {
+                uint64_t left = values[update.left].bits[w];
+                uint64_t right = values[update.right].bits[w];
+                values[update.node].bits[w] = ((left & right) | ((left | right) & update.orMask)) ^ update.invertMask;
+            }
+        }
+        uint64_t gray = 0;
+        for (uint64_t step = 1; ; step++) {
+            for (int w = 0; w < words; w++) {
+                uint64_t lanes = wantedValue ? values[0].bits[w] : ~values[0].bits[w];
+                if (lanes != 0) {
+                    recordAssignment(w * 64 + __builtin_ctzll(lanes), chunk, gray);
+                    stopping = true;
+                    return;
+                }
+            }
+            if (step == stepCount || stopping.load(std::memory_order_relaxed) || cancelled.load(std::memory_order_relaxed)) {
+                break;
+            }
+            // Gray code: the variable that flips at each step is the lowest set bit of the step
+            int flipped = __builtin_ctzll(step);
+            gray ^= 1ULL << flipped;
+            uint64_t value = (gray >> flipped) & 1 ? ~0ULL : 0;
+            int variable = laneBits + flipped;
+            tick++;
+            for (int occurrence : occurrences[variable]) {
+                for (int w = 0; w < words; w++) {
+                    values[occurrence].bits[w] = value;
+                }
+                changedAt[occurrence] = tick;
+            }
+            const GrayCodeUpdate* update = updates.data() + firstUpdate[variable];
+            const GrayCodeUpdate* lastUpdate = updates.data() + firstUpdate[variable + 1];
+            for (; update < lastUpdate; update++) {
+                if (changedAt[update->left] != tick && changedAt[update->right] != tick) {
+                    // Neither operand changed, so neither did the operator
+                    continue;
+                }
+                uint64_t difference = 0;
+                for (int w = 0; w < words; w++) {
+                    uint64_t left = values[update->left].bits[w];
+                    uint64_t right = values[update->right].bits[w];
+                    uint64_t next = ((left & right) | ((left | right) & update->orMask)) ^ update->invertMask;
+                    difference |= next ^ values[update->node].bits[w];
+                    values[update->node].bits[w] = next;
+                }
+                if (difference != 0) {
+                    changedAt[update->node] = tick;
+                }
+            }
+        }
+    }
+}
+
+#ifdef SYMBOL_KERNELS_X86
+// The same walk compiled for wider registers, where 4 or 8 words of a block fit in one register
+inline void GrayCodeChecker::workAvx2() {
+    work<4>();
+}
+
+inline void GrayCodeChecker::workAvx512() {
+    work<8>();
+}
+#endif
+
+inline bool GrayCodeChecker::findAssignment(bool value, std::vector<char>* assignment) {
+    // Finds an assignment under which the expression has the given value, and stops every thread at the first one.
+    // A cancelled search also finds none, which wasCancelled tells apart
+    if (!loaded) {
+        return false;
+    }
+    // Enough chunks for the threads to balance their work, and no more Gray-code variables than a counter holds
+    laneBits = std::min(variableCount(), laneCount == 512 ? 9 : laneCount == 256 ? 8 : 6);
+    int passVariables = variableCount() - laneBits;
+    int wantedChunkBits = 0;
+    while ((1 << wantedChunkBits) < threads * 16 && wantedChunkBits < 20) {
+        wantedChunkBits++;
+    }
+    chunkBits = std::max(std::min(passVariables, wantedChunkBits), passVariables - maxGrayCodeVariables);
+    grayBits = passVariables - chunkBits;
+    wantedValue = value;
+    found = false;
+    stopping = false;
+    nextChunk = 0;
+    void (GrayCodeChecker::*walk)() = &GrayCodeChecker::work<1>;
+#ifdef SYMBOL_KERNELS_X86
+    if (laneCount == 512) {
+        walk = &GrayCodeChecker::workAvx512;
+    } else if (laneCount == 256) {
+        walk = &GrayCodeChecker::workAvx2;
+    }
+#endif
+    std::vector<std::thread> workers;
+    int threadCount = (int) std::min<uint64_t>(threads, 1ULL << chunkBits);
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(walk, this);
+    }
+    (this->*walk)();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    if (found && assignment != nullptr) {
+        *assignment = result;
+    }
+    return found;
+}
+
+inline bool GrayCodeChecker::isTautology(std::vector<char>* counterexample) {
+    return loaded && !findAssignment(false, counterexample) && !cancelled;
+}
+
+inline bool GrayCodeChecker::isContradiction(std::vector<char>* counterexample) {
+    return loaded && !findAssignment(true, counterexample) && !cancelled;
+}
+
+inline int GrayCodeChecker::classify() {
+    if (!loaded) {
+        return notLoaded;
+    }
+    if (!findAssignment(true, nullptr)) {
+        return cancelled ? cancelledSearch : contradiction;
+    }
+    if (!findAssignment(false, nullptr)) {
+        return cancelled ? cancelledSearch : tautology;
+    }
+    return contingent;
+}
+
+inline void GrayCodeChecker::cancel() {
+    // Stops every thread of a running search from another thread, which then reports neither a tautology nor a
+    // contradiction. Every later search stops at once too, until reset
+    cancelled = true;
+}
+
+inline bool GrayCodeChecker::wasCancelled() const {
+    return cancelled;
+}
+
+inline void GrayCodeChecker::reset() {
+    // Allows searches again after cancel, which must not race with a search
+    cancelled = false;
+}
+
+#endif
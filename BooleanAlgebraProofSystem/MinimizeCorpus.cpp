@@ -0,0 +1,136 @@
+// MinimizeCorpus rewrites every proof of a proof corpus by a ProofMinimizer into a new corpus, in the same order.
+// Each proof is expanded from its steps into whole expressions, minimized, and encoded again, and a proof that is
+// not correct, or whose minimized steps are not correct for a DeltaVerifier, is written as it was read.
+// The law set is PE21LF, or PE12L when compiled with CORPUS_PE12L.
+// Usage: MinimizeCorpus <corpus> <output> [<rules>]
+
+#include <chrono>
+#include <iostream>
+
+#ifdef CORPUS_PE12L
+#include "PE12L.h"
+typedef PE12L CorpusLawSet;
+#else
+#include "PE21LF.h"
+typedef PE21LF CorpusLawSet;
+#endif
+#include "ProofCorpus.h"
+#include "ProofMinimizer.h"
+
+// Expressions of a proof of the corpus after each of its steps, padded with STOP to one length with room for the
+// matchers to look ahead, or false if a step does not fit in the expression
+bool expandProof(const CorpusProof& proof, int lookAhead, std::vector<int>& formula, std::vector<std::vector<int>>& formulas,
+    std::vector<Tuple>& sequence)
+{
+    std::vector<std::vector<int>> expressions(1, std::vector<int>(proof.formula, proof.formula + proof.fLength - 1));
+    size_t longest = expressions[0].size();
+    for (int i = 0; i < proof.stepCount; i++) {
+        const DeltaStep& step = proof.steps[i];
+        const std::vector<int>& previous = expressions.back();
+        int fStop = (int) previous.size();
+        if (step.index < 0 || step.removedLength < 0 || step.insertedLength < 0 || step.insertedStart < 0
+            || step.index > fStop || step.removedLength > fStop - step.index
+            || step.insertedStart > proof.insertedLength || step.insertedLength > proof.insertedLength - step.insertedStart)
+        {
+            return false;
+        }
+        std::vector<int> next(previous.begin(), previous.begin() + step.index);
+        next.insert(next.end(), proof.inserted + step.insertedStart, proof.inserted + step.insertedStart + step.insertedLength);
+        next.insert(next.end(), previous.begin() + step.index + step.removedLength, previous.end());
+        longest = std::max(longest, next.size());
+        expressions.push_back(std::move(next));
+    }
+    int fLength = (int) longest + 1 + lookAhead;
+    formula = expressions[0];
+    formula.resize(fLength, STOP);
+    formulas.assign(expressions.begin() + 1, expressions.end());
+    sequence.clear();
+    for (int i = 0; i < proof.stepCount; i++) {
+        formulas[i].resize(fLength, STOP);
+        sequence.push_back(Tuple(proof.steps[i].law, formulas[i].data()));
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <corpus> <output> [<rules>]\n";
+        return 2;
+    }
+    ProofCorpus corpus;
+    if (!corpus.open(argv[1])) {
+        std::cerr << "Cannot read the proof corpus " << argv[1] << "\n";
+        return 2;
+    }
+    if (corpus.lawCount() != CorpusLawSet::lawCount) {
+        std::cerr << "The proof corpus is for a law set with " << corpus.lawCount() << " laws instead of "
+            << CorpusLawSet::lawCount << "\n";
+        return 2;
+    }
+    DeltaVerifier<CorpusLawSet> verifier;
+    ProofMinimizer<CorpusLawSet> minimizer;
+    RuleSet rules;
+    if (argc == 4) {
+        if (!rules.load(argv[3])) {
+            if (rules.errorLine() == 0) {
+                std::cerr << "Cannot read the rewrite rules " << argv[3] << "\n";
+            } else {
+                std::cerr << "Cannot compile the rewrite rule on line " << rules.errorLine() << " of " << argv[3] << "\n";
+            }
+            return 2;
+        }
+        verifier.setRules(&rules);
+        minimizer.setRules(&rules);
+    }
+    ProofCorpusWriter output;
+    if (!output.open(argv[2], CorpusLawSet::lawCount)) {
+        std::cerr << "Cannot write the proof corpus " << argv[2] << "\n";
+        return 2;
+    }
+    int lookAhead = std::max(8, argc == 4 ? rules.longestSideLength() : 0);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t minimizedCount = 0;
+    uint64_t stepCount = 0;
+    uint64_t minimizedStepCount = 0;
+    CorpusProof proof;
+    std::vector<int> formula;
+    std::vector<std::vector<int>> formulas;
+    std::vector<Tuple> sequence;
+    SearchProof minimized;
+    DeltaProof original;
+    DeltaProof steps;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        corpus.advance(i);
+        if (!corpus.proof(i, &proof)) {
+            std::cerr << "Cannot read proof " << i << " of the proof corpus " << argv[1] << "\n";
+            return 2;
+        }
+        original.steps.assign(proof.steps, proof.steps + proof.stepCount);
+        original.inserted.assign(proof.inserted, proof.inserted + proof.insertedLength);
+        stepCount += proof.stepCount;
+        bool shorter = verifier.isProofSequence(proof.formula, proof.fLength, original, proof.target)
+            && expandProof(proof, lookAhead, formula, formulas, sequence)
+            && minimizer.minimize(formula.data(), (int) formula.size(), sequence.data(), (int) sequence.size(), proof.target, &minimized)
+            && minimized.length() < proof.stepCount;
+        if (shorter) {
+            std::vector<Tuple> minimizedSequence = minimized.sequence();
+            shorter = steps.encode(minimized.formula.data(), minimized.fLength, minimizedSequence.data(), minimized.length())
+                && verifier.isProofSequence(proof.formula, proof.fLength, steps, proof.target);
+        }
+        const DeltaProof& kept = shorter ? steps : original;
+        if (!output.add(proof.formula, proof.fLength, kept, proof.target)) {
+            std::cerr << "Cannot write the proof corpus " << argv[2] << "\n";
+            return 2;
+        }
+        minimizedCount += shorter ? 1 : 0;
+        minimizedStepCount += kept.steps.size();
+    }
+    if (!output.close()) {
+        std::cerr << "Cannot write the proof corpus " << argv[2] << "\n";
+        return 2;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << corpus.size() << " proofs: " << minimizedCount << " minimized, " << stepCount << " steps down to "
+        << minimizedStepCount << ", in " << seconds << " seconds\n";
+    return 0;
+}
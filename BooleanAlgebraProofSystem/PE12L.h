@@ -0,0 +1,42 @@
+#ifndef PE12L_H
+#define PE12L_H
+
+#include "ProofEngine.h"
+
+// PE12L (Prefix/Polish Notation, with Expressions, without Extras, with 12 Laws, without Forms, Two-way, without Indices)
+
+// Laws of Boolean algebra
+const int identity = 0; // a + 0 = a, a * 1 = a
+const int idempotent = 1; // a + a = a, a * a = a
+const int commutative = 2; // a + b = b + a, a * b = b * a
+const int associative = 3; // a + (b + c) = (a + b) + c, a * (b * c) = (a * b) * c
+const int distributive = 4; // a + (b * c) = (a + b) * (a + c), a * (b + c) = (a * b) + (a * c)
+const int deMorgan = 5; // -(a + b) = -a * -b, -(a * b) = -a + -b
+const int complement = 6; // a + -a = 1, a * -a = 0
+const int domination = 7; // a + 1 = 1, a * 0 = 0
+const int absorption = 8; // a + (a * b) = a, a * (a + b) = a
+const int doubleNegation = 9; // -(-a) = a
+const int negation = 10; // -1 = 0, -0 = 1
+const int substitution = 11; // -a = x, a + b = x, a * b = x
+
+// Law set of PE12L, where each law uses one matcher in both forms
+class PE12L {
+public:
+    static constexpr int lawCount = 12;
+    static constexpr LawRule rules[lawCount] = {
+        {identityMatcher, bothForms}, // identity
+        {idempotentMatcher, bothForms}, // idempotent
+        {commutativeMatcher, bothForms}, // commutative
+        {associativeMatcher, bothForms}, // associative
+        {distributiveMatcher, bothForms}, // distributive
+        {deMorganMatcher, bothForms}, // deMorgan
+        {complementMatcher, bothForms}, // complement
+        {dominationMatcher, bothForms}, // domination
+        {absorptionMatcher, bothForms}, // absorption
+        {doubleNegationMatcher, bothForms}, // doubleNegation
+        {negationMatcher, bothForms}, // negation
+        {substitutionMatcher, bothForms} // substitution
+    };
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef PE21LF_H
+#define PE21LF_H
+
+#include "ProofEngine.h"
+
+// PE21LF (Prefix/Polish Notation, with Expressions, without Extras, with 21 Laws, with Forms, Two-way, without Indices)
+
+// Laws of Boolean algebra
+const int identityOR = 0; // a + 0 = a
+const int identityAND = 1; // a * 1 = a
+const int idempotentOR = 2; // a + a = a
+const int idempotentAND = 3; // a * a = a
+const int commutativeOR = 4; // a + b = b + a
+const int commutativeAND = 5; // a * b = b * a
+const int associativeOR = 6; // a + (b + c) = (a + b) + c
+const int associativeAND = 7; // a * (b * c) = (a * b) * c
+const int distributiveOR = 8; // a + (b * c) = (a + b) * (a + c)
+const int distributiveAND = 9; // a * (b + c) = (a * b) + (a * c)
+const int deMorganOR = 10; // -(a + b) = -a * -b
+const int deMorganAND = 11; // -(a * b) = -a + -b
+const int complementOR = 12; // a + -a = 1
+const int complementAND = 13; // a * -a = 0
+const int dominationOR = 14; // a + 1 = 1
+const int dominationAND = 15; // a * 0 = 0
+const int absorptionOR = 16; // a + (a * b) = a
+const int absorptionAND = 17; // a * (a + b) = a
+const int doubleNegation = 18; // -(-a) = a
+const int negation = 19; // -1 = 0, -0 = 1
+const int substitution = 20; // -a = x, a + b = x, a * b = x
+
+// Law set of PE21LF, where each law uses one matcher in one form
+class PE21LF {
+    public:
+        static constexpr int lawCount = 21;
+        static constexpr LawRule rules[lawCount] = {
+            {identityMatcher, OR}, // identityOR
+            {identityMatcher, AND}, // identityAND
+            {idempotentMatcher, OR}, // idempotentOR
+            {idempotentMatcher, AND}, // idempotentAND
+            {commutativeMatcher, OR}, // commutativeOR
+            {commutativeMatcher, AND}, // commutativeAND
+            {associativeMatcher, OR}, // associativeOR
+            {associativeMatcher, AND}, // associativeAND
+            {distributiveMatcher, OR}, // distributiveOR
+            {distributiveMatcher, AND}, // distributiveAND
+            {deMorganMatcher, OR}, // deMorganOR
+            {deMorganMatcher, AND}, // deMorganAND
+            {complementMatcher, OR}, // complementOR
+            {complementMatcher, AND}, // complementAND
+            {dominationMatcher, OR}, // dominationOR
+            {dominationMatcher, AND}, // dominationAND
+            {absorptionMatcher, OR}, // absorptionOR
+            {absorptionMatcher, AND}, // absorptionAND
+            {doubleNegationMatcher, bothForms}, // doubleNegation
+            {negationMatcher, bothForms}, // negation
+            {substitutionMatcher, bothForms} // substitution
+        };
+};
+
+#endif
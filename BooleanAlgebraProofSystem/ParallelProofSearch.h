@@ -0,0 +1,409 @@
+#ifndef PARALLEL_PROOF_SEARCH_H
+#define PARALLEL_PROOF_SEARCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ProofEngine.h"
+#include "ProofSearch.h"
+#include "SearchBounds.h"
+
+// Iterative deepening A* for one expression on several threads. Each thread owns a deque of states and takes
+// the deepest state from its back, so that it searches depth-first, and a thread without states steals the
+// shallowest state from the front of another thread, which has the most work below it. All threads share a
+// lock-free table of the fewest steps to each state in the current iteration, so that no state is searched twice
+// from the same depth. Every iteration only reaches states within a limit that is above the limit of the last
+// iteration, so the first proof of an iteration is of minimal length and every thread stops at once
+
+// Lock-free table of states with the fewest steps taken to each, where each slot packs the upper bits of the
+// hash of a state with a generation in bits 8 to 15 and the steps in the low 8 bits. Slots of older generations
+// count as empty, so a new iteration of the search only clears the table when the generation wraps
+class SharedVisitedTable {
+    public:
+        SharedVisitedTable() {
+            mask = 0;
+            generation = 1;
+        }
+        void resize(int log2Slots) {
+            if (slots != nullptr && mask == ((size_t) 1 << log2Slots) - 1) {
+                return;
+            }
+            slots.reset(new std::atomic<uint64_t>[(size_t) 1 << log2Slots]);
+            mask = ((size_t) 1 << log2Slots) - 1;
+            // New slots hold whatever the allocator left there, such as the slots of an earlier search with current
+            // generations, so the first clear zeroes them
+            generation = 0xFF;
+            clear();
+        }
+        void clear() {
+            generation++;
+            if (generation > 0xFF) {
+                for (size_t i = 0; i <= mask; i++) {
+                    slots[i].store(0, std::memory_order_relaxed);
+                }
+                generation = 1;
+            }
+        }
+        bool visit(uint64_t key, int depth) {
+            // Returns false if the state was reached in no more steps, and otherwise stores the steps
+            uint64_t tag = key & ~0xFFFFULL;
+            uint64_t entry = tag | (generation << 8) | (uint64_t) std::min(depth, 255);
+            for (int p = 0; p < probes; p++) {
+                std::atomic<uint64_t>& slot = slots[(key + p) & mask];
+                uint64_t current = slot.load(std::memory_order_relaxed);
+                while (true) {
+                    bool empty = ((current >> 8) & 0xFF) != generation;
+                    if (!empty && (current & ~0xFFFFULL) != tag) {
+                        break;
+                    }
+                    if (!empty && (int) (current & 0xFF) <= depth) {
+                        return false;
+                    }
+                    if (slot.compare_exchange_weak(current, entry, std::memory_order_relaxed)) {
+                        return true;
+                    }
+                }
+            }
+            // A full neighbourhood only forgets the state, which costs a repeated search but no proof
+            return true;
+        }
+    private:
+        static constexpr int probes = 8;
+        std::unique_ptr<std::atomic<uint64_t>[]> slots;
+        size_t mask;
+        uint64_t generation; // Generation of the slots of the current iteration, from 1 to 255
+};
+
+template <class LawSet, class Bound = LengthBound>
+class ParallelProofSearch {
+    public:
+        ParallelProofSearch(int threadCount);
+        void setMaxLength(int length);
+        void setMaxDepth(int depth);
+        void setTableSize(int log2Slots);
+        Bound& lowerBound();
+        bool findProof(int formula[], int fLength, int target, SearchProof* proof);
+        void cancel();
+        bool wasCancelled() const;
+        void reset();
+        size_t nodesExpanded() const;
+        size_t steals() const;
+        double nodesPerSecond() const;
+    private:
+        // Expression of a state and the step that reached it, shared by every state below it
+        class PathStep {
+            public:
+                int law;
+                int formulaStop;
+                std::vector<int> formula;
+                std::shared_ptr<const PathStep> previous;
+        };
+        class SearchTask {
+            public:
+                std::shared_ptr<const PathStep> path;
+                std::vector<VariableRecord> variables;
+                int depth;
+        };
+        class SearchWorker {
+            public:
+                std::mutex mutex;
+                std::deque<SearchTask> tasks;
+                StepExpander<LawSet> steps;
+                std::vector<int> current;
+                std::vector<SearchTask> children;
+                std::vector<int> estimates;
+                std::vector<int> order;
+                size_t expanded;
+                size_t stolen;
+        };
+        int threads;
+        Bound bound;
+        int maxLength; // Longest expression, or 0 for 8 symbols more than the initial expression
+        int maxDepth;
+        int tableBits;
+        int arrayLength;
+        int target;
+        int limit;
+        double seconds;
+        std::vector<std::unique_ptr<SearchWorker>> workers;
+        SharedVisitedTable visited;
+        std::atomic<bool> stopping; // A thread found a proof
+        std::atomic<bool> cancelled; // Set by cancel and cleared only by reset, so that no search misses it
+        std::atomic<int> nextLimit; // Lowest estimate above the limit of the states that were cut off
+        std::atomic<size_t> pending; // States in a deque or being expanded
+        std::mutex resultMutex;
+        bool found;
+        std::shared_ptr<const PathStep> goal;
+        void work(int w);
+        bool takeTask(int w, SearchTask& task);
+        void expandTask(int w, SearchTask& task);
+};
+
+template <class LawSet, class Bound>
+ParallelProofSearch<LawSet, Bound>::ParallelProofSearch(int threadCount) {
+    threads = std::max(1, threadCount);
+    maxLength = 0;
+    maxDepth = 64;
+    tableBits = 20;
+    arrayLength = 0;
+    target = TRUE;
+    limit = 0;
+    seconds = 0;
+    found = false;
+    stopping = false;
+    cancelled = false;
+    nextLimit = INT32_MAX;
+    pending = 0;
+    for (int w = 0; w < threads; w++) {
+        workers.emplace_back(new SearchWorker());
+        workers.back()->expanded = 0;
+        workers.back()->stolen = 0;
+    }
+}
+
+template <class LawSet, class Bound>
+void ParallelProofSearch<LawSet, Bound>::setMaxLength(int length) {
+    maxLength = length;
+}
+
+template <class LawSet, class Bound>
+void ParallelProofSearch<LawSet, Bound>::setMaxDepth(int depth) {
+    // The visited table holds at most 255 steps
+    maxDepth = std::min(depth, 254);
+}
+
+template <class LawSet, class Bound>
+void ParallelProofSearch<LawSet, Bound>::setTableSize(int log2Slots) {
+    tableBits = log2Slots;
+}
+
+template <class LawSet, class Bound>
+Bound& ParallelProofSearch<LawSet, Bound>::lowerBound() {
+    return bound;
+}
+
+template <class LawSet, class Bound>
+size_t ParallelProofSearch<LawSet, Bound>::nodesExpanded() const {
+    size_t total = 0;
+    for (const std::unique_ptr<SearchWorker>& worker : workers) {
+        total += worker->expanded;
+    }
+    return total;
+}
+
+template <class LawSet, class Bound>
+size_t ParallelProofSearch<LawSet, Bound>::steals() const {
+    size_t total = 0;
+    for (const std::unique_ptr<SearchWorker>& worker : workers) {
+        total += worker->stolen;
+    }
+    return total;
+}
+
+template <class LawSet, class Bound>
+double ParallelProofSearch<LawSet, Bound>::nodesPerSecond() const {
+    return seconds > 0 ? nodesExpanded() / seconds : 0;
+}
+
+template <class LawSet, class Bound>
+void ParallelProofSearch<LawSet, Bound>::cancel() {
+    // Stops every thread of a running search from another thread, which then finds no proof. Every later search
+    // stops at once too, until reset
+    cancelled = true;
+}
+
+template <class LawSet, class Bound>
+bool ParallelProofSearch<LawSet, Bound>::wasCancelled() const {
+    // Whether a search that found no proof was cancelled rather than exhausted
+    return cancelled;
+}
+
+template <class LawSet, class Bound>
+void ParallelProofSearch<LawSet, Bound>::reset() {
+    // Allows searches again after cancel, which must not race with a search
+    cancelled = false;
+}
+
+template <class LawSet, class Bound>
+bool ParallelProofSearch<LawSet, Bound>::takeTask(int w, SearchTask& task) {
+    {
+        SearchWorker& own = *workers[w];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (int k = 1; k < threads; k++) {
+        SearchWorker& victim = *workers[(w + k) % threads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            workers[w]->stolen++;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class LawSet, class Bound>
+void ParallelProofSearch<LawSet, Bound>::expandTask(int w, SearchTask& task) {
+    SearchWorker& worker = *workers[w];
+    const PathStep& step = *task.path;
+    if (task.depth > 0 && step.formulaStop == 1 && step.formula[0] == target) {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        if (!found) {
+            found = true;
+            goal = task.path;
+        }
+        stopping = true;
+        return;
+    }
+    if (task.depth >= maxDepth) {
+        return;
+    }
+    worker.expanded++;
+    worker.children.clear();
+    worker.estimates.clear();
+    int depth = task.depth;
+    worker.current = step.formula;
+    worker.steps.expand(worker.current.data(), step.formulaStop, arrayLength, task.variables.data(), (int) task.variables.size(),
+        [&](int law, int index, const int g[], int gStop, const std::vector<VariableRecord>& nextVariables) {
+            (void) index;
+            int estimate = depth + 1 + bound.estimate(g, gStop, target);
+            if (estimate > limit) {
+                int lowest = nextLimit.load(std::memory_order_relaxed);
+                while (estimate < lowest && !nextLimit.compare_exchange_weak(lowest, estimate, std::memory_order_relaxed)) {
+                }
+                return;
+            }
+            if (!visited.visit(stateHash(g, gStop, nextVariables.data(), (int) nextVariables.size()), depth + 1)) {
+                return;
+            }
+            std::shared_ptr<PathStep> next = std::make_shared<PathStep>();
+            next->law = law;
+            next->formulaStop = gStop;
+            next->formula.assign(g, g + arrayLength);
+            next->previous = task.path;
+            worker.children.push_back(SearchTask{next, nextVariables, depth + 1});
+            worker.estimates.push_back(estimate);
+        });
+    int count = (int) worker.children.size();
+    if (count == 0) {
+        return;
+    }
+    // The state with the lowest estimate goes to the back, where this thread takes it next
+    worker.order.resize(count);
+    for (int k = 0; k < count; k++) {
+        worker.order[k] = k;
+    }
+    std::stable_sort(worker.order.begin(), worker.order.end(), [&](int x, int y) { return worker.estimates[x] > worker.estimates[y]; });
+    pending += count;
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    for (int k : worker.order) {
+        worker.tasks.push_back(std::move(worker.children[k]));
+    }
+}
+
+template <class LawSet, class Bound>
+void ParallelProofSearch<LawSet, Bound>::work(int w) {
+    SearchTask task;
+    while (!stopping && !cancelled) {
+        if (!takeTask(w, task)) {
+            if (pending == 0) {
+                // Every state of the iteration is expanded
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        expandTask(w, task);
+        task = SearchTask();
+        pending--;
+    }
+}
+
+template <class LawSet, class Bound>
+bool ParallelProofSearch<LawSet, Bound>::findProof(int formula[], int fLength, int searchTarget, SearchProof* proof) {
+    int fStop = indexOfStop(formula, fLength);
+    if (fStop < 1 || (searchTarget != TRUE && searchTarget != FALSE)) {
+        // The Boolean expression must not be empty, and the target must be a truth value
+        return false;
+    }
+    int longest = maxLength > 0 ? maxLength : fStop + 8;
+    if (fStop > longest) {
+        return false;
+    }
+    bound.prepare(longest);
+    visited.resize(tableBits);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    target = searchTarget;
+    arrayLength = longest + 1;
+    std::shared_ptr<PathStep> root = std::make_shared<PathStep>();
+    root->law = noLaw;
+    root->formulaStop = fStop;
+    root->formula.assign(arrayLength, STOP);
+    std::copy(formula, formula + fStop, root->formula.begin());
+    std::vector<VariableRecord> variables;
+    workers[0]->steps.initialVariables(root->formula.data(), variables);
+    for (std::unique_ptr<SearchWorker>& worker : workers) {
+        worker->expanded = 0;
+        worker->stolen = 0;
+    }
+    found = false;
+    goal = nullptr;
+    limit = bound.estimate(root->formula.data(), fStop, target);
+    while (!found && !cancelled && limit <= maxDepth) {
+        visited.clear();
+        visited.visit(stateHash(root->formula.data(), fStop, variables.data(), (int) variables.size()), 0);
+        nextLimit = INT32_MAX;
+        stopping = false;
+        pending = 1;
+        workers[0]->tasks.push_back(SearchTask{root, variables, 0});
+        std::vector<std::thread> threadPool;
+        for (int w = 1; w < threads; w++) {
+            threadPool.emplace_back(&ParallelProofSearch::work, this, w);
+        }
+        work(0);
+        for (std::thread& thread : threadPool) {
+            thread.join();
+        }
+        for (std::unique_ptr<SearchWorker>& worker : workers) {
+            // States left by a stop
+            worker->tasks.clear();
+        }
+        limit = nextLimit;
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!found) {
+        return false;
+    }
+    if (proof != nullptr) {
+        std::vector<const PathStep*> path;
+        for (const PathStep* step = goal.get(); step->previous != nullptr; step = step->previous.get()) {
+            path.push_back(step);
+        }
+        std::reverse(path.begin(), path.end());
+        proof->fLength = arrayLength;
+        proof->formula = root->formula;
+        proof->laws.clear();
+        proof->formulas.clear();
+        for (const PathStep* step : path) {
+            proof->laws.push_back(step->law);
+            proof->formulas.push_back(step->formula);
+        }
+    }
+    goal = nullptr;
+    return true;
+}
+
+#endif
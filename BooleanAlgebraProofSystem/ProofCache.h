@@ -0,0 +1,727 @@
+#ifndef PROOF_CACHE_H
+#define PROOF_CACHE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PROOF_CACHE_MMAP
+#endif
+
+#include "DeltaProof.h"
+#include "ProofSearch.h"
+
+// Cache of proofs in a file that is shared by processes and kept across runs, which maps each expression to the
+// proof of fewest steps that is known for it and to the verdict of that proof. The laws do not depend on the names
+// of variables, so an expression is keyed with its variables renamed in order of first occurrence, as countVariables
+// of the enumerator requires of the expressions it enumerates, and its proof is stored with the same names.
+// The file is only appended to, under a lock of the file, and it is read through a read-only shared mapping, so
+// readers take no lock. A compacted file starts with an open-addressing table of the best record of each expression,
+// and records appended after the table are indexed in memory when the file is mapped or refreshed
+
+// Layout of a cache file, in the byte order of the machine: this header, the slots of the table, the records that
+// the table indexes, then the appended records. A record is followed by the expression and STOP, the steps as
+// DeltaStep records and the inserted symbols, all renamed, and is padded to 8 bytes
+class ProofCacheHeader {
+    public:
+        uint32_t magic;
+        uint32_t version;
+        uint32_t lawCount; // Laws of the law set that the proofs use
+        uint32_t stepSize; // Bytes of a step record
+        uint64_t slotCount; // Slots of the table, a power of 2 or 0
+        uint64_t formulaCount; // Expressions in the table
+        uint64_t recordsEnd; // End of the records of the table, where appended records start
+};
+
+class ProofCacheSlot {
+    public:
+        uint64_t hash;
+        uint64_t offset; // Offset of the record in the file, or 0 if the slot is empty
+};
+
+class ProofCacheRecord {
+    public:
+        uint32_t magic;
+        uint32_t fLength; // Symbols of the expression, without STOP
+        uint32_t stepCount;
+        uint32_t insertedLength;
+        int32_t target;
+        uint32_t correct; // 1 if the proof is correct
+        uint64_t hash;
+        uint64_t checksum; // Hash of the other fields and of the symbols and steps, for records cut short by a crash
+};
+
+const uint32_t proofCacheMagic = 0x4B505342; // "BSPK"
+const uint32_t proofCacheRecordMagic = 0x52505342; // "BSPR"
+const uint32_t proofCacheVersion = 1;
+
+// Proof of a cache, which points into the file and has the renamed variables of the cache
+class CachedProof {
+    public:
+        const int* formula; // Expression, followed by STOP
+        int fLength; // Symbols of the expression, with STOP
+        const DeltaStep* steps;
+        int stepCount;
+        const int* inserted;
+        int insertedLength;
+        int target;
+        bool correct;
+};
+
+// Appends to names the variables of the symbols that are not in names yet, in order of first occurrence
+inline void addVariableNames(const int symbols[], int length, std::vector<int>& names) {
+    for (int i = 0; i < length; i++) {
+        if (isVariable(symbols[i]) && std::find(names.begin(), names.end(), symbols[i]) == names.end()) {
+            names.push_back(symbols[i]);
+        }
+    }
+}
+
+// Renames the variables of the symbols into minVariable, minVariable + 1, ... in the order of names
+inline void renameVariables(const int symbols[], int length, const std::vector<int>& names, std::vector<int>& renamed) {
+    renamed.resize(length);
+    for (int i = 0; i < length; i++) {
+        int symbol = symbols[i];
+        if (isVariable(symbol)) {
+            symbol = minVariable + (int) (std::find(names.begin(), names.end(), symbol) - names.begin());
+        }
+        renamed[i] = symbol;
+    }
+}
+
+inline uint64_t proofCacheHash(const int canonical[], int fStop) {
+    uint64_t hash = (uint64_t) fStop;
+    for (int i = 0; i < fStop; i++) {
+        hash = mixStateHash(hash, (uint64_t) (uint32_t) canonical[i]);
+    }
+    return mixStateHash(hash, 0x9E3779B97F4A7C15ULL);
+}
+
+class ProofCache {
+    public:
+        ProofCache();
+        ~ProofCache();
+        ProofCache(const ProofCache&) = delete;
+        ProofCache& operator=(const ProofCache&) = delete;
+        static bool create(const char* path, int lawCount);
+        bool open(const char* path);
+        bool refresh();
+        void close();
+        size_t size() const;
+        size_t bytes() const;
+        int lawCount() const;
+        bool lookup(const int formula[], int fLength, CachedProof* result);
+        bool lookup(const int formula[], int fLength, DeltaProof* proof, int* target, bool* correct);
+        bool add(const int formula[], int fLength, const DeltaProof& proof, int target, bool correct);
+        bool compact();
+    private:
+        std::string path;
+        const uint8_t* data;
+        size_t dataSize;
+        void* mapping; // Mapped file, or nullptr when the file was read
+        std::vector<uint8_t> contents; // File contents when it cannot be mapped
+        uint64_t device; // File that is mapped, which a compaction replaces by another file
+        uint64_t inode;
+        ProofCacheHeader header;
+        const ProofCacheSlot* slots;
+        size_t scannedEnd; // End of the valid appended records
+        std::unordered_map<uint64_t, std::vector<uint64_t>> appended; // Offsets of the best appended record of each expression
+        size_t formulaCount;
+        std::vector<int> names;
+        std::vector<int> canonical;
+        std::vector<int> renamed;
+        bool map();
+        void unmap();
+        void scan();
+        bool record(uint64_t offset, CachedProof* result) const;
+        bool find(const int f[], int fStop, uint64_t hash, CachedProof* result, uint64_t* offset) const;
+        bool findInTable(const int f[], int fStop, uint64_t hash, CachedProof* result, uint64_t* offset) const;
+        bool canonicalize(const int formula[], int fLength);
+        static bool better(const CachedProof& x, const CachedProof& y);
+        static uint64_t checksum(const ProofCacheRecord& stored, const uint8_t* payload, size_t payloadBytes);
+        static size_t payloadBytes(const ProofCacheRecord& stored);
+        static size_t recordBytes(const ProofCacheRecord& stored);
+};
+
+inline ProofCache::ProofCache() {
+    data = nullptr;
+    dataSize = 0;
+    mapping = nullptr;
+    device = 0;
+    inode = 0;
+    header = ProofCacheHeader{};
+    slots = nullptr;
+    scannedEnd = 0;
+    formulaCount = 0;
+}
+
+inline ProofCache::~ProofCache() {
+    close();
+}
+
+inline bool ProofCache::create(const char* path, int lawCount) {
+    // An empty cache, unless the file exists, which another process may have created and appended to
+    ProofCacheHeader empty{};
+    empty.magic = proofCacheMagic;
+    empty.version = proofCacheVersion;
+    empty.lawCount = (uint32_t) lawCount;
+    empty.stepSize = (uint32_t) sizeof(DeltaStep);
+    empty.recordsEnd = sizeof(ProofCacheHeader);
+#ifdef PROOF_CACHE_MMAP
+    int descriptor = ::open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (descriptor < 0) {
+        return errno == EEXIST;
+    }
+    // Writers lock the file before they read its size, so no record is appended before the header
+    flock(descriptor, LOCK_EX);
+    bool written = ::write(descriptor, &empty, sizeof(ProofCacheHeader)) == (ssize_t) sizeof(ProofCacheHeader);
+    flock(descriptor, LOCK_UN);
+    ::close(descriptor);
+    return written;
+#else
+    if (std::ifstream(path, std::ios::binary)) {
+        return true;
+    }
+    std::ofstream output(path, std::ios::binary);
+    output.write((const char*) &empty, sizeof(ProofCacheHeader));
+    return (bool) output;
+#endif
+}
+
+inline bool ProofCache::open(const char* cachePath) {
+    close();
+    path = cachePath;
+    if (!map()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+inline bool ProofCache::map() {
+    // Maps the file at the path and indexes its appended records
+    unmap();
+#ifdef PROOF_CACHE_MMAP
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || (size_t) status.st_size < sizeof(ProofCacheHeader)) {
+        ::close(descriptor);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    // The mapping stays valid after the file is closed
+    ::close(descriptor);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    mapping = mapped;
+    data = (const uint8_t*) mapped;
+    dataSize = (size_t) status.st_size;
+    device = (uint64_t) status.st_dev;
+    inode = (uint64_t) status.st_ino;
+    // Lookups go to random records
+    madvise(mapped, dataSize, MADV_RANDOM);
+#else
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    contents.swap(bytes);
+    data = contents.data();
+    dataSize = contents.size();
+#endif
+    ProofCacheHeader stored;
+    if (dataSize < sizeof(ProofCacheHeader)) {
+        return false;
+    }
+    std::memcpy(&stored, data, sizeof(ProofCacheHeader));
+    uint64_t tableEnd = sizeof(ProofCacheHeader) + stored.slotCount * sizeof(ProofCacheSlot);
+    if (stored.magic != proofCacheMagic || stored.version != proofCacheVersion || stored.stepSize != sizeof(DeltaStep)
+        || (stored.slotCount & (stored.slotCount - 1)) != 0 || stored.slotCount > dataSize / sizeof(ProofCacheSlot)
+        || stored.formulaCount > stored.slotCount || stored.recordsEnd < tableEnd || stored.recordsEnd > dataSize
+        || stored.recordsEnd % 8 != 0) {
+        return false;
+    }
+    header = stored;
+    slots = (const ProofCacheSlot*) (data + sizeof(ProofCacheHeader));
+    formulaCount = (size_t) header.formulaCount;
+    scannedEnd = (size_t) header.recordsEnd;
+    scan();
+    return true;
+}
+
+inline void ProofCache::unmap() {
+#ifdef PROOF_CACHE_MMAP
+    if (mapping != nullptr) {
+        munmap(mapping, dataSize);
+    }
+#endif
+    mapping = nullptr;
+    contents.clear();
+    data = nullptr;
+    dataSize = 0;
+    device = 0;
+    inode = 0;
+    header = ProofCacheHeader{};
+    slots = nullptr;
+    scannedEnd = 0;
+    appended.clear();
+    formulaCount = 0;
+}
+
+inline bool ProofCache::refresh() {
+    // Maps the records that other processes appended since the file was mapped, or the file that a compaction put
+    // in its place. Records that were indexed keep their offsets, so only the new records are read
+    if (path.empty()) {
+        return false;
+    }
+#ifdef PROOF_CACHE_MMAP
+    struct stat status;
+    if (stat(path.c_str(), &status) != 0) {
+        return false;
+    }
+    if ((uint64_t) status.st_dev != device || (uint64_t) status.st_ino != inode || (size_t) status.st_size < dataSize) {
+        return map();
+    }
+    if ((size_t) status.st_size == dataSize) {
+        // A writer may have written over a torn record at the end with a record of the same length, which the shared
+        // mapping shows
+        scan();
+        return true;
+    }
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat opened;
+    if (fstat(descriptor, &opened) != 0 || (uint64_t) opened.st_ino != inode || (uint64_t) opened.st_dev != device) {
+        ::close(descriptor);
+        return map();
+    }
+    void* mapped = mmap(nullptr, (size_t) opened.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    munmap(mapping, dataSize);
+    mapping = mapped;
+    data = (const uint8_t*) mapped;
+    dataSize = (size_t) opened.st_size;
+    slots = (const ProofCacheSlot*) (data + sizeof(ProofCacheHeader));
+    madvise(mapped, dataSize, MADV_RANDOM);
+    scan();
+    return true;
+#else
+    return map();
+#endif
+}
+
+inline void ProofCache::close() {
+    unmap();
+    path.clear();
+}
+
+inline size_t ProofCache::size() const {
+    // Expressions with a proof in the cache
+    return formulaCount;
+}
+
+inline size_t ProofCache::bytes() const {
+    return dataSize;
+}
+
+inline int ProofCache::lawCount() const {
+    return (int) header.lawCount;
+}
+
+inline size_t ProofCache::payloadBytes(const ProofCacheRecord& stored) {
+    // Bytes of the symbols and steps after the record, without padding
+    return ((size_t) stored.fLength + 1 + stored.insertedLength) * sizeof(int) + (size_t) stored.stepCount * sizeof(DeltaStep);
+}
+
+inline size_t ProofCache::recordBytes(const ProofCacheRecord& stored) {
+    return (sizeof(ProofCacheRecord) + payloadBytes(stored) + 7) / 8 * 8;
+}
+
+inline uint64_t ProofCache::checksum(const ProofCacheRecord& stored, const uint8_t* payload, size_t payloadBytes) {
+    uint64_t hash = mixStateHash(stored.hash, ((uint64_t) stored.fLength << 32) | stored.stepCount);
+    hash = mixStateHash(hash, ((uint64_t) stored.insertedLength << 32) | (uint32_t) stored.target);
+    hash = mixStateHash(hash, stored.correct);
+    for (size_t i = 0; i + sizeof(uint32_t) <= payloadBytes; i += sizeof(uint32_t)) {
+        uint32_t word;
+        std::memcpy(&word, payload + i, sizeof(uint32_t));
+        hash = mixStateHash(hash, word);
+    }
+    return hash;
+}
+
+inline bool ProofCache::record(uint64_t offset, CachedProof* result) const {
+    // A record whose symbols and steps are not within the file is not read
+    if (offset < sizeof(ProofCacheHeader) || offset % 8 != 0 || offset > dataSize || dataSize - offset < sizeof(ProofCacheRecord)) {
+        return false;
+    }
+    ProofCacheRecord stored;
+    std::memcpy(&stored, data + offset, sizeof(ProofCacheRecord));
+    if (stored.magic != proofCacheRecordMagic || stored.fLength >= (uint32_t) INT32_MAX / 2
+        || stored.stepCount > (uint32_t) INT32_MAX / 8 || stored.insertedLength >= (uint32_t) INT32_MAX / 2
+        || recordBytes(stored) > dataSize - offset) {
+        return false;
+    }
+    const uint8_t* block = data + offset + sizeof(ProofCacheRecord);
+    result->formula = (const int*) block;
+    result->fLength = (int) stored.fLength + 1;
+    result->steps = (const DeltaStep*) (block + ((size_t) stored.fLength + 1) * sizeof(int));
+    result->stepCount = (int) stored.stepCount;
+    result->inserted = (const int*) (block + ((size_t) stored.fLength + 1) * sizeof(int) + (size_t) stored.stepCount * sizeof(DeltaStep));
+    result->insertedLength = (int) stored.insertedLength;
+    result->target = stored.target;
+    result->correct = stored.correct != 0;
+    return result->formula[stored.fLength] == STOP;
+}
+
+inline bool ProofCache::better(const CachedProof& x, const CachedProof& y) {
+    // A correct proof is better than one that is not, and then a proof of fewer steps
+    if (x.correct != y.correct) {
+        return x.correct;
+    }
+    return x.stepCount < y.stepCount;
+}
+
+inline void ProofCache::scan() {
+    // Indexes the appended records from the end of those that were indexed, up to the end of the file or to a record
+    // that is cut short, which a writer that is appending it completes later, or that a crash left behind
+    while (dataSize - scannedEnd >= sizeof(ProofCacheRecord)) {
+        ProofCacheRecord stored;
+        std::memcpy(&stored, data + scannedEnd, sizeof(ProofCacheRecord));
+        CachedProof proof;
+        if (!record(scannedEnd, &proof)) {
+            return;
+        }
+        if (checksum(stored, data + scannedEnd + sizeof(ProofCacheRecord), payloadBytes(stored)) != stored.checksum) {
+            return;
+        }
+        uint64_t offset = (uint64_t) scannedEnd;
+        scannedEnd += recordBytes(stored);
+        std::vector<uint64_t>& offsets = appended[stored.hash];
+        bool found = false;
+        for (uint64_t& previous : offsets) {
+            CachedProof other;
+            if (record(previous, &other) && other.fLength == proof.fLength && std::equal(proof.formula, proof.formula + proof.fLength, other.formula)) {
+                found = true;
+                if (better(proof, other)) {
+                    previous = offset;
+                }
+            }
+        }
+        if (!found) {
+            offsets.push_back(offset);
+            CachedProof inTable;
+            uint64_t tableOffset;
+            if (!findInTable(proof.formula, proof.fLength - 1, stored.hash, &inTable, &tableOffset)) {
+                formulaCount++;
+            }
+        }
+    }
+}
+
+inline bool ProofCache::findInTable(const int f[], int fStop, uint64_t hash, CachedProof* result, uint64_t* offset) const {
+    if (header.slotCount == 0) {
+        return false;
+    }
+    uint64_t mask = header.slotCount - 1;
+    for (uint64_t slot = hash & mask, probes = 0; probes < header.slotCount && slots[slot].offset != 0; slot = (slot + 1) & mask, probes++) {
+        if (slots[slot].hash == hash && record(slots[slot].offset, result) && result->fLength == fStop + 1
+            && std::equal(f, f + fStop, result->formula))
+        {
+            *offset = slots[slot].offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool ProofCache::find(const int f[], int fStop, uint64_t hash, CachedProof* result, uint64_t* offset) const {
+    // The best proof of the renamed expression in the table or in the appended records
+    bool found = findInTable(f, fStop, hash, result, offset);
+    auto entry = appended.find(hash);
+    if (entry == appended.end()) {
+        return found;
+    }
+    for (uint64_t candidate : entry->second) {
+        CachedProof proof;
+        if (record(candidate, &proof) && proof.fLength == fStop + 1 && std::equal(f, f + fStop, proof.formula)
+            && (!found || better(proof, *result)))
+        {
+            *result = proof;
+            *offset = candidate;
+            found = true;
+        }
+    }
+    return found;
+}
+
+inline bool ProofCache::canonicalize(const int formula[], int fLength) {
+    // The expression with its variables renamed into canonical, and their names in order in names
+    int fStop = findStop(formula, fLength);
+    if (fStop < 1 || fStop == fLength) {
+        return false;
+    }
+    names.clear();
+    addVariableNames(formula, fStop, names);
+    renameVariables(formula, fStop, names, canonical);
+    return true;
+}
+
+inline bool ProofCache::lookup(const int formula[], int fLength, CachedProof* result) {
+    // The proof of the expression or of a renaming of it, with the renamed variables of the cache
+    if (data == nullptr || !canonicalize(formula, fLength)) {
+        return false;
+    }
+    uint64_t offset;
+    return find(canonical.data(), (int) canonical.size(), proofCacheHash(canonical.data(), (int) canonical.size()), result, &offset);
+}
+
+inline bool ProofCache::lookup(const int formula[], int fLength, DeltaProof* proof, int* target, bool* correct) {
+    // The proof of the expression with its own variables, where variables that only the steps use are given names
+    // after the greatest variable of the expression
+    CachedProof cached;
+    if (!lookup(formula, fLength, &cached)) {
+        return false;
+    }
+    int nextName = names.empty() ? minVariable : *std::max_element(names.begin(), names.end()) + 1;
+    proof->clear();
+    for (int i = 0; i < cached.stepCount; i++) {
+        const DeltaStep& step = cached.steps[i];
+        if (step.insertedStart < 0 || step.insertedLength < 0 || step.insertedStart > cached.insertedLength
+            || step.insertedLength > cached.insertedLength - step.insertedStart)
+        {
+            return false;
+        }
+        renamed.assign(cached.inserted + step.insertedStart, cached.inserted + step.insertedStart + step.insertedLength);
+        for (int& symbol : renamed) {
+            if (isVariable(symbol)) {
+                size_t k = (size_t) (symbol - minVariable);
+                while (names.size() <= k) {
+                    names.push_back(nextName++);
+                }
+                symbol = names[k];
+            }
+        }
+        proof->addStep(step.law, step.index, step.removedLength, renamed.data(), (int) renamed.size());
+    }
+    *target = cached.target;
+    *correct = cached.correct;
+    return true;
+}
+
+inline bool ProofCache::add(const int formula[], int fLength, const DeltaProof& proof, int target, bool correct) {
+    // Appends the proof unless the cache has a proof of the expression that is no worse, and true if the cache then
+    // has the proof or a better one. Variables that only the steps use are renamed after those of the expression
+    if (path.empty() || !canonicalize(formula, fLength)) {
+        return false;
+    }
+    int fStop = (int) canonical.size();
+    for (const DeltaStep& step : proof.steps) {
+        if (step.insertedStart < 0 || step.insertedLength < 0 || step.insertedStart > (int) proof.inserted.size()
+            || step.insertedLength > (int) proof.inserted.size() - step.insertedStart)
+        {
+            return false;
+        }
+        addVariableNames(proof.inserted.data() + step.insertedStart, step.insertedLength, names);
+    }
+    ProofCacheRecord stored{};
+    stored.magic = proofCacheRecordMagic;
+    stored.fLength = (uint32_t) fStop;
+    stored.stepCount = (uint32_t) proof.steps.size();
+    stored.insertedLength = (uint32_t) proof.inserted.size();
+    stored.target = target;
+    stored.correct = correct ? 1 : 0;
+    stored.hash = proofCacheHash(canonical.data(), fStop);
+    std::vector<uint8_t> bytes(recordBytes(stored), 0);
+    uint8_t* block = bytes.data() + sizeof(ProofCacheRecord);
+    std::memcpy(block, canonical.data(), fStop * sizeof(int));
+    int stop = STOP;
+    std::memcpy(block + fStop * sizeof(int), &stop, sizeof(int));
+    if (!proof.steps.empty()) {
+        std::memcpy(block + (fStop + 1) * sizeof(int), proof.steps.data(), proof.steps.size() * sizeof(DeltaStep));
+    }
+    renameVariables(proof.inserted.data(), (int) proof.inserted.size(), names, renamed);
+    if (!renamed.empty()) {
+        std::memcpy(block + (fStop + 1) * sizeof(int) + proof.steps.size() * sizeof(DeltaStep), renamed.data(), renamed.size() * sizeof(int));
+    }
+    stored.checksum = checksum(stored, block, payloadBytes(stored));
+    std::memcpy(bytes.data(), &stored, sizeof(ProofCacheRecord));
+    CachedProof added{};
+    added.stepCount = (int) stored.stepCount;
+    added.correct = correct;
+#ifdef PROOF_CACHE_MMAP
+    for (int attempt = 0; attempt < 8; attempt++) {
+        int descriptor = ::open(path.c_str(), O_WRONLY | O_APPEND);
+        if (descriptor < 0 || flock(descriptor, LOCK_EX) != 0) {
+            if (descriptor >= 0) {
+                ::close(descriptor);
+            }
+            return false;
+        }
+        // A compaction that held the lock before may have put another file at the path
+        struct stat opened;
+        struct stat current;
+        if (fstat(descriptor, &opened) != 0 || stat(path.c_str(), &current) != 0
+            || opened.st_ino != current.st_ino || opened.st_dev != current.st_dev)
+        {
+            ::close(descriptor);
+            continue;
+        }
+        CachedProof known;
+        uint64_t offset;
+        if (!refresh() || (uint64_t) opened.st_ino != inode) {
+            ::close(descriptor);
+            continue;
+        }
+        if (find(canonical.data(), fStop, stored.hash, &known, &offset) && !better(added, known)) {
+            ::close(descriptor);
+            return true;
+        }
+        // No writer holds the lock, so a record that is cut short was left by a crash and is written over
+        bool written = scannedEnd == dataSize || ftruncate(descriptor, (off_t) scannedEnd) == 0;
+        size_t done = 0;
+        while (written && done < bytes.size()) {
+            ssize_t count = ::write(descriptor, bytes.data() + done, bytes.size() - done);
+            written = count > 0;
+            done += written ? (size_t) count : 0;
+        }
+        // Closing the file releases the lock
+        ::close(descriptor);
+        return written && refresh();
+    }
+    return false;
+#else
+    CachedProof known;
+    uint64_t offset;
+    if (!refresh()) {
+        return false;
+    }
+    if (find(canonical.data(), fStop, stored.hash, &known, &offset) && !better(added, known)) {
+        return true;
+    }
+    std::ofstream output(path, std::ios::binary | std::ios::app);
+    output.write((const char*) bytes.data(), (std::streamsize) bytes.size());
+    output.close();
+    return !output.fail() && refresh();
+#endif
+}
+
+inline bool ProofCache::compact() {
+    // Rewrites the file with the best record of each expression in the table and no appended records, into another
+    // file that is renamed over it. Processes that mapped the file keep reading it until they refresh
+    if (path.empty()) {
+        return false;
+    }
+#ifdef PROOF_CACHE_MMAP
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0 || flock(descriptor, LOCK_EX) != 0) {
+        if (descriptor >= 0) {
+            ::close(descriptor);
+        }
+        return false;
+    }
+    struct stat opened;
+    if (fstat(descriptor, &opened) != 0 || !refresh() || (uint64_t) opened.st_ino != inode) {
+        ::close(descriptor);
+        return false;
+    }
+#else
+    if (!refresh()) {
+        return false;
+    }
+#endif
+    // The best record of each expression, which find takes from the table and the appended records
+    std::vector<uint64_t> kept;
+    std::vector<uint64_t> keptHashes;
+    auto keep = [&](uint64_t offset) {
+        CachedProof proof;
+        CachedProof best;
+        uint64_t bestOffset;
+        ProofCacheRecord stored;
+        std::memcpy(&stored, data + offset, sizeof(ProofCacheRecord));
+        if (record(offset, &proof) && find(proof.formula, proof.fLength - 1, stored.hash, &best, &bestOffset) && bestOffset == offset) {
+            kept.push_back(offset);
+            keptHashes.push_back(stored.hash);
+        }
+    };
+    for (uint64_t slot = 0; slot < header.slotCount; slot++) {
+        if (slots[slot].offset != 0) {
+            keep(slots[slot].offset);
+        }
+    }
+    for (const auto& entry : appended) {
+        for (uint64_t offset : entry.second) {
+            keep(offset);
+        }
+    }
+    ProofCacheHeader compacted = header;
+    compacted.slotCount = 0;
+    if (!kept.empty()) {
+        // The table is at most half full, so that probes are short
+        compacted.slotCount = 1;
+        while (compacted.slotCount < 2 * kept.size()) {
+            compacted.slotCount *= 2;
+        }
+    }
+    compacted.formulaCount = kept.size();
+    std::vector<ProofCacheSlot> table((size_t) compacted.slotCount, ProofCacheSlot{0, 0});
+    uint64_t offset = sizeof(ProofCacheHeader) + compacted.slotCount * sizeof(ProofCacheSlot);
+    for (size_t i = 0; i < kept.size(); i++) {
+        ProofCacheRecord stored;
+        std::memcpy(&stored, data + kept[i], sizeof(ProofCacheRecord));
+        uint64_t slot = keptHashes[i] & (compacted.slotCount - 1);
+        while (table[slot].offset != 0) {
+            slot = (slot + 1) & (compacted.slotCount - 1);
+        }
+        table[slot] = ProofCacheSlot{keptHashes[i], offset};
+        offset += recordBytes(stored);
+    }
+    compacted.recordsEnd = offset;
+    std::string compactedPath = path + ".compacting";
+    std::ofstream output(compactedPath, std::ios::binary | std::ios::trunc);
+    output.write((const char*) &compacted, sizeof(ProofCacheHeader));
+    output.write((const char*) table.data(), (std::streamsize) (table.size() * sizeof(ProofCacheSlot)));
+    for (uint64_t keptOffset : kept) {
+        ProofCacheRecord stored;
+        std::memcpy(&stored, data + keptOffset, sizeof(ProofCacheRecord));
+        output.write((const char*) data + keptOffset, (std::streamsize) recordBytes(stored));
+    }
+    output.close();
+#ifndef PROOF_CACHE_MMAP
+    // Without POSIX, a file may not be renamed over another
+    unmap();
+    std::remove(path.c_str());
+#endif
+    bool renamedFile = !output.fail() && std::rename(compactedPath.c_str(), path.c_str()) == 0;
+    if (!renamedFile) {
+        std::remove(compactedPath.c_str());
+    }
+#ifdef PROOF_CACHE_MMAP
+    // Closing the old file releases the lock, and writers that were waiting for it see that the path has a new file
+    ::close(descriptor);
+#endif
+    return renamedFile && map();
+}
+
+#endif
@@ -0,0 +1,434 @@
+#ifndef PROOF_CORPUS_H
+#define PROOF_CORPUS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PROOF_CORPUS_MMAP
+#endif
+
+#include "DeltaProof.h"
+
+// Binary file of delta proofs, written once by a ProofCorpusWriter and read in place by a ProofCorpus.
+// The file has a header, then a block for each proof, then a directory with the offset of each block. A block has
+// the starting expression and STOP, the steps as DeltaStep records, and the inserted symbols of the steps, all of
+// them 32-bit integers in the byte order of the machine. The directory is last so that a writer streams blocks out
+// as proofs arrive and only keeps the directory, and so that a reader in proof order goes forward through the file
+
+class ProofCorpusHeader {
+    public:
+        uint32_t magic;
+        uint32_t version;
+        uint32_t lawCount; // Laws of the law set that the proofs use
+        uint32_t stepSize; // Bytes of a step record
+        uint64_t proofCount;
+        uint64_t directoryOffset;
+};
+
+class ProofCorpusEntry {
+    public:
+        uint64_t offset; // Offset of the block of the proof in the file
+        uint32_t fLength; // Symbols of the starting expression, without STOP
+        uint32_t stepCount;
+        uint32_t insertedLength;
+        int32_t target;
+};
+
+const uint32_t proofCorpusMagic = 0x43505342; // "BSPC"
+const uint32_t proofCorpusVersion = 1;
+
+// Proof of a corpus, which points into the file
+class CorpusProof {
+    public:
+        const int* formula; // Starting expression, followed by STOP
+        int fLength; // Symbols of the starting expression, with STOP
+        const DeltaStep* steps;
+        int stepCount;
+        const int* inserted;
+        int insertedLength;
+        int target;
+};
+
+class ProofCorpusWriter {
+    public:
+        ProofCorpusWriter();
+        ~ProofCorpusWriter();
+        ProofCorpusWriter(const ProofCorpusWriter&) = delete;
+        ProofCorpusWriter& operator=(const ProofCorpusWriter&) = delete;
+        bool open(const char* path, int lawCount);
+        bool add(const int formula[], int fLength, const DeltaProof& proof, int target);
+        bool close();
+    private:
+        std::ofstream output;
+        ProofCorpusHeader header;
+        std::vector<ProofCorpusEntry> directory;
+        uint64_t offset;
+};
+
+inline ProofCorpusWriter::ProofCorpusWriter() {
+    header = ProofCorpusHeader{};
+    offset = 0;
+}
+
+inline ProofCorpusWriter::~ProofCorpusWriter() {
+    close();
+}
+
+inline bool ProofCorpusWriter::open(const char* path, int lawCount) {
+    close();
+    output.open(path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        return false;
+    }
+    header.magic = proofCorpusMagic;
+    header.version = proofCorpusVersion;
+    header.lawCount = (uint32_t) lawCount;
+    header.stepSize = (uint32_t) sizeof(DeltaStep);
+    header.proofCount = 0;
+    header.directoryOffset = 0;
+    directory.clear();
+    // The header is written again with the counts when the corpus is closed
+    output.write((const char*) &header, sizeof(ProofCorpusHeader));
+    offset = sizeof(ProofCorpusHeader);
+    return (bool) output;
+}
+
+inline bool ProofCorpusWriter::add(const int formula[], int fLength, const DeltaProof& proof, int target) {
+    int fStop = findStop(formula, fLength);
+    if (!output.is_open() || fStop == fLength) {
+        return false;
+    }
+    ProofCorpusEntry entry;
+    entry.offset = offset;
+    entry.fLength = (uint32_t) fStop;
+    entry.stepCount = (uint32_t) proof.steps.size();
+    entry.insertedLength = (uint32_t) proof.inserted.size();
+    entry.target = target;
+    output.write((const char*) formula, (std::streamsize) ((fStop + 1) * sizeof(int)));
+    output.write((const char*) proof.steps.data(), (std::streamsize) (proof.steps.size() * sizeof(DeltaStep)));
+    output.write((const char*) proof.inserted.data(), (std::streamsize) (proof.inserted.size() * sizeof(int)));
+    offset += (fStop + 1) * sizeof(int) + proof.steps.size() * sizeof(DeltaStep) + proof.inserted.size() * sizeof(int);
+    directory.push_back(entry);
+    return (bool) output;
+}
+
+inline bool ProofCorpusWriter::close() {
+    if (!output.is_open()) {
+        return false;
+    }
+    // The blocks are a whole number of ints, and the directory starts at the next multiple of the alignment of its
+    // entries, which the reader checks
+    static const char padding[alignof(ProofCorpusEntry)] = {};
+    size_t paddingSize = (alignof(ProofCorpusEntry) - offset % alignof(ProofCorpusEntry)) % alignof(ProofCorpusEntry);
+    output.write(padding, (std::streamsize) paddingSize);
+    offset += paddingSize;
+    header.proofCount = directory.size();
+    header.directoryOffset = offset;
+    output.write((const char*) directory.data(), (std::streamsize) (directory.size() * sizeof(ProofCorpusEntry)));
+    output.seekp(0);
+    output.write((const char*) &header, sizeof(ProofCorpusHeader));
+    output.close();
+    directory.clear();
+    return !output.fail();
+}
+
+class ProofCorpus {
+    public:
+        ProofCorpus();
+        ~ProofCorpus();
+        ProofCorpus(const ProofCorpus&) = delete;
+        ProofCorpus& operator=(const ProofCorpus&) = delete;
+        bool open(const char* path);
+        bool attach(const uint8_t* image, size_t size);
+        void close();
+        size_t size() const;
+        int lawCount() const;
+        bool proof(size_t index, CorpusProof* result) const;
+        void advance(size_t index);
+    private:
+        // Bytes read ahead of the current proof, and bytes behind it that are kept
+        static constexpr size_t readAhead = 32 << 20;
+        static constexpr size_t keptBehind = 8 << 20;
+        const uint8_t* data;
+        size_t dataSize;
+        void* mapping; // Mapped file, or nullptr when the image was attached or read
+        std::vector<uint8_t> contents; // File contents when it cannot be mapped
+        ProofCorpusHeader header;
+        const ProofCorpusEntry* directory;
+        // Read ahead and dropped bytes of the blocks and of the directory
+        size_t advisedEnd[2];
+        size_t droppedEnd[2];
+        void advise(int region, size_t start, size_t end);
+};
+
+inline ProofCorpus::ProofCorpus() {
+    data = nullptr;
+    dataSize = 0;
+    mapping = nullptr;
+    header = ProofCorpusHeader{};
+    directory = nullptr;
+    advisedEnd[0] = advisedEnd[1] = 0;
+    droppedEnd[0] = droppedEnd[1] = 0;
+}
+
+inline ProofCorpus::~ProofCorpus() {
+    close();
+}
+
+inline bool ProofCorpus::open(const char* path) {
+    close();
+#ifdef PROOF_CORPUS_MMAP
+    int descriptor = ::open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        ::close(descriptor);
+        return false;
+    }
+    void* mapped = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    // The mapping stays valid after the file is closed
+    ::close(descriptor);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    if (!attach((const uint8_t*) mapped, (size_t) status.st_size)) {
+        munmap(mapped, (size_t) status.st_size);
+        return false;
+    }
+    mapping = mapped;
+    // Proofs are read in order, so the kernel may read ahead and drop pages that were read
+    madvise(mapped, (size_t) status.st_size, MADV_SEQUENTIAL);
+    return true;
+#else
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    contents.swap(bytes);
+    return attach(contents.data(), contents.size());
+#endif
+}
+
+inline bool ProofCorpus::attach(const uint8_t* image, size_t size) {
+    // The image must outlive the corpus, and be aligned to 8 bytes like a mapped file
+    if (size < sizeof(ProofCorpusHeader) || (uintptr_t) image % alignof(ProofCorpusEntry) != 0) {
+        return false;
+    }
+    ProofCorpusHeader stored;
+    std::memcpy(&stored, image, sizeof(ProofCorpusHeader));
+    if (stored.magic != proofCorpusMagic || stored.version != proofCorpusVersion || stored.stepSize != sizeof(DeltaStep)
+        || stored.directoryOffset < sizeof(ProofCorpusHeader) || stored.directoryOffset > size
+        || stored.directoryOffset % alignof(ProofCorpusEntry) != 0
+        || stored.proofCount != (size - stored.directoryOffset) / sizeof(ProofCorpusEntry)
+        || (size - stored.directoryOffset) % sizeof(ProofCorpusEntry) != 0) {
+        return false;
+    }
+    header = stored;
+    data = image;
+    dataSize = size;
+    directory = (const ProofCorpusEntry*) (image + header.directoryOffset);
+    advisedEnd[0] = sizeof(ProofCorpusHeader);
+    advisedEnd[1] = (size_t) header.directoryOffset;
+    droppedEnd[0] = 0;
+    droppedEnd[1] = (size_t) header.directoryOffset;
+    return true;
+}
+
+inline void ProofCorpus::close() {
+#ifdef PROOF_CORPUS_MMAP
+    if (mapping != nullptr) {
+        munmap(mapping, dataSize);
+    }
+#endif
+    mapping = nullptr;
+    contents.clear();
+    data = nullptr;
+    dataSize = 0;
+    header = ProofCorpusHeader{};
+    directory = nullptr;
+    advisedEnd[0] = advisedEnd[1] = 0;
+    droppedEnd[0] = droppedEnd[1] = 0;
+}
+
+inline size_t ProofCorpus::size() const {
+    return (size_t) header.proofCount;
+}
+
+inline int ProofCorpus::lawCount() const {
+    return (int) header.lawCount;
+}
+
+inline bool ProofCorpus::proof(size_t index, CorpusProof* result) const {
+    // A proof whose block is not within the blocks of the file is not read
+    if (index >= size()) {
+        return false;
+    }
+    const ProofCorpusEntry& entry = directory[index];
+    uint64_t blockBytes = ((uint64_t) entry.fLength + 1 + entry.insertedLength) * sizeof(int) + (uint64_t) entry.stepCount * sizeof(DeltaStep);
+    if (entry.offset < sizeof(ProofCorpusHeader) || entry.offset % sizeof(int) != 0 || entry.offset > header.directoryOffset
+        || blockBytes > header.directoryOffset - entry.offset || entry.fLength >= (uint32_t) INT32_MAX
+        || entry.stepCount > (uint32_t) INT32_MAX || entry.insertedLength > (uint32_t) INT32_MAX) {
+        return false;
+    }
+    const uint8_t* block = data + entry.offset;
+    result->formula = (const int*) block;
+    result->fLength = (int) entry.fLength + 1;
+    result->steps = (const DeltaStep*) (block + ((size_t) entry.fLength + 1) * sizeof(int));
+    result->stepCount = (int) entry.stepCount;
+    result->inserted = (const int*) (block + ((size_t) entry.fLength + 1) * sizeof(int) + (size_t) entry.stepCount * sizeof(DeltaStep));
+    result->insertedLength = (int) entry.insertedLength;
+    result->target = entry.target;
+    return true;
+}
+
+inline void ProofCorpus::advise(int region, size_t start, size_t end) {
+#ifdef PROOF_CORPUS_MMAP
+    // Pages up to readAhead bytes after start are read ahead, and pages more than keptBehind bytes before start
+    // are dropped from memory, both in large parts, so that reading the corpus takes bounded memory whatever its size
+    if (mapping == nullptr) {
+        return;
+    }
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    if (start + readAhead / 2 > advisedEnd[region] && advisedEnd[region] < end) {
+        size_t first = std::max(advisedEnd[region], start) / page * page;
+        size_t last = std::min(end, start + readAhead);
+        madvise((uint8_t*) mapping + first, last - first, MADV_WILLNEED);
+        advisedEnd[region] = last;
+    }
+    if (start > droppedEnd[region] + 2 * keptBehind) {
+        size_t first = droppedEnd[region] / page * page;
+        size_t last = (start - keptBehind) / page * page;
+        madvise((uint8_t*) mapping + first, last - first, MADV_DONTNEED);
+        droppedEnd[region] = last;
+    }
+#else
+    (void) region;
+    (void) start;
+    (void) end;
+#endif
+}
+
+inline void ProofCorpus::advance(size_t index) {
+    // Hints for reading the proofs from the index on, both their blocks and their entries of the directory
+    if (index >= size()) {
+        return;
+    }
+    advise(0, std::min((size_t) directory[index].offset, (size_t) header.directoryOffset), (size_t) header.directoryOffset);
+    advise(1, (size_t) header.directoryOffset + index * sizeof(ProofCorpusEntry), dataSize);
+}
+
+// Verdicts of the proofs of a corpus in a file, as a header and then a bit for each proof, which is 1 for a correct
+// proof, from the lowest bit of the first byte on. The verdicts are written as they come, through a small buffer
+class ProofVerdictHeader {
+    public:
+        uint32_t magic;
+        uint32_t version;
+        uint64_t proofCount;
+        uint64_t correctCount;
+};
+
+const uint32_t proofVerdictMagic = 0x56505342; // "BSPV"
+const uint32_t proofVerdictVersion = 1;
+
+class ProofVerdictWriter {
+    public:
+        ProofVerdictWriter();
+        ~ProofVerdictWriter();
+        ProofVerdictWriter(const ProofVerdictWriter&) = delete;
+        ProofVerdictWriter& operator=(const ProofVerdictWriter&) = delete;
+        bool open(const char* path);
+        void add(bool correct);
+        bool close();
+        uint64_t proofCount() const;
+        uint64_t correctCount() const;
+    private:
+        static constexpr size_t bufferSize = 1 << 16;
+        std::ofstream output;
+        ProofVerdictHeader header;
+        std::vector<uint8_t> buffer;
+        uint8_t bits; // Verdicts of the byte being filled
+        void flush();
+};
+
+inline ProofVerdictWriter::ProofVerdictWriter() {
+    header = ProofVerdictHeader{};
+    bits = 0;
+}
+
+inline ProofVerdictWriter::~ProofVerdictWriter() {
+    close();
+}
+
+inline bool ProofVerdictWriter::open(const char* path) {
+    close();
+    output.open(path, std::ios::binary | std::ios::trunc);
+    if (!output) {
+        return false;
+    }
+    header.magic = proofVerdictMagic;
+    header.version = proofVerdictVersion;
+    header.proofCount = 0;
+    header.correctCount = 0;
+    bits = 0;
+    buffer.clear();
+    buffer.reserve(bufferSize);
+    // The header is written again with the counts when the verdicts are closed
+    output.write((const char*) &header, sizeof(ProofVerdictHeader));
+    return (bool) output;
+}
+
+inline void ProofVerdictWriter::add(bool correct) {
+    if (correct) {
+        bits |= (uint8_t) (1 << (header.proofCount % 8));
+        header.correctCount++;
+    }
+    header.proofCount++;
+    if (header.proofCount % 8 == 0) {
+        buffer.push_back(bits);
+        bits = 0;
+        if (buffer.size() == bufferSize) {
+            flush();
+        }
+    }
+}
+
+inline void ProofVerdictWriter::flush() {
+    output.write((const char*) buffer.data(), (std::streamsize) buffer.size());
+    buffer.clear();
+}
+
+inline bool ProofVerdictWriter::close() {
+    if (!output.is_open()) {
+        return false;
+    }
+    if (header.proofCount % 8 != 0) {
+        buffer.push_back(bits);
+        bits = 0;
+    }
+    flush();
+    output.seekp(0);
+    output.write((const char*) &header, sizeof(ProofVerdictHeader));
+    output.close();
+    return !output.fail();
+}
+
+inline uint64_t ProofVerdictWriter::proofCount() const {
+    return header.proofCount;
+}
+
+inline uint64_t ProofVerdictWriter::correctCount() const {
+    return header.correctCount;
+}
+
+#endif
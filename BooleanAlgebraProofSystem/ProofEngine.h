@@ -0,0 +1,2367 @@
+#ifndef PROOF_ENGINE_H
+#define PROOF_ENGINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <istream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "SymbolKernels.h"
+
+// Proof checking engine shared by every law set, such as PE12L and PE21LF
+
+class Tuple {
+    public:
+        int law;
+        int* formula;
+        Tuple(int tupleLaw, int tupleFormula[]) {
+            law = tupleLaw;
+            formula = tupleFormula;
+        }
+};
+
+// Special symbols
+const int STOP = 0; // This indicates the end of a Boolean expression
+const int NOT = 1;
+const int OR = 2;
+const int AND = 3;
+const int FALSE = 4;
+const int TRUE = 5;
+const int minVariable = 6;
+
+// Law of a step that has not been identified yet
+const int noLaw = -1; // No law transforms the previous expression into the next expression
+const int unlabeled = -2; // The law of a step is identified while checking it
+
+// Added to a law of the law set other than substitution for a step that applies the law at every site where the
+// previous and next expressions differ, such as Tuple(identityOR + everySite, g)
+const int everySite = 1 << 24;
+
+inline bool isTruthValue(int symbol) {
+    return symbol == TRUE || symbol == FALSE;
+}
+
+inline bool isVariable(int symbol) {
+    return symbol > 5;
+}
+
+inline bool isBoolean(int symbol) {
+    return symbol > 3;
+}
+
+inline int firstDissimilarity(int f[], int g[], int fLength) {
+    int end = findStop(f, fLength);
+    int i = firstMismatch(f, g, end);
+    if (i == end || g[i] == STOP) {
+        // STOP must not be before a dissimilarity, and if there is none, both are identical
+        return -1;
+    }
+    // The index where both expressions first differ
+    return i;
+}
+
+inline int indexOfStop(int f[], int fLength) {
+    int i = findStop(f, fLength);
+    return i < fLength ? i : -1;
+}
+
+// A Boolean expression stored with 8 or 16 bits per symbol and an explicit length instead of a STOP symbol,
+// which points to symbols owned elsewhere like the formula of a Tuple
+template <class Symbol>
+class CompactFormula {
+    static_assert(sizeof(Symbol) <= 2 && Symbol(-1) > 0, "Compact symbols are unsigned 8 or 16-bit integers");
+    public:
+        const Symbol* symbols;
+        int length; // Number of symbols, which is the index of STOP in the expression
+        CompactFormula(const Symbol* formulaSymbols, int formulaLength) {
+            symbols = formulaSymbols;
+            length = formulaLength;
+        }
+};
+
+template <class Symbol>
+class CompactTuple {
+    public:
+        int law;
+        CompactFormula<Symbol> formula;
+        CompactTuple(int tupleLaw, CompactFormula<Symbol> tupleFormula) : formula(tupleFormula) {
+            law = tupleLaw;
+        }
+};
+
+// Appends the symbols of a Boolean expression before STOP to the storage of compact expressions,
+// and returns its length, or -1 if it has no STOP or a symbol does not fit.
+// CompactFormula objects must point into the storage only once it stops growing
+template <class Symbol>
+inline int appendCompactFormula(const int f[], int fLength, std::vector<Symbol>& storage) {
+    int length = findStop(f, fLength);
+    if (length == fLength) {
+        return -1;
+    }
+    for (int i = 0; i < length; i++) {
+        if (f[i] < 0 || f[i] > (int) Symbol(-1)) {
+            return -1;
+        }
+    }
+    storage.insert(storage.end(), f, f + length);
+    return length;
+}
+
+// A proof that owns its starting expression and the expression of every step, one after the other with STOP in one
+// arena of symbols, where each expression is found by its offset and length. The arena ends with as many STOP
+// symbols as the longest expression has, so that the checker reads within the arena after any expression
+class ProofArena {
+    public:
+        ProofArena();
+        ProofArena(ProofArena&&) noexcept = default;
+        ProofArena& operator=(ProofArena&&) noexcept = default;
+        ProofArena(const ProofArena&) = delete;
+        ProofArena& operator=(const ProofArena&) = delete;
+        void reserve(size_t symbolCount, int stepCount);
+        void clear();
+        bool setFormula(const int f[], int fLength);
+        bool addStep(int law, const int g[], int gLength);
+        int length() const;
+        const int* formula() const;
+        int formulaLength() const;
+        int law(int step) const;
+        const int* stepFormula(int step) const;
+        int stepLength(int step) const;
+    private:
+        class Entry {
+            public:
+                int law;
+                int length; // Symbols of the expression, which is the index of its STOP
+                size_t offset;
+        };
+        std::vector<int> symbols;
+        std::vector<Entry> entries; // The starting expression and then the expression of each step
+        size_t end; // Offset of the STOP symbols after the last expression
+        int longest; // Symbols of the longest expression with STOP
+        bool append(int law, const int f[], int fLength);
+};
+
+inline ProofArena::ProofArena() {
+    end = 0;
+    longest = 0;
+}
+
+inline void ProofArena::reserve(size_t symbolCount, int stepCount) {
+    // Symbols of every expression with STOP, and those of the longest expression again for the STOP symbols
+    // at the end, so that building the proof takes no other allocation of symbols
+    symbols.reserve(symbolCount);
+    entries.reserve((size_t) stepCount + 1);
+}
+
+inline void ProofArena::clear() {
+    symbols.clear();
+    entries.clear();
+    end = 0;
+    longest = 0;
+}
+
+inline bool ProofArena::append(int law, const int f[], int fLength) {
+    int stop = findStop(f, fLength);
+    if (stop == fLength) {
+        return false;
+    }
+    // The expression takes the place of the first STOP symbols at the end, which are then extended
+    longest = std::max(longest, stop + 1);
+    symbols.resize(end + stop + 1 + longest, STOP);
+    std::copy(f, f + stop, symbols.begin() + end);
+    symbols[end + stop] = STOP;
+    entries.push_back(Entry{law, stop, end});
+    end += stop + 1;
+    return true;
+}
+
+inline bool ProofArena::setFormula(const int f[], int fLength) {
+    clear();
+    return append(noLaw, f, fLength);
+}
+
+inline bool ProofArena::addStep(int law, const int g[], int gLength) {
+    return !entries.empty() && append(law, g, gLength);
+}
+
+inline int ProofArena::length() const {
+    return entries.empty() ? 0 : (int) entries.size() - 1;
+}
+
+inline const int* ProofArena::formula() const {
+    return symbols.data();
+}
+
+inline int ProofArena::formulaLength() const {
+    return entries.empty() ? 0 : entries[0].length;
+}
+
+inline int ProofArena::law(int step) const {
+    return entries[step + 1].law;
+}
+
+inline const int* ProofArena::stepFormula(int step) const {
+    return symbols.data() + entries[step + 1].offset;
+}
+
+inline int ProofArena::stepLength(int step) const {
+    return entries[step + 1].length;
+}
+
+// Subtree spans of one Boolean expression, so that the end of the operand at any index is found in constant time
+class FormulaSpanIndex {
+    public:
+        int stop; // Index of the STOP symbol, or -1 if there is none
+        FormulaSpanIndex() {
+            stop = -1;
+        }
+        void build(const int f[], int fLength) {
+            // One pass back from STOP with a stack of the subtrees that have no parent yet, where each operator
+            // takes as many of them as its arity
+            stop = findStop(f, fLength);
+            if (stop == fLength) {
+                stop = -1;
+                return;
+            }
+            spans.assign(stop, 0);
+            parents.assign(stop, -1);
+            roots.clear();
+            for (int i = stop - 1; i >= 0; i--) {
+                int arity = f[i] == NOT ? 1 : f[i] == OR || f[i] == AND ? 2 : 0;
+                bool complete = isBoolean(f[i]) || arity > 0;
+                int span = 1;
+                for (int k = 0; k < arity; k++) {
+                    if (roots.empty()) {
+                        // The operator has too few operands
+                        complete = false;
+                        break;
+                    }
+                    int child = roots.back();
+                    roots.pop_back();
+                    parents[child] = i;
+                    complete = complete && spans[child] > 0;
+                    span += spans[child];
+                }
+                spans[i] = complete ? span : 0;
+                roots.push_back(i);
+            }
+        }
+        int span(int i) const {
+            // Symbols of the subtree at index i, or 0 if it is not a whole Polish expression
+            return spans[i];
+        }
+        int parent(int i) const {
+            // Index of the operator that has the subtree at index i as an operand, or -1 for none
+            return parents[i];
+        }
+    private:
+        std::vector<int> spans;
+        std::vector<int> parents;
+        std::vector<int> roots;
+};
+
+// Operands of the laws
+const int symbolOperands = 0; // Each operand 'a', 'b' or 'c' of a law is a Boolean symbol
+const int subtreeOperands = 1; // Each operand of a law other than substitution is a whole Polish subtree
+
+// Occurrence count and sub-expression of a variable in use
+class VariableRecord {
+    public:
+        int name;
+        int count; // Variable occurrence count
+        int type; // Type of sub-expression: 0 for none, 1 for -a, OR for a + b, AND for a * b
+        int a; // 'a' in -a or a + b or a * b
+        int b; // 'b' in a + b or a * b
+};
+
+// Type of a journal record for a variable that was not in use
+const int absentVariable = -1;
+
+// Variables in use, remapped to dense ids that index one pooled array of records,
+// so that no step allocates memory once the table has grown to the size of a proof.
+// With a journal, every record that may change is saved to the journal first, so that undo can restore the table
+class VariableTable {
+    public:
+        VariableTable() {
+            slots.assign(64, -1);
+            size = 0;
+            journal = nullptr;
+        }
+        bool contains(int variableName) const {
+            return slots[slotOf(variableName)] >= 0;
+        }
+        VariableRecord* find(int variableName) {
+            int id = slots[slotOf(variableName)];
+            if (id >= 0 && journal != nullptr) {
+                // The caller may change the record through the pointer
+                journal->push_back(records[id]);
+            }
+            return id < 0 ? nullptr : &records[id];
+        }
+        VariableRecord* insert(int variableName, int count, int type, int a, int b) {
+            if (journal != nullptr) {
+                journal->push_back(VariableRecord{variableName, 0, absentVariable, 0, 0});
+            }
+            if ((size + 1) * 2 > (int) slots.size()) {
+                grow();
+            }
+            int id;
+            if (freeIds.empty()) {
+                id = (int) records.size();
+                records.push_back(VariableRecord());
+            } else {
+                id = freeIds.back();
+                freeIds.pop_back();
+            }
+            records[id] = VariableRecord{variableName, count, type, a, b};
+            slots[slotOf(variableName)] = id;
+            size++;
+            return &records[id];
+        }
+        void erase(int variableName) {
+            int slot = slotOf(variableName);
+            if (slots[slot] < 0) {
+                return;
+            }
+            if (journal != nullptr) {
+                journal->push_back(records[slots[slot]]);
+            }
+            freeIds.push_back(slots[slot]);
+            slots[slot] = -1;
+            size--;
+            // Shift back the following records of the probe sequence so that no lookup stops early
+            int mask = (int) slots.size() - 1;
+            int next = (slot + 1) & mask;
+            while (slots[next] >= 0) {
+                int home = homeSlot(records[slots[next]].name);
+                if (((next - home) & mask) >= ((next - slot) & mask)) {
+                    slots[slot] = slots[next];
+                    slots[next] = -1;
+                    slot = next;
+                }
+                next = (next + 1) & mask;
+            }
+        }
+        void clear() {
+            std::fill(slots.begin(), slots.end(), -1);
+            records.clear();
+            freeIds.clear();
+            size = 0;
+        }
+        void save(std::vector<VariableRecord>& saved) const {
+            // Records in use, in increasing order of name, so that equal tables save equal records
+            saved.clear();
+            for (int id : slots) {
+                if (id >= 0) {
+                    saved.push_back(records[id]);
+                }
+            }
+            std::sort(saved.begin(), saved.end(), [](const VariableRecord& x, const VariableRecord& y) { return x.name < y.name; });
+        }
+        void restore(const VariableRecord* saved, int count) {
+            clear();
+            for (int i = 0; i < count; i++) {
+                insert(saved[i].name, saved[i].count, saved[i].type, saved[i].a, saved[i].b);
+            }
+        }
+        void setJournal(std::vector<VariableRecord>* changes) {
+            journal = changes;
+        }
+        void undo(size_t mark) {
+            // Restores the records of the journal from the end down to the mark, which leaves the table as it
+            // was when the journal had mark records
+            std::vector<VariableRecord>* changes = journal;
+            journal = nullptr;
+            while (changes->size() > mark) {
+                VariableRecord saved = changes->back();
+                changes->pop_back();
+                int id = slots[slotOf(saved.name)];
+                if (saved.type == absentVariable) {
+                    erase(saved.name);
+                } else if (id >= 0) {
+                    records[id] = saved;
+                } else {
+                    insert(saved.name, saved.count, saved.type, saved.a, saved.b);
+                }
+            }
+            journal = changes;
+        }
+    private:
+        std::vector<int> slots; // Open addressing from variable name to dense id, or -1 for an empty slot
+        std::vector<VariableRecord> records; // Records indexed by dense id
+        std::vector<int> freeIds; // Dense ids of erased records, reused before the pool grows
+        int size;
+        std::vector<VariableRecord>* journal; // Records before each change, or nullptr for none
+        int homeSlot(int variableName) const {
+            uint32_t hash = (uint32_t) variableName * 2654435769u;
+            return (int) (hash >> 8) & ((int) slots.size() - 1);
+        }
+        int slotOf(int variableName) const {
+            // Linear probing until the variable or an empty slot is found
+            int mask = (int) slots.size() - 1;
+            int slot = homeSlot(variableName);
+            while (slots[slot] >= 0 && records[slots[slot]].name != variableName) {
+                slot = (slot + 1) & mask;
+            }
+            return slot;
+        }
+        void grow() {
+            std::vector<int> oldSlots;
+            oldSlots.swap(slots);
+            slots.assign(oldSlots.size() * 2, -1);
+            for (int id : oldSlots) {
+                if (id >= 0) {
+                    slots[slotOf(records[id].name)] = id;
+                }
+            }
+        }
+};
+
+// Changes to the variables in use that a step makes, which can be recorded while the structure of steps is checked
+// out of order and made in order afterwards
+const int incrementEffect = 0; // One more occurrence of the variable
+const int decrementEffect = 1; // One less occurrence of the variable and of its sub-expression
+const int releaseEffect = 2; // One less occurrence of the variable only
+const int defineEffect = 3; // The variable must be new, and represents the sub-expression
+const int requireEffect = 4; // The variable must represent the sub-expression
+
+class VariableEffect {
+    public:
+        int kind;
+        int variable;
+        int type; // Type, 'a' and 'b' of the sub-expression of defineEffect and requireEffect
+        int a;
+        int b;
+};
+
+// Matchers that a law set can use for its laws
+const int identityMatcher = 0; // a + 0 = a, a * 1 = a
+const int idempotentMatcher = 1; // a + a = a, a * a = a
+const int commutativeMatcher = 2; // a + b = b + a, a * b = b * a
+const int associativeMatcher = 3; // a + (b + c) = (a + b) + c, a * (b * c) = (a * b) * c
+const int distributiveMatcher = 4; // a + (b * c) = (a + b) * (a + c), a * (b + c) = (a * b) + (a * c)
+const int deMorganMatcher = 5; // -(a + b) = -a * -b, -(a * b) = -a + -b
+const int complementMatcher = 6; // a + -a = 1, a * -a = 0
+const int dominationMatcher = 7; // a + 1 = 1, a * 0 = 0
+const int absorptionMatcher = 8; // a + (a * b) = a, a * (a + b) = a
+const int doubleNegationMatcher = 9; // -(-a) = a
+const int negationMatcher = 10; // -1 = 0, -0 = 1
+const int substitutionMatcher = 11; // -a = x, a + b = x, a * b = x
+
+// Forms of a law, which is the operator that it applies to
+const int bothForms = -1; // OR or AND, for laws without forms
+
+// A law of a law set is a matcher restricted to a form
+class LawRule {
+    public:
+        int matcher;
+        int form;
+};
+
+// Bit i is set if the matcher can change the length of an expression by i or -i symbols
+constexpr int lengthChangesOf(int matcher) {
+    return matcher == commutativeMatcher || matcher == associativeMatcher ? 1 << 0
+        : matcher == deMorganMatcher || matcher == negationMatcher ? 1 << 1
+        : matcher == substitutionMatcher ? 1 << 1 | 1 << 2
+        : matcher == complementMatcher ? 1 << 3
+        : matcher == absorptionMatcher ? 1 << 4
+        : 1 << 2;
+}
+
+// Pattern variables of a rewrite rule, each of which stands for one Boolean like the operands of the built-in laws
+const int maxPatternVariables = 16;
+
+// Kinds of steps of a compiled rewrite rule
+const int matchSymbolStep = 0; // The symbol must be the given symbol
+const int bindVariableStep = 1; // The symbol must be a Boolean, which is bound to the pattern variable
+const int matchVariableStep = 2; // The symbol must be the Boolean that is bound to the pattern variable
+
+// One check of a compiled rewrite rule at a position of the rewritten part of the previous or next expression
+class RuleStep {
+    public:
+        int kind;
+        bool inNext; // The position is in the next expression instead of the previous expression
+        int position; // Position from the start of the rewritten part
+        int value; // Symbol for matchSymbolStep, pattern variable otherwise
+};
+
+// Change in the occurrence count of the Boolean bound to a pattern variable when a rewrite rule is applied
+class RuleCountChange {
+    public:
+        int variable;
+        int change;
+};
+
+// A rewrite rule applied in one direction, as ranges of the flat tables of a rule set
+class RuleDirection {
+    public:
+        int rule;
+        int previousLength; // Length of the rewritten part in the previous expression
+        int nextLength; // Length of the rewritten part in the next expression
+        int minLead; // Fewest symbols of the rewritten part that can be before the first dissimilarity
+        int maxLead; // Most symbols of the rewritten part that can be before the first dissimilarity
+        int firstStep;
+        int stepCount;
+        int firstChange;
+        int changeCount;
+};
+
+// A rule direction to try at the first dissimilarity, with the number of symbols of the rewritten part before it
+class RuleCandidate {
+    public:
+        int direction;
+        int lead;
+};
+
+// User-defined rewrite rules loaded at run time, one rule per line:
+//     name: lhs = rhs
+// where both sides are Polish expressions in the symbol encoding of the engine (1 for NOT, 2 for OR, 3 for AND,
+// 4 for FALSE, 5 for TRUE, 6 and above for variables) and pattern variables are names starting with a letter.
+// Everything after '#' is a comment. For example, the consensus law a * b + -a * c + b * c = a * b + -a * c is
+//     consensus: 2 2 3 a b 3 1 a c 3 b c = 2 3 a b 3 1 a c
+// Each rule is compiled into flat tables of steps for both directions, and the directions are indexed by the
+// change in length and the symbol at the first dissimilarity, so that steps only try the rules that can apply
+class RuleSet {
+    public:
+        RuleSet();
+        bool load(const char* path);
+        bool parse(std::istream& input);
+        bool addRule(const std::string& line);
+        int size() const;
+        int indexOf(const std::string& name) const;
+        int errorLine() const;
+        int longestSideLength() const;
+    private:
+        friend class LawEngine;
+        std::vector<std::string> names;
+        std::vector<RuleDirection> directions;
+        std::vector<RuleStep> steps;
+        std::vector<RuleCountChange> changes;
+        // Candidates of each change in length and symbol class, from -maxLengthChange to maxLengthChange
+        std::vector<std::vector<RuleCandidate>> candidates;
+        int maxLengthChange;
+        int longestSide; // Most symbols of a side of a rule
+        int failedLine; // Line of the first rule that could not be compiled, or 0
+        bool parseSide(std::istringstream& tokens, std::vector<int>& side, std::vector<std::string>& variableNames, bool* reachedEquals);
+        void compileDirection(int rule, const std::vector<int>& previous, const std::vector<int>& next, int variableCount);
+        void indexDirection(int direction, const std::vector<int>& previous, const std::vector<int>& next);
+        const std::vector<RuleCandidate>* candidatesAt(int lengthChange, int symbol) const;
+};
+
+// Pattern variables are stored in the sides of a rule as negative numbers
+inline bool isPatternVariable(int symbol) {
+    return symbol < 0;
+}
+
+inline int patternVariableOf(int symbol) {
+    return -symbol - 1;
+}
+
+inline int symbolClassOf(int symbol) {
+    // NOT, OR, AND, FALSE, TRUE and every variable are the 6 classes of symbols at a dissimilarity
+    return std::min(symbol, minVariable) - 1;
+}
+
+inline bool isPolishExpression(const std::vector<int>& side) {
+    // Each operator needs as many operands as its arity, and the last operand completes the expression
+    int needed = 1;
+    for (int symbol : side) {
+        if (needed == 0) {
+            return false;
+        }
+        if (symbol == NOT) {
+            continue;
+        }
+        needed += symbol == OR || symbol == AND ? 1 : -1;
+    }
+    return needed == 0;
+}
+
+inline RuleSet::RuleSet() {
+    maxLengthChange = 0;
+    longestSide = 0;
+    failedLine = 0;
+}
+
+inline bool RuleSet::load(const char* path) {
+    std::ifstream input(path);
+    if (!input) {
+        failedLine = 0;
+        return false;
+    }
+    return parse(input);
+}
+
+inline bool RuleSet::parse(std::istream& input) {
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        lineNumber++;
+        std::string::size_type comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            // Blank line
+            continue;
+        }
+        if (!addRule(line)) {
+            failedLine = lineNumber;
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool RuleSet::parseSide(std::istringstream& tokens, std::vector<int>& side, std::vector<std::string>& variableNames, bool* reachedEquals) {
+    std::string token;
+    *reachedEquals = false;
+    while (tokens >> token) {
+        if (token == "=") {
+            *reachedEquals = true;
+            return true;
+        }
+        if (std::isdigit((unsigned char) token[0])) {
+            if (token.find_first_not_of("0123456789") != std::string::npos || token.size() > 9) {
+                return false;
+            }
+            int symbol = std::stoi(token);
+            if (symbol == STOP) {
+                // STOP only ends a Boolean expression
+                return false;
+            }
+            side.push_back(symbol);
+        } else if (std::isalpha((unsigned char) token[0])) {
+            int variable = (int) (std::find(variableNames.begin(), variableNames.end(), token) - variableNames.begin());
+            if (variable == (int) variableNames.size()) {
+                if (variable == maxPatternVariables) {
+                    return false;
+                }
+                variableNames.push_back(token);
+            }
+            side.push_back(-variable - 1);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline bool RuleSet::addRule(const std::string& line) {
+    std::string::size_type colon = line.find(':');
+    if (colon == std::string::npos) {
+        return false;
+    }
+    std::istringstream nameTokens(line.substr(0, colon));
+    std::string name, extra;
+    if (!(nameTokens >> name) || nameTokens >> extra || indexOf(name) >= 0) {
+        // A rule needs one name that no other rule has
+        return false;
+    }
+    std::istringstream tokens(line.substr(colon + 1));
+    std::vector<int> lhs, rhs;
+    std::vector<std::string> variableNames;
+    bool reachedEquals;
+    if (!parseSide(tokens, lhs, variableNames, &reachedEquals) || !reachedEquals) {
+        return false;
+    }
+    if (!parseSide(tokens, rhs, variableNames, &reachedEquals) || reachedEquals) {
+        return false;
+    }
+    if (!isPolishExpression(lhs) || !isPolishExpression(rhs) || lhs == rhs) {
+        // Both sides must be single different Polish expressions
+        return false;
+    }
+    int rule = (int) names.size();
+    names.push_back(name);
+    longestSide = std::max(longestSide, (int) std::max(lhs.size(), rhs.size()));
+    // Two-way, like the built-in laws
+    compileDirection(rule, lhs, rhs, (int) variableNames.size());
+    compileDirection(rule, rhs, lhs, (int) variableNames.size());
+    return true;
+}
+
+inline void RuleSet::compileDirection(int rule, const std::vector<int>& previous, const std::vector<int>& next, int variableCount) {
+    RuleDirection direction;
+    direction.rule = rule;
+    direction.previousLength = (int) previous.size();
+    direction.nextLength = (int) next.size();
+    // The rewritten part starts before the first dissimilarity by as many symbols as both sides can have in common
+    int shortest = std::min(direction.previousLength, direction.nextLength);
+    int lead = 0;
+    while (lead < shortest && previous[lead] == next[lead]) {
+        lead++;
+    }
+    direction.minLead = lead;
+    while (lead < shortest && (previous[lead] == next[lead]
+        || ((isPatternVariable(previous[lead]) || isBoolean(previous[lead]))
+            && (isPatternVariable(next[lead]) || isBoolean(next[lead])))))
+    {
+        // Both symbols are equal, or the same Boolean for some pattern variables, such as the AND between the
+        // variables of a * (b * c) = b * (c * a) when a and b are the same Boolean
+        lead++;
+    }
+    direction.maxLead = std::min(lead, shortest - 1);
+    // Symbols first, since they are the cheapest to reject, then pattern variables in the order they are bound
+    direction.firstStep = (int) steps.size();
+    for (int side = 0; side < 2; side++) {
+        const std::vector<int>& symbols = side == 0 ? previous : next;
+        for (int i = 0; i < (int) symbols.size(); i++) {
+            if (!isPatternVariable(symbols[i])) {
+                steps.push_back(RuleStep{matchSymbolStep, side == 1, i, symbols[i]});
+            }
+        }
+    }
+    std::vector<int> occurrences(2 * variableCount, 0);
+    for (int side = 0; side < 2; side++) {
+        const std::vector<int>& symbols = side == 0 ? previous : next;
+        for (int i = 0; i < (int) symbols.size(); i++) {
+            if (isPatternVariable(symbols[i])) {
+                int variable = patternVariableOf(symbols[i]);
+                bool bound = occurrences[variable] + occurrences[variableCount + variable] > 0;
+                steps.push_back(RuleStep{bound ? matchVariableStep : bindVariableStep, side == 1, i, variable});
+                occurrences[side * variableCount + variable]++;
+            }
+        }
+    }
+    direction.stepCount = (int) steps.size() - direction.firstStep;
+    // Occurrences of each bound Boolean are added or removed by the difference between both sides
+    direction.firstChange = (int) changes.size();
+    for (int variable = 0; variable < variableCount; variable++) {
+        int change = occurrences[variableCount + variable] - occurrences[variable];
+        if (change != 0) {
+            changes.push_back(RuleCountChange{variable, change});
+        }
+    }
+    direction.changeCount = (int) changes.size() - direction.firstChange;
+    directions.push_back(direction);
+    indexDirection((int) directions.size() - 1, previous, next);
+}
+
+inline void RuleSet::indexDirection(int index, const std::vector<int>& previous, const std::vector<int>& next) {
+    const RuleDirection& direction = directions[index];
+    int lengthChange = direction.previousLength - direction.nextLength;
+    if (std::abs(lengthChange) > maxLengthChange) {
+        // Widen the index, keeping the candidates of every change in length
+        int oldMaxLengthChange = maxLengthChange;
+        std::vector<std::vector<RuleCandidate>> oldCandidates;
+        oldCandidates.swap(candidates);
+        maxLengthChange = std::abs(lengthChange);
+        candidates.resize((2 * maxLengthChange + 1) * 6);
+        for (int i = 0; i < (int) oldCandidates.size(); i++) {
+            candidates[i + (maxLengthChange - oldMaxLengthChange) * 6].swap(oldCandidates[i]);
+        }
+    }
+    if (candidates.empty()) {
+        candidates.resize(6);
+    }
+    for (int lead = direction.minLead; lead <= direction.maxLead; lead++) {
+        int symbol = previous[lead];
+        if (symbol == next[lead]) {
+            // Both expressions have the same symbol here, so the first dissimilarity cannot be here
+            continue;
+        }
+        int bucket = (lengthChange + maxLengthChange) * 6;
+        if (isPatternVariable(symbol)) {
+            // A pattern variable matches any Boolean
+            candidates[bucket + symbolClassOf(FALSE)].push_back(RuleCandidate{index, lead});
+            candidates[bucket + symbolClassOf(TRUE)].push_back(RuleCandidate{index, lead});
+            candidates[bucket + symbolClassOf(minVariable)].push_back(RuleCandidate{index, lead});
+        } else {
+            candidates[bucket + symbolClassOf(symbol)].push_back(RuleCandidate{index, lead});
+        }
+    }
+}
+
+inline const std::vector<RuleCandidate>* RuleSet::candidatesAt(int lengthChange, int symbol) const {
+    if (std::abs(lengthChange) > maxLengthChange || candidates.empty()) {
+        return nullptr;
+    }
+    return &candidates[(lengthChange + maxLengthChange) * 6 + symbolClassOf(symbol)];
+}
+
+inline int RuleSet::size() const {
+    return (int) names.size();
+}
+
+inline int RuleSet::indexOf(const std::string& name) const {
+    for (int i = 0; i < (int) names.size(); i++) {
+        if (names[i] == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+inline int RuleSet::errorLine() const {
+    return failedLine;
+}
+
+inline int RuleSet::longestSideLength() const {
+    return longestSide;
+}
+
+template <int form>
+inline bool isForm(int symbol) {
+    if (form == bothForms) {
+        return symbol == OR || symbol == AND;
+    }
+    return symbol == form;
+}
+
+inline int otherOperator(int symbol) {
+    return symbol == OR ? AND : OR;
+}
+
+inline int identityElement(int symbol) {
+    // a + 0 = a, a * 1 = a
+    return symbol == OR ? FALSE : TRUE;
+}
+
+inline int dominatingElement(int symbol) {
+    // a + 1 = 1, a * 0 = 0
+    return symbol == OR ? TRUE : FALSE;
+}
+
+// Swaps OR and AND, and TRUE and FALSE, which turns the form of a law for OR into its form for AND
+inline int dualSymbol(int symbol) {
+    return symbol == OR ? AND : symbol == AND ? OR : symbol == TRUE ? FALSE : symbol == FALSE ? TRUE : symbol;
+}
+
+// Both sides of the form for OR of a law over subtrees, where 'a', 'b' and 'c' are pattern variables
+class LawPattern {
+    public:
+        int previousLength;
+        int previous[7];
+        int nextLength;
+        int next[7];
+};
+
+// Pattern of every matcher except substitution, indexed by matcher
+constexpr LawPattern lawPatterns[substitutionMatcher] = {
+    {3, {OR, -1, FALSE}, 1, {-1}}, // + a 0 = a
+    {3, {OR, -1, -1}, 1, {-1}}, // + a a = a
+    {3, {OR, -1, -2}, 3, {OR, -2, -1}}, // + a b = + b a
+    {5, {OR, -1, OR, -2, -3}, 5, {OR, OR, -1, -2, -3}}, // + a + b c = + + a b c
+    {5, {OR, -1, AND, -2, -3}, 7, {AND, OR, -1, -2, OR, -1, -3}}, // + a * b c = * + a b + a c
+    {4, {NOT, OR, -1, -2}, 5, {AND, NOT, -1, NOT, -2}}, // - + a b = * - a - b
+    {4, {OR, -1, NOT, -1}, 1, {TRUE}}, // + a - a = 1
+    {3, {OR, -1, TRUE}, 1, {TRUE}}, // + a 1 = 1
+    {5, {OR, -1, AND, -1, -2}, 1, {-1}}, // + a * a b = a
+    {3, {NOT, NOT, -1}, 1, {-1}}, // - - a = a
+    {2, {NOT, TRUE}, 1, {FALSE}} // - 1 = 0
+};
+
+// Operand of a law over subtrees, which is bound to a subtree of the previous or next expression
+class SubtreeOperand {
+    public:
+        bool inNext;
+        int start;
+        int length;
+};
+
+// State and matchers that do not depend on the law set, so that each thread can own a separate engine
+class LawEngine {
+    public:
+        LawEngine();
+        LawEngine(const LawEngine&) = delete;
+        LawEngine& operator=(const LawEngine&) = delete;
+        void setOperandMode(int mode);
+        VariableTable& variables();
+        void storeInitialVariables(const int formula[]);
+        template <class Symbol> void storeInitialVariables(CompactFormula<Symbol> formula);
+        void setRules(const RuleSet* ruleSet);
+        bool applyEffects(const VariableEffect stepEffects[], int effectCount);
+    protected:
+        // Boolean matrix for suffix matching
+        bool sameSuffixMatrix[8][8];
+        bool computedSuffixMatrix[8][8];
+        int computedSuffixList[14][2];
+        int computedSuffixCount;
+        // Table to store variables
+        VariableTable variablesInUse;
+        // Subtree spans of the previous and next expressions, which are swapped between steps of a proof
+        int operandMode;
+        FormulaSpanIndex previousSpans;
+        FormulaSpanIndex nextSpans;
+        // Rewrite rules that are checked after the laws of the law set, or nullptr for none
+        const RuleSet* rules;
+        // Changes to the variables in use that are recorded instead of made, or nullptr to make them
+        std::vector<VariableEffect>* effects;
+        // While a step is matched at each of its sites, sameSuffix only bounds the rewritten parts and keeps their
+        // lengths, and the changes to the variables in use wait until every site matches
+        bool siteMatching;
+        int siteSuffixAtF;
+        int siteSuffixAtG;
+        std::vector<VariableEffect> siteEffects;
+        // Compact expressions of the current step, of which only the symbols around the dissimilarity are copied
+        // into int windows for the matchers, while suffixes are compared in place
+        int compactWidth; // Bytes per symbol of the compact expressions, or 0 when checking int expressions
+        const void* compactPrevious;
+        const void* compactNext;
+        int windowStart; // Index in both compact expressions of the first symbol of the windows
+        std::vector<int> previousWindow;
+        std::vector<int> nextWindow;
+        void buildIndexes(int f[], int g[], int fLength);
+        void buildNextIndex(int g[], int fLength);
+        bool locateDissimilarity(int f[], int g[], int fLength, int* fStop, int* gStop, int* s);
+        bool sameSuffix(int f[], int g[], int fLength, int fStop, int gStop, int s, int suffixAtF, int suffixAtG);
+        bool suffixesMatch(int f[], int g[], int fStop, int gStop, int i, int j);
+        template <class Symbol> bool loadWindows(CompactFormula<Symbol> f, CompactFormula<Symbol> g, int* fStop, int* gStop, int* s);
+        void resetSuffixes();
+        void incrementVariableCount(int variableName);
+        void decrementVariableCount(int variableName, bool cascading);
+        bool isNewVariable(int variableName);
+        bool isDefinedAs(int variableName, int type, int a, int b);
+        void defineVariable(int variableName, int type, int a, int b);
+        void requireDefinition(int variableName, int type, int a, int b);
+        template <int form> bool isIdentity(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int form> bool isIdempotent(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int form> bool isCommutative(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int form> bool isAssociative(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int form> bool isDistributive(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int form> bool isDeMorgan(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int form> bool isComplement(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int form> bool isDomination(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int form> bool isAbsorption(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        bool isDoubleNegation(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        bool isNegation(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        bool isSubstitution(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        bool sameSubtrees(int f[], int g[], const SubtreeOperand& x, const SubtreeOperand& y);
+        bool matchPatternSide(int f[], int g[], bool inNext, int root, const int pattern[], int patternLength, bool dual, SubtreeOperand operands[], bool bound[]);
+        bool isSubtreeLaw(const LawRule& law, int f[], int g[], int fStop, int gStop, int s);
+        bool isRewrite(const RuleCandidate& candidate, int f[], int g[], int fStop, int gStop, int s);
+        bool isRuleTransformation(int rule, int f[], int g[], int fStop, int gStop, int s);
+        int identifyRule(int f[], int g[], int fStop, int gStop, int s);
+};
+
+inline LawEngine::LawEngine() {
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            sameSuffixMatrix[i][j] = false;
+            computedSuffixMatrix[i][j] = false;
+        }
+    }
+    computedSuffixCount = 0;
+    operandMode = symbolOperands;
+    rules = nullptr;
+    effects = nullptr;
+    siteMatching = false;
+    siteSuffixAtF = 0;
+    siteSuffixAtG = 0;
+    compactWidth = 0;
+    compactPrevious = nullptr;
+    compactNext = nullptr;
+    windowStart = 0;
+}
+
+inline void LawEngine::setOperandMode(int mode) {
+    // Subtree operands apply to int expressions, while compact expressions keep symbol operands
+    operandMode = mode;
+}
+
+inline void LawEngine::buildIndexes(int f[], int g[], int fLength) {
+    if (operandMode == subtreeOperands) {
+        previousSpans.build(f, fLength);
+        nextSpans.build(g, fLength);
+    }
+}
+
+inline void LawEngine::buildNextIndex(int g[], int fLength) {
+    if (operandMode == subtreeOperands) {
+        // The next expression of the previous step is the previous expression of this step
+        std::swap(previousSpans, nextSpans);
+        nextSpans.build(g, fLength);
+    }
+}
+
+inline bool LawEngine::locateDissimilarity(int f[], int g[], int fLength, int* fStop, int* gStop, int* s) {
+    *s = firstDissimilarity(f, g, fLength);
+    *fStop = indexOfStop(f, fLength);
+    *gStop = indexOfStop(g, fLength);
+    if (*s < 0) {
+        // Both Boolean expressions must differ somewhere
+        return false;
+    }
+    if (*fStop < 0 || *gStop < 0) {
+        // There must be a STOP symbol at the end of a Boolean expression
+        return false;
+    }
+    return true;
+}
+
+inline bool LawEngine::sameSuffix(int f[], int g[], int fLength, int fStop, int gStop, int s, int suffixAtF, int suffixAtG) {
+    if (siteMatching) {
+        // The symbols after a site are compared by the pass over both expressions, up to the next site
+        siteSuffixAtF = suffixAtF;
+        siteSuffixAtG = suffixAtG;
+        return s + suffixAtF <= fStop && s + suffixAtG <= gStop;
+    }
+    if (computedSuffixMatrix[suffixAtF][suffixAtG]) {
+        // Reuse computed Boolean
+        return sameSuffixMatrix[suffixAtF][suffixAtG];
+    }
+    // Keep track of the pair of suffix indices
+    computedSuffixMatrix[suffixAtF][suffixAtG] = true;
+    computedSuffixList[computedSuffixCount][0] = suffixAtF;
+    computedSuffixList[computedSuffixCount][1] = suffixAtG;
+    computedSuffixCount++;
+    // Preemptively set the result to false
+    sameSuffixMatrix[suffixAtF][suffixAtG] = false;
+    // Compare the suffix of both Boolean expressions
+    int i = s + suffixAtF;
+    int j = s + suffixAtG;
+    if (i >= fLength || j >= fLength || i > fStop || j > gStop) {
+        // A suffix must be within a Boolean expression
+        return false;
+    }
+    int difference = suffixAtF - suffixAtG;
+    if ((difference >= 0 && gStop + difference != fStop) || (difference < 0 && fStop + (suffixAtG - suffixAtF) != gStop)) {
+        // The ends of both expressions do not correspond correctly
+        return false;
+    }
+    if (!suffixesMatch(f, g, fStop, gStop, i, j)) {
+        return false;
+    }
+    // The first changed parts of the expressions are the only changed parts
+    sameSuffixMatrix[suffixAtF][suffixAtG] = true;
+    return true;
+}
+
+inline bool LawEngine::suffixesMatch(int f[], int g[], int fStop, int gStop, int i, int j) {
+    // Compare the symbols from index i of the previous expression and index j of the next expression
+    if (compactWidth != 0) {
+        // The windows only hold the symbols around the dissimilarity, so compare the compact expressions in place
+        int length = std::min(fStop - i, gStop - j);
+        i += windowStart;
+        j += windowStart;
+        if (compactWidth == 1) {
+            return rangesEqual((const uint8_t*) compactPrevious + i, (const uint8_t*) compactNext + j, length);
+        }
+        return rangesEqual((const uint16_t*) compactPrevious + i, (const uint16_t*) compactNext + j, length);
+    }
+    // There must be no extra changes after the first changed parts of the expressions
+    return rangesEqual(f + i, g + j, std::min(fStop - i, gStop - j));
+}
+
+// The only 14 pairs of suffix indices that need to be checked:
+// sameSuffixMatrix[1][2]
+// sameSuffixMatrix[1][3]
+// sameSuffixMatrix[1][4]
+// sameSuffixMatrix[1][5]
+// sameSuffixMatrix[2][1]
+// sameSuffixMatrix[2][2]
+// sameSuffixMatrix[3][1]
+// sameSuffixMatrix[4][1]
+// sameSuffixMatrix[4][4]
+// sameSuffixMatrix[4][5]
+// sameSuffixMatrix[5][1]
+// sameSuffixMatrix[5][4]
+// sameSuffixMatrix[5][7]
+// sameSuffixMatrix[7][5]
+
+inline void LawEngine::resetSuffixes() {
+    int suffixAtF, suffixAtG;
+    while (computedSuffixCount > 0) {
+        computedSuffixCount--;
+        suffixAtF = computedSuffixList[computedSuffixCount][0];
+        suffixAtG = computedSuffixList[computedSuffixCount][1];
+        computedSuffixMatrix[suffixAtF][suffixAtG] = false;
+    }
+}
+
+inline VariableTable& LawEngine::variables() {
+    return variablesInUse;
+}
+
+inline void LawEngine::incrementVariableCount(int variableName) {
+    if (!isVariable(variableName)) {
+        return;
+    }
+    if (effects != nullptr) {
+        effects->push_back(VariableEffect{incrementEffect, variableName, 0, 0, 0});
+        return;
+    }
+    VariableRecord* subExpression = variablesInUse.find(variableName);
+    if (subExpression == nullptr) {
+        subExpression = variablesInUse.insert(variableName, 0, 0, 0, 0); // {variable occurrence count, type of sub-expression}
+    }
+    subExpression->count++;
+    int type = subExpression->type;
+    int a = subExpression->a;
+    int b = subExpression->b;
+    if (type >= 1) { // The sub-expression is -a
+        incrementVariableCount(a); // 'a' in -a or a + b or a * b
+        if (type >= 2) { // The sub-expression is a + b or a * b
+            incrementVariableCount(b); // 'b' in a + b or a * b
+        }
+    }
+}
+
+inline void LawEngine::decrementVariableCount(int variableName, bool cascading) {
+    if (effects != nullptr) {
+        effects->push_back(VariableEffect{cascading ? decrementEffect : releaseEffect, variableName, 0, 0, 0});
+        return;
+    }
+    VariableRecord* subExpression = variablesInUse.find(variableName);
+    if (subExpression == nullptr) {
+        return;
+    }
+    subExpression->count--;
+    if (cascading && subExpression->type >= 1) { // The sub-expression is -a
+        decrementVariableCount(subExpression->a, true); // 'a' in -a or a + b or a * b
+        if (subExpression->type >= 2) { // The sub-expression is a + b or a * b
+            decrementVariableCount(subExpression->b, true); // 'b' in a + b or a * b
+        }
+    }
+    if (subExpression->count <= 0) { // Variable occurrence count is 0
+        variablesInUse.erase(variableName);
+    }
+}
+
+inline bool LawEngine::isNewVariable(int variableName) {
+    // While effects are recorded, this is only known when they are made
+    return effects != nullptr || !variablesInUse.contains(variableName);
+}
+
+inline bool LawEngine::isDefinedAs(int variableName, int type, int a, int b) {
+    // While effects are recorded, this is only known when they are made
+    if (effects != nullptr) {
+        return true;
+    }
+    VariableRecord* subExpression = variablesInUse.find(variableName);
+    return subExpression != nullptr && subExpression->type == type && subExpression->a == a && (type < 2 || subExpression->b == b);
+}
+
+inline void LawEngine::defineVariable(int variableName, int type, int a, int b) {
+    if (effects != nullptr) {
+        effects->push_back(VariableEffect{defineEffect, variableName, type, a, b});
+        return;
+    }
+    variablesInUse.insert(variableName, 1, type, a, b); // {variable occurrence count, type of sub-expression, a, b}
+}
+
+inline void LawEngine::requireDefinition(int variableName, int type, int a, int b) {
+    // The check of isDefinedAs that was postponed while effects are recorded
+    if (effects != nullptr) {
+        effects->push_back(VariableEffect{requireEffect, variableName, type, a, b});
+    }
+}
+
+inline bool LawEngine::applyEffects(const VariableEffect stepEffects[], int effectCount) {
+    // Makes the recorded changes of a step in order. A substitution that does not hold leaves the variables
+    // unchanged, since its definition or requirement is the first change of its step
+    for (int i = 0; i < effectCount; i++) {
+        const VariableEffect& effect = stepEffects[i];
+        if (effect.kind == incrementEffect) {
+            incrementVariableCount(effect.variable);
+        } else if (effect.kind == decrementEffect || effect.kind == releaseEffect) {
+            decrementVariableCount(effect.variable, effect.kind == decrementEffect);
+        } else if (effect.kind == defineEffect) {
+            if (!isNewVariable(effect.variable)) {
+                return false;
+            }
+            defineVariable(effect.variable, effect.type, effect.a, effect.b);
+        } else if (!isDefinedAs(effect.variable, effect.type, effect.a, effect.b)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void LawEngine::storeInitialVariables(const int formula[]) {
+    variablesInUse.clear();
+    int i = 0;
+    while (formula[i] != STOP) {
+        incrementVariableCount(formula[i]);
+        i++;
+    }
+}
+
+template <class Symbol>
+void LawEngine::storeInitialVariables(CompactFormula<Symbol> formula) {
+    variablesInUse.clear();
+    for (int i = 0; i < formula.length; i++) {
+        incrementVariableCount(formula.symbols[i]);
+    }
+}
+
+template <class Symbol>
+bool LawEngine::loadWindows(CompactFormula<Symbol> f, CompactFormula<Symbol> g, int* fStop, int* gStop, int* s) {
+    int shortest = std::min(f.length, g.length);
+    int dissimilarity = firstMismatch(f.symbols, g.symbols, shortest);
+    if (dissimilarity == shortest) {
+        // Both Boolean expressions must differ before either ends
+        return false;
+    }
+    // The laws look back by 1 symbol and ahead by at most 8 symbols, and rules by up to the length of a side
+    int lookBehind = std::max(1, rules == nullptr ? 0 : rules->longestSide);
+    int lookAhead = std::max(8, rules == nullptr ? 0 : rules->longestSide) + 1;
+    int windowLength = lookBehind + lookAhead;
+    windowStart = dissimilarity - std::min(dissimilarity, lookBehind);
+    previousWindow.resize(windowLength);
+    nextWindow.resize(windowLength);
+    for (int i = 0; i < windowLength; i++) {
+        int position = windowStart + i;
+        previousWindow[i] = position < f.length ? f.symbols[position] : STOP;
+        nextWindow[i] = position < g.length ? g.symbols[position] : STOP;
+    }
+    compactWidth = (int) sizeof(Symbol);
+    compactPrevious = f.symbols;
+    compactNext = g.symbols;
+    *fStop = f.length - windowStart;
+    *gStop = g.length - windowStart;
+    *s = dissimilarity - windowStart;
+    return true;
+}
+
+inline void LawEngine::setRules(const RuleSet* ruleSet) {
+    rules = ruleSet;
+}
+
+inline bool LawEngine::isRewrite(const RuleCandidate& candidate, int f[], int g[], int fStop, int gStop, int s) {
+    const RuleDirection& direction = rules->directions[candidate.direction];
+    int start = s - candidate.lead;
+    if (start < 0 || start + direction.previousLength > fStop || start + direction.nextLength > gStop
+        || fStop - gStop != direction.previousLength - direction.nextLength)
+    {
+        // The rewritten parts must be within both expressions and leave suffixes of the same length
+        return false;
+    }
+    int bound[maxPatternVariables];
+    const RuleStep* step = rules->steps.data() + direction.firstStep;
+    const RuleStep* lastStep = step + direction.stepCount;
+    for (; step < lastStep; step++) {
+        int symbol = step->inNext ? g[start + step->position] : f[start + step->position];
+        if (step->kind == matchSymbolStep) {
+            if (symbol != step->value) {
+                return false;
+            }
+        } else if (step->kind == bindVariableStep) {
+            if (!isBoolean(symbol)) {
+                // A pattern variable is a Boolean
+                return false;
+            }
+            bound[step->value] = symbol;
+        } else if (symbol != bound[step->value]) {
+            return false;
+        }
+    }
+    if (!suffixesMatch(f, g, fStop, gStop, start + direction.previousLength, start + direction.nextLength)) {
+        // There are extra changes after the rewritten parts of the expressions
+        return false;
+    }
+    const RuleCountChange* change = rules->changes.data() + direction.firstChange;
+    const RuleCountChange* lastChange = change + direction.changeCount;
+    for (; change < lastChange; change++) {
+        for (int i = 0; i < change->change; i++) {
+            incrementVariableCount(bound[change->variable]);
+        }
+        for (int i = 0; i > change->change; i--) {
+            decrementVariableCount(bound[change->variable], true);
+        }
+    }
+    return true;
+}
+
+inline bool LawEngine::isRuleTransformation(int rule, int f[], int g[], int fStop, int gStop, int s) {
+    if (rules == nullptr || rule >= rules->size()) {
+        return false;
+    }
+    // Both directions of the rule, with every number of symbols of the rewritten part before the dissimilarity
+    for (int index = 2 * rule; index < 2 * rule + 2; index++) {
+        const RuleDirection& direction = rules->directions[index];
+        for (int lead = direction.minLead; lead <= direction.maxLead; lead++) {
+            if (isRewrite(RuleCandidate{index, lead}, f, g, fStop, gStop, s)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+inline int LawEngine::identifyRule(int f[], int g[], int fStop, int gStop, int s) {
+    if (rules == nullptr) {
+        return -1;
+    }
+    const std::vector<RuleCandidate>* candidates = rules->candidatesAt(fStop - gStop, f[s]);
+    if (candidates == nullptr) {
+        return -1;
+    }
+    for (const RuleCandidate& candidate : *candidates) {
+        if (isRewrite(candidate, f, g, fStop, gStop, s)) {
+            return rules->directions[candidate.direction].rule;
+        }
+    }
+    return -1;
+}
+
+template <int form>
+bool LawEngine::isIdentity(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: a + 0 = a, a * 1 = a
+    // Polish: + a 0 = a, * a 1 = a
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 3, 1)
+        && isForm<form>(f[s]) && f[s + 2] == identityElement(f[s]) // _ + 0, _ * 1
+        && isBoolean(f[s + 1]) // 'a' is a Boolean
+        && g[s] == f[s + 1]) // _ = a
+    {
+        return true;
+    }
+    // Infix: a = a + 0, a = a * 1
+    // Polish: a = + a 0, a = * a 1
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 1, 3)
+        && isForm<form>(g[s]) && g[s + 2] == identityElement(g[s]) // _ + 0, _ * 1
+        && isBoolean(g[s + 1]) // 'a' is a Boolean
+        && f[s] == g[s + 1]) // a = _
+    {
+        return true;
+    }
+    // No identity law detected
+    return false;
+}
+
+template <int form>
+bool LawEngine::isIdempotent(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: a + a = a, a * a = a
+    // Polish: + a a = a, * a a = a
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 3, 1)
+        && isForm<form>(f[s]) // OR or AND in the previous expression
+        && isBoolean(f[s + 1]) // 'a' is a Boolean
+        && f[s + 1] == f[s + 2] // Both operands are 'a' in the previous expression
+        && g[s] == f[s + 1]) // The changed part in the next expression is 'a'
+    {
+        decrementVariableCount(g[s], true);
+        return true;
+    }
+    // Infix: a = a + a, a = a * a
+    // Polish: a = + a a, a = * a a
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 1, 3)
+        && isForm<form>(g[s]) // OR or AND in the next expression
+        && isBoolean(g[s + 1]) // 'a' is a Boolean
+        && g[s + 1] == g[s + 2] // Both operands are 'a' in the next expression
+        && f[s] == g[s + 1]) // The changed part in the previous expression is 'a'
+    {
+        incrementVariableCount(f[s]);
+        return true;
+    }
+    // No idempotent law detected
+    return false;
+}
+
+template <int form>
+bool LawEngine::isCommutative(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    if (s < 1) {
+        // Not enough room to step back
+        return false;
+    }
+    // Infix: a + b = b + a, a * b = b * a
+    // Polish: + a b = + b a, * a b = * b a
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 2, 2)
+        && isForm<form>(f[s - 1]) // OR or AND in the previous expression
+        && f[s - 1] == g[s - 1] // Same operator in both expressions
+        && isBoolean(f[s]) && isBoolean(f[s + 1]) // 'a' and 'b' are Booleans
+        && f[s] == g[s + 1] && f[s + 1] == g[s]) // 'a' and 'b' are swapped
+    {
+        return true;
+    }
+    // No commutative law detected
+    return false;
+}
+
+template <int form>
+bool LawEngine::isAssociative(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    if (s < 1) {
+        // Not enough room to step back
+        return false;
+    }
+    // Infix: a + (b + c) = (a + b) + c, a * (b * c) = (a * b) * c
+    // Polish: + a + b c = + + a b c, * a * b c = * * a b c
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 4, 4)
+        && isForm<form>(f[s - 1]) // First OR or AND in the previous expression
+        && f[s - 1] == g[s - 1] // First OR or AND in both expressions
+        && isBoolean(f[s]) // 'a' is a Boolean
+        && f[s - 1] == f[s + 1] // Second OR or AND
+        && isBoolean(f[s + 2]) && isBoolean(f[s + 3]) // 'b' and 'c' are Booleans
+        && f[s] == g[s + 1] && f[s + 1] == g[s] // 'a' and the operator are swapped
+        && f[s + 2] == g[s + 2] && f[s + 3] == g[s + 3]) // 'b' and 'c' are not swapped
+    {
+        return true;
+    }
+    // Infix: (a + b) + c = a + (b + c), (a * b) * c = a * (b * c)
+    // Polish: + + a b c = + a + b c, * * a b c = * a * b c
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 4, 4)
+        && isForm<form>(g[s - 1]) // First OR or AND in the next expression
+        && g[s - 1] == f[s - 1] // First OR or AND in both expressions
+        && isBoolean(g[s]) // 'a' is a Boolean
+        && g[s - 1] == g[s + 1] // Second OR or AND
+        && isBoolean(g[s + 2]) && isBoolean(g[s + 3]) // 'b' and 'c' are Booleans
+        && g[s] == f[s + 1] && g[s + 1] == f[s] // 'a' and the operator are swapped
+        && g[s + 2] == f[s + 2] && g[s + 3] == f[s + 3]) // 'b' and 'c' are not swapped
+    {
+        return true;
+    }
+    // No associative law detected
+    return false;
+}
+
+template <int form>
+bool LawEngine::isDistributive(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: a + (b * c) = (a + b) * (a + c), a * (b + c) = (a * b) + (a * c)
+    // Polish: + a * b c = * + a b + a c, * a + b c = + * a b * a c
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 5, 7)
+        && isForm<form>(f[s]) && f[s + 2] == otherOperator(f[s]) // OR and AND in the previous expression
+        && isBoolean(f[s + 1]) // 'a' is a Boolean
+        && isBoolean(f[s + 3]) && isBoolean(f[s + 4]) // 'b' and 'c' are Booleans
+        && f[s + 2] == g[s] // Other operator in the next expression
+        && f[s] == g[s + 1] // First OR or AND in the next expression
+        && g[s + 1] == g[s + 4] // Second OR or AND in the next expression
+        && f[s + 1] == g[s + 2] && f[s + 3] == g[s + 3] && f[s + 1] == g[s + 5] && f[s + 4] == g[s + 6]) // _ = (a + b) * (a + c), _ = (a * b) + (a * c)
+    {
+        incrementVariableCount(f[s + 1]);
+        return true;
+    }
+    // Infix: (a + b) * (a + c) = a + (b * c), (a * b) + (a * c) = a * (b + c)
+    // Polish: * + a b + a c = + a * b c, + * a b * a c = * a + b c
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 7, 5)
+        && isForm<form>(g[s]) && g[s + 2] == otherOperator(g[s]) // OR and AND in the next expression
+        && isBoolean(g[s + 1]) // 'a' is a Boolean
+        && isBoolean(g[s + 3]) && isBoolean(g[s + 4]) // 'b' and 'c' are Booleans
+        && g[s + 2] == f[s] // Other operator in the previous expression
+        && g[s] == f[s + 1] // First OR or AND in the previous expression
+        && f[s + 1] == f[s + 4] // Second OR or AND in the previous expression
+        && g[s + 1] == f[s + 2] && g[s + 3] == f[s + 3] && g[s + 1] == f[s + 5] && g[s + 4] == f[s + 6]) // (a + b) * (a + c) = _, (a * b) + (a * c) = _
+    {
+        decrementVariableCount(g[s + 1], true);
+        return true;
+    }
+    // No distributive law detected
+    return false;
+}
+
+template <int form>
+bool LawEngine::isDeMorgan(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: -(a + b) = -a * -b, -(a * b) = -a + -b
+    // Polish: - + a b = * - a - b, - * a b = + - a - b
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 4, 5)
+        && f[s] == NOT // NOT in the previous expression
+        && isForm<form>(f[s + 1]) && g[s] == otherOperator(f[s + 1]) // OR or AND in the previous expression and other operator in the next expression
+        && isBoolean(f[s + 2]) && isBoolean(f[s + 3]) // 'a' and 'b' are Booleans
+        && g[s + 1] == NOT && f[s + 2] == g[s + 2] // -a
+        && g[s + 3] == NOT && f[s + 3] == g[s + 4]) // -b
+    {
+        return true;
+    }
+    // Infix: -a * -b = -(a + b), -a + -b = -(a * b)
+    // Polish: * - a - b = - + a b, + - a - b = - * a b
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 5, 4)
+        && g[s] == NOT // NOT in the next expression
+        && isForm<form>(g[s + 1]) && f[s] == otherOperator(g[s + 1]) // OR or AND in the next expression and other operator in the previous expression
+        && isBoolean(g[s + 2]) && isBoolean(g[s + 3]) // 'a' and 'b' are Booleans
+        && f[s + 1] == NOT && g[s + 2] == f[s + 2] // -a
+        && f[s + 3] == NOT && g[s + 3] == f[s + 4]) // -b
+    {
+        return true;
+    }
+    // No De Morgan's law detected
+    return false;
+}
+
+template <int form>
+bool LawEngine::isComplement(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: a + -a = 1, a * -a = 0
+    // Polish: + a - a = 1, * a - a = 0
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 4, 1)
+        && isForm<form>(f[s]) && g[s] == dominatingElement(f[s]) // OR or AND in the previous expression and TRUE or FALSE in the next expression
+        && isBoolean(f[s + 1]) // 'a' is a Boolean
+        && f[s + 2] == NOT // NOT in the previous expression
+        && f[s + 1] == f[s + 3]) // -a
+    {
+        decrementVariableCount(f[s + 1], true);
+        decrementVariableCount(f[s + 1], true);
+        return true;
+    }
+    // Infix: 1 = a + -a, 0 = a * -a
+    // Polish: 1 = + a - a, 0 = * a - a
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 1, 4)
+        && isForm<form>(g[s]) && f[s] == dominatingElement(g[s]) // OR or AND in the next expression and TRUE or FALSE in the previous expression
+        && isBoolean(g[s + 1]) // 'a' is a Boolean
+        && g[s + 2] == NOT // NOT in the next expression
+        && g[s + 1] == g[s + 3]) // -a
+    {
+        incrementVariableCount(g[s + 1]);
+        incrementVariableCount(g[s + 1]);
+        return true;
+    }
+    // No complement law detected
+    return false;
+}
+
+template <int form>
+bool LawEngine::isDomination(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: a + 1 = 1, a * 0 = 0
+    // Polish: + a 1 = 1, * a 0 = 0
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 3, 1)
+        && isForm<form>(f[s]) && f[s + 2] == dominatingElement(f[s]) // OR or AND, and TRUE or FALSE, in the previous expression
+        && isBoolean(f[s + 1]) // 'a' is a Boolean
+        && g[s] == f[s + 2]) // TRUE or FALSE in the next expression
+    {
+        decrementVariableCount(f[s + 1], true);
+        return true;
+    }
+    // Infix: 1 = a + 1, 0 = a * 0
+    // Polish: 1 = + a 1, 0 = * a 0
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 1, 3)
+        && isForm<form>(g[s]) && g[s + 2] == dominatingElement(g[s]) // OR or AND, and TRUE or FALSE, in the next expression
+        && isBoolean(g[s + 1]) // 'a' is a Boolean
+        && f[s] == g[s + 2]) // TRUE or FALSE in the previous expression
+    {
+        incrementVariableCount(g[s + 1]);
+        return true;
+    }
+    // No domination law detected
+    return false;
+}
+
+template <int form>
+bool LawEngine::isAbsorption(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: a + (a * b) = a, a * (a + b) = a
+    // Polish: + a * a b = a, * a + a b = a
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 5, 1)
+        && isForm<form>(f[s]) && f[s + 2] == otherOperator(f[s]) // OR and AND in the previous expression
+        && isBoolean(f[s + 1]) // 'a' is a Boolean
+        && f[s + 1] == f[s + 3] // Second 'a' in the previous expression
+        && isBoolean(f[s + 4]) // 'b' is a Boolean
+        && g[s] == f[s + 1]) // The changed part in the next expression is 'a'
+    {
+        decrementVariableCount(g[s], true);
+        decrementVariableCount(f[s + 4], true);
+        return true;
+    }
+    // Infix: a = a + (a * b), a = a * (a + b)
+    // Polish: a = + a * a b, a = * a + a b
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 1, 5)
+        && isForm<form>(g[s]) && g[s + 2] == otherOperator(g[s]) // OR and AND in the next expression
+        && isBoolean(g[s + 1]) // 'a' is a Boolean
+        && g[s + 1] == g[s + 3] // Second 'a' in the next expression
+        && isBoolean(g[s + 4]) // 'b' is a Boolean
+        && f[s] == g[s + 1]) // The changed part in the previous expression is 'a'
+    {
+        incrementVariableCount(f[s]);
+        incrementVariableCount(g[s + 4]);
+        return true;
+    }
+    // No absorption law detected
+    return false;
+}
+
+inline bool LawEngine::isDoubleNegation(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: -(-a) = a
+    // Polish: - - a = a
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 3, 1)
+        && f[s] == NOT // First NOT in the previous expression
+        && f[s + 1] == NOT // Second NOT in the previous expression
+        && isBoolean(f[s + 2]) // 'a' is a Boolean
+        && g[s] == f[s + 2]) // The changed part in the next expression is just 'a'
+    {
+        return true;
+    }
+    // Infix: a = -(-a)
+    // Polish: a = - - a
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 1, 3)
+        && g[s] == NOT // First NOT in the next expression
+        && g[s + 1] == NOT // Second NOT in the next expression
+        && isBoolean(g[s + 2]) // 'a' is a Boolean
+        && f[s] == g[s + 2]) // The changed part in the previous expression is just 'a'
+    {
+        return true;
+    }
+    // No double negation law detected
+    return false;
+}
+
+inline bool LawEngine::isNegation(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: -1 = 0, -0 = 1
+    // Polish: - 1 = 0, - 0 = 1
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 2, 1)
+        && f[s] == NOT // NOT in the previous expression
+        && ((f[s + 1] == TRUE && g[s] == FALSE) // -1 = 0
+            || (f[s + 1] == FALSE && g[s] == TRUE))) // -0 = 1
+    {
+        return true;
+    }
+    // Infix: 0 = -1, 1 = -0
+    // Polish: 0 = - 1, 1 = - 0
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 1, 2)
+        && g[s] == NOT // NOT in the next expression
+        && ((g[s + 1] == TRUE && f[s] == FALSE) // 0 = -1
+            || (g[s + 1] == FALSE && f[s] == TRUE))) // 1 = -0
+    {
+        return true;
+    }
+    // No negation detected
+    return false;
+}
+
+inline bool LawEngine::isSubstitution(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    // Infix: -a = x
+    // Polish: - a = x
+    if (sameSuffix(f, g, fLength, fStop, gStop, s, 2, 1)
+        && f[s] == NOT && isBoolean(f[s + 1]) // -a = _
+        && isVariable(g[s]) && isNewVariable(g[s])) // 'x' is a new Boolean variable
+    {
+        defineVariable(g[s], 1, f[s + 1], 0); // {type of sub-expression, a}
+        return true;
+    }
+    // Infix: x = -a
+    // Polish: x = - a
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 1, 2)
+        && g[s] == NOT && isBoolean(g[s + 1]) // _ = -a
+        && isDefinedAs(f[s], 1, g[s + 1], 0)) // 'x' is a pre-existing Boolean variable that represents the correct sub-expression
+    {
+        requireDefinition(f[s], 1, g[s + 1], 0);
+        decrementVariableCount(f[s], false);
+        return true;
+    }
+    // Infix: a + b = x, a * b = x
+    // Polish: + a b = x, * a b = x
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 3, 1)
+        && (f[s] == OR || f[s] == AND) // OR or AND in the previous expression
+        && isBoolean(f[s + 1]) && isBoolean(f[s + 2]) // 'a' and 'b' are Booleans
+        && isVariable(g[s]) && isNewVariable(g[s])) // 'x' is a new Boolean variable
+    {
+        defineVariable(g[s], f[s], f[s + 1], f[s + 2]); // {type of sub-expression, a, b}
+        return true;
+    }
+    // Infix: x = a + b, x = a * b
+    // Polish: x = + a b, x = * a b
+    else if (sameSuffix(f, g, fLength, fStop, gStop, s, 1, 3)
+        && (g[s] == OR || g[s] == AND) // OR or AND in the next expression
+        && isBoolean(g[s + 1]) && isBoolean(g[s + 2]) // _ = a + b, _ = a * b
+        && isDefinedAs(f[s], g[s], g[s + 1], g[s + 2])) // 'x' is a pre-existing Boolean variable that represents the correct sub-expression
+    {
+        requireDefinition(f[s], g[s], g[s + 1], g[s + 2]);
+        decrementVariableCount(f[s], false);
+        return true;
+    }
+    // No substitution detected
+    return false;
+}
+
+inline bool LawEngine::sameSubtrees(int f[], int g[], const SubtreeOperand& x, const SubtreeOperand& y) {
+    // Subtrees of the same length are compared symbol by symbol
+    if (x.length != y.length) {
+        return false;
+    }
+    return rangesEqual((x.inNext ? g : f) + x.start, (y.inNext ? g : f) + y.start, x.length);
+}
+
+inline bool LawEngine::matchPatternSide(int f[], int g[], bool inNext, int root, const int pattern[], int patternLength, bool dual, SubtreeOperand operands[], bool bound[]) {
+    // The symbols of the pattern must be at the subtree from the root, where each pattern variable takes one
+    // whole subtree, which must be the same subtree as every other occurrence of the variable
+    const int* h = inNext ? g : f;
+    const FormulaSpanIndex& spans = inNext ? nextSpans : previousSpans;
+    int position = root;
+    for (int i = 0; i < patternLength; i++) {
+        if (!isPatternVariable(pattern[i])) {
+            if (h[position] != (dual ? dualSymbol(pattern[i]) : pattern[i])) {
+                return false;
+            }
+            position++;
+            continue;
+        }
+        int variable = patternVariableOf(pattern[i]);
+        SubtreeOperand operand{inNext, position, spans.span(position)};
+        if (bound[variable] && !sameSubtrees(f, g, operands[variable], operand)) {
+            return false;
+        }
+        operands[variable] = operand;
+        bound[variable] = true;
+        position += operand.length;
+    }
+    return true;
+}
+
+inline bool LawEngine::isSubtreeLaw(const LawRule& law, int f[], int g[], int fStop, int gStop, int s) {
+    // The law rewrites the subtree at an operator that contains the first dissimilarity, so each operator on the
+    // path from the dissimilarity to the root of the previous expression is tried from the deepest one up, where
+    // both subtrees must leave the same suffix
+    if (previousSpans.stop != fStop || nextSpans.stop != gStop) {
+        return false;
+    }
+    const LawPattern& pattern = lawPatterns[law.matcher];
+    int common = -1; // Symbols at the ends of both expressions that are the same, measured once
+    for (int root = s; root >= 0; root = previousSpans.parent(root)) {
+        int fEnd = root + previousSpans.span(root);
+        int gEnd = root + nextSpans.span(root);
+        if (fEnd == root || gEnd == root || fStop - fEnd != gStop - gEnd) {
+            continue;
+        }
+        if (common < 0) {
+            common = 0;
+            int longest = std::min(fStop, gStop) - s;
+            while (common < longest && f[fStop - 1 - common] == g[gStop - 1 - common]) {
+                common++;
+            }
+        }
+        if (fStop - fEnd > common) {
+            continue;
+        }
+        // The form for OR, its dual for AND, and both sides of the law in either direction
+        for (int dual = law.form == AND; dual <= (law.form != OR); dual++) {
+            for (int direction = 0; direction < 2; direction++) {
+                const int* previous = direction == 0 ? pattern.previous : pattern.next;
+                const int* next = direction == 0 ? pattern.next : pattern.previous;
+                int previousLength = direction == 0 ? pattern.previousLength : pattern.nextLength;
+                int nextLength = direction == 0 ? pattern.nextLength : pattern.previousLength;
+                SubtreeOperand operands[3];
+                bool bound[3] = {false, false, false};
+                if (!matchPatternSide(f, g, false, root, previous, previousLength, dual, operands, bound)
+                    || !matchPatternSide(f, g, true, root, next, nextLength, dual, operands, bound))
+                {
+                    continue;
+                }
+                // Each symbol of an operand gains or loses occurrences by the difference between both sides
+                for (int variable = 0; variable < 3; variable++) {
+                    if (!bound[variable]) {
+                        continue;
+                    }
+                    int change = (int) std::count(next, next + nextLength, -variable - 1)
+                        - (int) std::count(previous, previous + previousLength, -variable - 1);
+                    const int* h = (operands[variable].inNext ? g : f) + operands[variable].start;
+                    for (int i = 0; i < operands[variable].length; i++) {
+                        for (int k = 0; k < change; k++) {
+                            incrementVariableCount(h[i]);
+                        }
+                        for (int k = 0; k > change; k--) {
+                            decrementVariableCount(h[i], true);
+                        }
+                    }
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Proof checker for a law set, where each law of the law set is a matcher restricted to a form,
+// so that the matcher of each law is specialized and inlined into the dispatch at compile time.
+// Rewrite rules set with setRules have the laws after those of the law set, in the order of the rule set
+template <class LawSet>
+class ProofChecker : public LawEngine {
+    public:
+        static constexpr int firstRuleLaw = LawSet::lawCount;
+        bool isTransformationByLaw(int f[], int g[], int fLength, int law);
+        int identifyLaw(int f[], int g[], int fLength);
+        bool isProofSequence(int formula[], int fLength, Tuple sequence[], int sequenceLength, int target);
+        bool isProofSequence(const ProofArena& proof, int target);
+        bool recordTransformationByLaw(int f[], int g[], int fLength, int law, std::vector<VariableEffect>& stepEffects);
+        bool isTransformationAtSites(int f[], int g[], int fLength, int law, const int sites[], int siteCount);
+        template <class Symbol> bool isTransformationByLaw(CompactFormula<Symbol> f, CompactFormula<Symbol> g, int law);
+        template <class Symbol> bool isProofSequence(CompactFormula<Symbol> formula, CompactTuple<Symbol> sequence[], int sequenceLength, int target);
+    protected:
+        bool checkTransformationByLaw(int f[], int g[], int fLength, int law);
+        bool checkSites(int f[], int g[], int fLength, int law, const int sites[], int siteCount);
+        template <class Symbol> bool checkCompactTransformation(CompactFormula<Symbol> f, CompactFormula<Symbol> g, int law);
+        bool checkLawAt(int f[], int g[], int fLength, int fStop, int gStop, int s, int law);
+        int identifyLawAt(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int law> bool matchLaw(int f[], int g[], int fLength, int fStop, int gStop, int s);
+        template <int... laws> bool dispatchLaw(int law, int f[], int g[], int fLength, int fStop, int gStop, int s, std::integer_sequence<int, laws...>);
+        template <int... laws> int identifyAmong(int f[], int g[], int fLength, int fStop, int gStop, int s, std::integer_sequence<int, laws...>);
+};
+
+template <class LawSet>
+template <int law>
+bool ProofChecker<LawSet>::matchLaw(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    constexpr int matcher = LawSet::rules[law].matcher;
+    constexpr int form = LawSet::rules[law].form;
+    if constexpr (matcher == identityMatcher) {
+        return isIdentity<form>(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == idempotentMatcher) {
+        return isIdempotent<form>(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == commutativeMatcher) {
+        return isCommutative<form>(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == associativeMatcher) {
+        return isAssociative<form>(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == distributiveMatcher) {
+        return isDistributive<form>(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == deMorganMatcher) {
+        return isDeMorgan<form>(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == complementMatcher) {
+        return isComplement<form>(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == dominationMatcher) {
+        return isDomination<form>(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == absorptionMatcher) {
+        return isAbsorption<form>(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == doubleNegationMatcher) {
+        return isDoubleNegation(f, g, fLength, fStop, gStop, s);
+    } else if constexpr (matcher == negationMatcher) {
+        return isNegation(f, g, fLength, fStop, gStop, s);
+    } else {
+        static_assert(matcher == substitutionMatcher, "Every law must use a known matcher");
+        return isSubstitution(f, g, fLength, fStop, gStop, s);
+    }
+}
+
+template <class LawSet>
+template <int... laws>
+bool ProofChecker<LawSet>::dispatchLaw(int law, int f[], int g[], int fLength, int fStop, int gStop, int s, std::integer_sequence<int, laws...>) {
+    // Only the matcher of the given law runs
+    bool result = false;
+    (void) ((law == laws && (result = matchLaw<laws>(f, g, fLength, fStop, gStop, s), true)) || ...);
+    return result;
+}
+
+template <class LawSet>
+template <int... laws>
+int ProofChecker<LawSet>::identifyAmong(int f[], int g[], int fLength, int fStop, int gStop, int s, std::integer_sequence<int, laws...>) {
+    // The difference in length leaves only the laws with some of the 14 pairs of suffix indices,
+    // and the first of those laws that matches is the law of the step
+    int lengthChange = std::abs(fStop - gStop);
+    if (lengthChange > 4) {
+        return noLaw;
+    }
+    int identified = noLaw;
+    (void) ((((lengthChangesOf(LawSet::rules[laws].matcher) >> lengthChange) & 1)
+        && matchLaw<laws>(f, g, fLength, fStop, gStop, s) && (identified = laws, true)) || ...);
+    return identified;
+}
+
+template <class LawSet>
+int ProofChecker<LawSet>::identifyLawAt(int f[], int g[], int fLength, int fStop, int gStop, int s) {
+    int law = noLaw;
+    if (operandMode == subtreeOperands && compactWidth == 0) {
+        // A law over subtrees can change the length by any number of symbols, so every law is tried in order
+        for (int candidate = 0; candidate < LawSet::lawCount && law == noLaw; candidate++) {
+            law = checkLawAt(f, g, fLength, fStop, gStop, s, candidate) ? candidate : noLaw;
+        }
+    } else {
+        law = identifyAmong(f, g, fLength, fStop, gStop, s, std::make_integer_sequence<int, LawSet::lawCount>());
+    }
+    if (law == noLaw) {
+        // Rewrite rules are only tried when no law of the law set applies
+        int rule = identifyRule(f, g, fStop, gStop, s);
+        law = rule < 0 ? noLaw : firstRuleLaw + rule;
+    }
+    return law;
+}
+
+template <class LawSet>
+bool ProofChecker<LawSet>::isTransformationByLaw(int f[], int g[], int fLength, int law) {
+    resetSuffixes();
+    buildIndexes(f, g, fLength);
+    return checkTransformationByLaw(f, g, fLength, law);
+}
+
+template <class LawSet>
+bool ProofChecker<LawSet>::recordTransformationByLaw(int f[], int g[], int fLength, int law, std::vector<VariableEffect>& stepEffects) {
+    // Like isTransformationByLaw, but the changes to the variables in use are appended to the effects of the step
+    // instead of being made, and each substitution is assumed to hold until its effects are applied
+    effects = &stepEffects;
+    bool result = isTransformationByLaw(f, g, fLength, law);
+    effects = nullptr;
+    return result;
+}
+
+template <class LawSet>
+int ProofChecker<LawSet>::identifyLaw(int f[], int g[], int fLength) {
+    // Like checking an unlabeled step, this also updates the variables for the identified law
+    resetSuffixes();
+    buildIndexes(f, g, fLength);
+    int fStop, gStop, s;
+    if (!locateDissimilarity(f, g, fLength, &fStop, &gStop, &s)) {
+        return noLaw;
+    }
+    return identifyLawAt(f, g, fLength, fStop, gStop, s);
+}
+
+template <class LawSet>
+bool ProofChecker<LawSet>::isTransformationAtSites(int f[], int g[], int fLength, int law, const int sites[], int siteCount) {
+    // The law is applied at the listed sites, which are the indices of the rewritten parts in the previous
+    // expression in increasing order, or at every site where both expressions differ if sites is nullptr
+    resetSuffixes();
+    buildIndexes(f, g, fLength);
+    return checkSites(f, g, fLength, law, sites, siteCount);
+}
+
+template <class LawSet>
+bool ProofChecker<LawSet>::checkSites(int f[], int g[], int fLength, int law, const int sites[], int siteCount) {
+    if (law < 0 || law >= LawSet::lawCount || LawSet::rules[law].matcher == substitutionMatcher) {
+        // Each site of a substitution would need its own new variable
+        return false;
+    }
+    int fStop = indexOfStop(f, fLength);
+    int gStop = indexOfStop(g, fLength);
+    if (fStop < 0 || gStop < 0 || (fStop == gStop && rangesEqual(f, g, fStop))) {
+        // Both Boolean expressions must differ, and end with a STOP symbol
+        return false;
+    }
+    // Commutative and associative laws rewrite from the operator before the first dissimilarity of a site
+    int matcher = LawSet::rules[law].matcher;
+    int lead = matcher == commutativeMatcher || matcher == associativeMatcher ? 1 : 0;
+    // One pass over both expressions, where i and j are the ends of the last site in each expression, and the
+    // symbols up to the next site are compared by the scanning kernels
+    std::vector<VariableEffect>* stepEffects = effects;
+    siteEffects.clear();
+    effects = &siteEffects;
+    siteMatching = true;
+    int i = 0;
+    int j = 0;
+    int nextSite = 0;
+    bool result = true;
+    while (result) {
+        int shared = std::min(fStop - i, gStop - j);
+        int start;
+        if (sites == nullptr) {
+            int mismatch = firstMismatch(f + i, g + j, shared);
+            if (mismatch == shared) {
+                break;
+            }
+            start = i + mismatch - lead;
+        } else {
+            if (nextSite == siteCount) {
+                break;
+            }
+            start = sites[nextSite++];
+            if (start < i || start - i > shared || !rangesEqual(f + i, g + j, start - i)) {
+                // Sites must not overlap, and there must be no other changes before a site
+                result = false;
+                break;
+            }
+        }
+        if (start < i) {
+            // The law would step back into the last site
+            result = false;
+            break;
+        }
+        // The matcher sees both expressions shifted so that the dissimilarity of the site is at the same index
+        int s = start + lead;
+        int sInG = j + (start - i) + lead;
+        int t = std::min(s, sInG);
+        int* shiftedF = f + (s - t);
+        int* shiftedG = g + (sInG - t);
+        result = dispatchLaw(law, shiftedF, shiftedG, fLength - std::max(s, sInG) + t, fStop - (s - t), gStop - (sInG - t), t,
+            std::make_integer_sequence<int, LawSet::lawCount>());
+        i = s + siteSuffixAtF;
+        j = sInG + siteSuffixAtG;
+    }
+    siteMatching = false;
+    effects = stepEffects;
+    // After the last site, both expressions must end with the same symbols
+    result = result && fStop - i == gStop - j && rangesEqual(f + i, g + j, fStop - i);
+    if (result && effects != nullptr) {
+        effects->insert(effects->end(), siteEffects.begin(), siteEffects.end());
+    } else if (result) {
+        applyEffects(siteEffects.data(), (int) siteEffects.size());
+    }
+    return result;
+}
+
+template <class LawSet>
+bool ProofChecker<LawSet>::checkTransformationByLaw(int f[], int g[], int fLength, int law) {
+    if (law >= everySite) {
+        return checkSites(f, g, fLength, law - everySite, nullptr, 0);
+    }
+    int fStop, gStop, s;
+    if (!locateDissimilarity(f, g, fLength, &fStop, &gStop, &s)) {
+        return false;
+    }
+    return checkLawAt(f, g, fLength, fStop, gStop, s, law);
+}
+
+template <class LawSet>
+bool ProofChecker<LawSet>::checkLawAt(int f[], int g[], int fLength, int fStop, int gStop, int s, int law) {
+    if (law == unlabeled) {
+        return identifyLawAt(f, g, fLength, fStop, gStop, s) != noLaw;
+    }
+    if (law >= firstRuleLaw) {
+        return isRuleTransformation(law - firstRuleLaw, f, g, fStop, gStop, s);
+    }
+    if (operandMode == subtreeOperands && compactWidth == 0 && law >= 0 && LawSet::rules[law].matcher != substitutionMatcher) {
+        // Substitution names a sub-expression of Boolean symbols, so only the other laws take subtrees
+        return isSubtreeLaw(LawSet::rules[law], f, g, fStop, gStop, s);
+    }
+    return dispatchLaw(law, f, g, fLength, fStop, gStop, s, std::make_integer_sequence<int, LawSet::lawCount>());
+}
+
+template <class LawSet>
+bool ProofChecker<LawSet>::isProofSequence(int formula[], int fLength, Tuple sequence[], int sequenceLength, int target) {
+    if (indexOfStop(formula, fLength) < 1 || sequenceLength < 1 || (target != TRUE && target != FALSE)) {
+        // The Boolean expression or sequence length must be at least 1, and the target must be a truth value
+        return false;
+    }
+    storeInitialVariables(formula);
+    resetSuffixes();
+    buildIndexes(formula, sequence[0].formula, fLength);
+    if (!checkTransformationByLaw(formula, sequence[0].formula, fLength, sequence[0].law)) {
+        return false;
+    } else if (sequence[0].formula[0] == target && sequence[0].formula[1] == STOP) {
+        return true;
+    }
+    int lastTupleIndex = sequenceLength - 1;
+    for (int i = 0; i < lastTupleIndex; i++) {
+        resetSuffixes();
+        buildNextIndex(sequence[i + 1].formula, fLength);
+        if (!checkTransformationByLaw(sequence[i].formula, sequence[i + 1].formula, fLength, sequence[i + 1].law)) {
+            return false;
+        } else if (sequence[i + 1].formula[0] == target && sequence[i + 1].formula[1] == STOP) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class LawSet>
+bool ProofChecker<LawSet>::isProofSequence(const ProofArena& proof, int target) {
+    if (proof.formulaLength() < 1 || proof.length() < 1 || (target != TRUE && target != FALSE)) {
+        // The Boolean expression or sequence length must be at least 1, and the target must be a truth value
+        return false;
+    }
+    storeInitialVariables(proof.formula());
+    // The matchers only read the expressions, which are consecutive in the arena
+    int* f = const_cast<int*>(proof.formula());
+    int fStop = proof.formulaLength();
+    for (int i = 0; i < proof.length(); i++) {
+        int* g = const_cast<int*>(proof.stepFormula(i));
+        int gStop = proof.stepLength(i);
+        // Every symbol up to the longer of both expressions is in the arena after either one
+        int pairLength = std::max(fStop, gStop) + 1;
+        resetSuffixes();
+        if (i == 0) {
+            buildIndexes(f, g, pairLength);
+        } else {
+            buildNextIndex(g, pairLength);
+        }
+        if (!checkTransformationByLaw(f, g, pairLength, proof.law(i))) {
+            return false;
+        } else if (gStop == 1 && g[0] == target) {
+            return true;
+        }
+        f = g;
+        fStop = gStop;
+    }
+    return false;
+}
+
+template <class LawSet>
+template <class Symbol>
+bool ProofChecker<LawSet>::checkCompactTransformation(CompactFormula<Symbol> f, CompactFormula<Symbol> g, int law) {
+    resetSuffixes();
+    int fStop, gStop, s;
+    bool result = loadWindows(f, g, &fStop, &gStop, &s)
+        && checkLawAt(previousWindow.data(), nextWindow.data(), (int) previousWindow.size(), fStop, gStop, s, law);
+    compactWidth = 0;
+    return result;
+}
+
+template <class LawSet>
+template <class Symbol>
+bool ProofChecker<LawSet>::isTransformationByLaw(CompactFormula<Symbol> f, CompactFormula<Symbol> g, int law) {
+    return checkCompactTransformation(f, g, law);
+}
+
+template <class LawSet>
+template <class Symbol>
+bool ProofChecker<LawSet>::isProofSequence(CompactFormula<Symbol> formula, CompactTuple<Symbol> sequence[], int sequenceLength, int target) {
+    if (formula.length < 1 || sequenceLength < 1 || (target != TRUE && target != FALSE)) {
+        // The Boolean expression or sequence length must be at least 1, and the target must be a truth value
+        return false;
+    }
+    storeInitialVariables(formula);
+    CompactFormula<Symbol> previous = formula;
+    for (int i = 0; i < sequenceLength; i++) {
+        const CompactFormula<Symbol>& next = sequence[i].formula;
+        if (!checkCompactTransformation(previous, next, sequence[i].law)) {
+            return false;
+        } else if (next.length == 1 && next.symbols[0] == target) {
+            return true;
+        }
+        previous = next;
+    }
+    return false;
+}
+
+// A proof to be checked in a batch, with the same arguments as isProofSequence
+class Proof {
+    public:
+        int* formula;
+        int fLength;
+        Tuple* sequence;
+        int sequenceLength;
+        int target;
+        Proof(int proofFormula[], int proofFLength, Tuple proofSequence[], int proofSequenceLength, int proofTarget) {
+            formula = proofFormula;
+            fLength = proofFLength;
+            sequence = proofSequence;
+            sequenceLength = proofSequenceLength;
+            target = proofTarget;
+        }
+};
+
+// A fixed pool of threads where each thread owns a ProofChecker for the whole lifetime of the pool.
+// The threads check a batch of proofs, or the steps of one long proof with verifyProof
+template <class LawSet>
+class ProofVerifierPool {
+    public:
+        ProofVerifierPool(int threadCount, const RuleSet* ruleSet = nullptr);
+        ~ProofVerifierPool();
+        ProofVerifierPool(const ProofVerifierPool&) = delete;
+        ProofVerifierPool& operator=(const ProofVerifierPool&) = delete;
+        std::vector<char> verifyBatch(const std::vector<Proof>& proofs);
+        bool verifyProof(const Proof& proof);
+        bool verifyProof(const ProofArena& proof, int target);
+    private:
+        // Result of checking the structure of a step, whose effects are in the effects of its chunk of steps
+        class StepCheck {
+            public:
+                bool correct;
+                int firstEffect;
+                int effectCount;
+        };
+        static constexpr size_t chunkSize = 64; // Proofs claimed by a thread at a time
+        static constexpr size_t stepChunkSize = 256; // Steps of one proof claimed by a thread at a time
+        std::vector<std::thread> workers;
+        std::mutex batchMutex; // Only one batch is in the pool at a time
+        std::mutex stateMutex;
+        std::condition_variable batchReady;
+        std::condition_variable batchDone;
+        const RuleSet* rules; // Rewrite rules of every checker of the pool, or nullptr for none
+        const std::vector<Proof>* batch;
+        char* verdicts;
+        std::atomic<size_t> nextProof;
+        // Proof whose steps are checked by every thread, from either a Proof or a ProofArena
+        const Proof* stepProof;
+        const ProofArena* stepArena;
+        size_t stepCount;
+        StepCheck* stepChecks;
+        std::vector<VariableEffect>* chunkEffects;
+        ProofChecker<LawSet> replayChecker; // Makes the changes to the variables in use in order, in the calling thread
+        int generation;
+        int activeWorkers;
+        bool stopping;
+        void work();
+        void stepAt(size_t step, int** f, int** g, int* fLength, int* law) const;
+        void checkSteps(ProofChecker<LawSet>& checker);
+        bool verifySteps(const int formula[], int target);
+};
+
+template <class LawSet>
+ProofVerifierPool<LawSet>::ProofVerifierPool(int threadCount, const RuleSet* ruleSet) {
+    rules = ruleSet;
+    batch = nullptr;
+    verdicts = nullptr;
+    nextProof = 0;
+    stepProof = nullptr;
+    stepArena = nullptr;
+    stepCount = 0;
+    stepChecks = nullptr;
+    chunkEffects = nullptr;
+    replayChecker.setRules(ruleSet);
+    generation = 0;
+    activeWorkers = 0;
+    stopping = false;
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ProofVerifierPool<LawSet>::work, this);
+    }
+}
+
+template <class LawSet>
+ProofVerifierPool<LawSet>::~ProofVerifierPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    batchReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+template <class LawSet>
+void ProofVerifierPool<LawSet>::work() {
+    ProofChecker<LawSet> checker;
+    checker.setRules(rules);
+    int seenGeneration = 0;
+    std::unique_lock<std::mutex> lock(stateMutex);
+    while (true) {
+        batchReady.wait(lock, [&] { return stopping || generation != seenGeneration; });
+        if (stopping) {
+            return;
+        }
+        seenGeneration = generation;
+        if (stepCount > 0) {
+            lock.unlock();
+            checkSteps(checker);
+            lock.lock();
+        } else {
+            const std::vector<Proof>& proofs = *batch;
+            char* results = verdicts;
+            lock.unlock();
+            // Claim chunks of proofs until the batch runs out
+            size_t proofCount = proofs.size();
+            size_t first;
+            while ((first = nextProof.fetch_add(chunkSize)) < proofCount) {
+                size_t last = std::min(first + chunkSize, proofCount);
+                for (size_t i = first; i < last; i++) {
+                    const Proof& proof = proofs[i];
+                    results[i] = checker.isProofSequence(proof.formula, proof.fLength, proof.sequence, proof.sequenceLength, proof.target);
+                }
+            }
+            lock.lock();
+        }
+        activeWorkers--;
+        if (activeWorkers == 0) {
+            batchDone.notify_one();
+        }
+    }
+}
+
+template <class LawSet>
+std::vector<char> ProofVerifierPool<LawSet>::verifyBatch(const std::vector<Proof>& proofs) {
+    std::vector<char> results(proofs.size(), false); // One verdict per proof, true if it is a correct proof sequence
+    if (proofs.empty()) {
+        return results;
+    }
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+    std::unique_lock<std::mutex> lock(stateMutex);
+    batch = &proofs;
+    verdicts = results.data();
+    nextProof = 0;
+    activeWorkers = (int) workers.size();
+    generation++;
+    batchReady.notify_all();
+    batchDone.wait(lock, [&] { return activeWorkers == 0; });
+    batch = nullptr;
+    verdicts = nullptr;
+    return results;
+}
+
+template <class LawSet>
+void ProofVerifierPool<LawSet>::stepAt(size_t step, int** f, int** g, int* fLength, int* law) const {
+    if (stepProof != nullptr) {
+        *f = step == 0 ? stepProof->formula : stepProof->sequence[step - 1].formula;
+        *g = stepProof->sequence[step].formula;
+        *fLength = stepProof->fLength;
+        *law = stepProof->sequence[step].law;
+    } else {
+        // Like isProofSequence for an arena, each pair of expressions is read up to the longer one
+        int i = (int) step;
+        *f = const_cast<int*>(i == 0 ? stepArena->formula() : stepArena->stepFormula(i - 1));
+        *g = const_cast<int*>(stepArena->stepFormula(i));
+        *fLength = std::max(i == 0 ? stepArena->formulaLength() : stepArena->stepLength(i - 1), stepArena->stepLength(i)) + 1;
+        *law = stepArena->law(i);
+    }
+}
+
+template <class LawSet>
+void ProofVerifierPool<LawSet>::checkSteps(ProofChecker<LawSet>& checker) {
+    // Claim chunks of steps, and check the structure of each step on its own, with its effects in its chunk
+    size_t first;
+    while ((first = nextProof.fetch_add(stepChunkSize)) < stepCount) {
+        size_t last = std::min(first + stepChunkSize, stepCount);
+        std::vector<VariableEffect>& effects = chunkEffects[first / stepChunkSize];
+        for (size_t i = first; i < last; i++) {
+            int* f;
+            int* g;
+            int fLength;
+            int law;
+            stepAt(i, &f, &g, &fLength, &law);
+            StepCheck& check = stepChecks[i];
+            check.firstEffect = (int) effects.size();
+            check.correct = checker.recordTransformationByLaw(f, g, fLength, law, effects);
+            check.effectCount = (int) effects.size() - check.firstEffect;
+        }
+    }
+}
+
+template <class LawSet>
+bool ProofVerifierPool<LawSet>::verifySteps(const int formula[], int target) {
+    // First the structure of every step is checked on every thread, then the changes to the variables in use
+    // are made in order in this thread, with the same verdict as isProofSequence
+    std::vector<StepCheck> checks(stepCount);
+    std::vector<std::vector<VariableEffect>> effects((stepCount + stepChunkSize - 1) / stepChunkSize);
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        stepChecks = checks.data();
+        chunkEffects = effects.data();
+        nextProof = 0;
+        activeWorkers = (int) workers.size();
+        generation++;
+        batchReady.notify_all();
+        batchDone.wait(lock, [&] { return activeWorkers == 0; });
+        stepChecks = nullptr;
+        chunkEffects = nullptr;
+    }
+    replayChecker.storeInitialVariables(formula);
+    bool result = false;
+    for (size_t i = 0; i < stepCount; i++) {
+        int* f;
+        int* g;
+        int fLength;
+        int law;
+        stepAt(i, &f, &g, &fLength, &law);
+        if (!checks[i].correct) {
+            break;
+        }
+        const VariableEffect* stepEffects = effects[i / stepChunkSize].data() + checks[i].firstEffect;
+        if (!replayChecker.applyEffects(stepEffects, checks[i].effectCount)
+            && (law != unlabeled || !replayChecker.isTransformationByLaw(f, g, fLength, unlabeled))) {
+            // A substitution that does not hold, unless a law after it or a rule identifies an unlabeled step
+            break;
+        }
+        if (g[0] == target && g[1] == STOP) {
+            result = true;
+            break;
+        }
+    }
+    stepCount = 0;
+    stepProof = nullptr;
+    stepArena = nullptr;
+    return result;
+}
+
+template <class LawSet>
+bool ProofVerifierPool<LawSet>::verifyProof(const Proof& proof) {
+    if (indexOfStop(proof.formula, proof.fLength) < 1 || proof.sequenceLength < 1 || (proof.target != TRUE && proof.target != FALSE)) {
+        // The Boolean expression or sequence length must be at least 1, and the target must be a truth value
+        return false;
+    }
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+    stepProof = &proof;
+    stepCount = (size_t) proof.sequenceLength;
+    return verifySteps(proof.formula, proof.target);
+}
+
+template <class LawSet>
+bool ProofVerifierPool<LawSet>::verifyProof(const ProofArena& proof, int target) {
+    if (proof.formulaLength() < 1 || proof.length() < 1 || (target != TRUE && target != FALSE)) {
+        // The Boolean expression or sequence length must be at least 1, and the target must be a truth value
+        return false;
+    }
+    std::lock_guard<std::mutex> batchLock(batchMutex);
+    stepArena = &proof;
+    stepCount = (size_t) proof.length();
+    return verifySteps(proof.formula(), target);
+}
+
+template <class LawSet>
+std::vector<char> verifyBatch(const std::vector<Proof>& proofs) {
+    // Shared pool with one thread per core
+    static ProofVerifierPool<LawSet> pool((int) std::thread::hardware_concurrency());
+    return pool.verifyBatch(proofs);
+}
+
+#endif
@@ -0,0 +1,348 @@
+#ifndef PROOF_MINIMIZER_H
+#define PROOF_MINIMIZER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+#include "ProofEngine.h"
+#include "ProofSearch.h"
+
+// Minimizer of proofs, which replays a proof like isProofSequence and keeps every state, which is an expression
+// with the variables in use. A state that comes back is a cycle, so the steps between both visits are cut. Then
+// each state is joined to the furthest state within a window of steps that it reaches by one step, or by two steps
+// through a successor from the StepExpander, which leaves the variables in use as they were at that state so that
+// the steps after it still hold. The minimized proof is checked by isProofSequence before it is returned
+
+template <class LawSet>
+class ProofMinimizer {
+    public:
+        ProofMinimizer();
+        ProofMinimizer(const ProofMinimizer&) = delete;
+        ProofMinimizer& operator=(const ProofMinimizer&) = delete;
+        void setRules(const RuleSet* ruleSet);
+        void setWindow(int steps);
+        bool minimize(int formula[], int fLength, Tuple sequence[], int sequenceLength, int target, SearchProof* proof);
+        int cycleSteps() const;
+        int shortcutSteps() const;
+    private:
+        // A state of the proof, whose expression and variables are stored in shared pools like those of a search
+        class ProofState {
+            public:
+                int law; // Law of the step into the state
+                int formulaStart;
+                int formulaStop;
+                int variablesStart;
+                int variableCount;
+                uint64_t hash;
+        };
+        ProofChecker<LawSet> checker;
+        StepExpander<LawSet> expander;
+        const RuleSet* rules;
+        int window; // Most steps of the proof that one shortcut replaces
+        int arrayLength; // Symbols of the longest expression of the proof with STOP, and room for the matchers to look ahead
+        std::vector<int> formulaPool;
+        std::vector<VariableRecord> variablePool;
+        std::vector<ProofState> states;
+        std::vector<int> path; // States of the minimized proof
+        std::vector<int> previousFormula;
+        std::vector<int> nextFormula;
+        std::vector<VariableRecord> saved;
+        std::vector<VariableRecord> current;
+        std::vector<ProofState> successors; // States one step from the state being joined, in the pools after the proof
+        int removedByCycles;
+        int removedByShortcuts;
+        int addState(int law, const int f[], int fStop, const std::vector<VariableRecord>& variables);
+        bool sameState(const ProofState& x, const ProofState& y) const;
+        void load(const ProofState& state, std::vector<int>& f);
+        bool store(const std::vector<int>& proofStates, int target, SearchProof* proof);
+        int lawBetween(const ProofState& from, const ProofState& to);
+        void removeCycles();
+        bool shortcut();
+};
+
+template <class LawSet>
+ProofMinimizer<LawSet>::ProofMinimizer() {
+    rules = nullptr;
+    window = 8;
+    arrayLength = 0;
+    removedByCycles = 0;
+    removedByShortcuts = 0;
+}
+
+template <class LawSet>
+void ProofMinimizer<LawSet>::setRules(const RuleSet* ruleSet) {
+    rules = ruleSet;
+    checker.setRules(ruleSet);
+}
+
+template <class LawSet>
+void ProofMinimizer<LawSet>::setWindow(int steps) {
+    window = std::max(2, steps);
+}
+
+template <class LawSet>
+int ProofMinimizer<LawSet>::cycleSteps() const {
+    // Steps that the last minimized proof lost by cutting cycles
+    return removedByCycles;
+}
+
+template <class LawSet>
+int ProofMinimizer<LawSet>::shortcutSteps() const {
+    // Steps that the last minimized proof lost by shortcuts
+    return removedByShortcuts;
+}
+
+template <class LawSet>
+int ProofMinimizer<LawSet>::addState(int law, const int f[], int fStop, const std::vector<VariableRecord>& variables) {
+    ProofState state;
+    state.law = law;
+    state.formulaStart = (int) formulaPool.size();
+    state.formulaStop = fStop;
+    state.variablesStart = (int) variablePool.size();
+    state.variableCount = (int) variables.size();
+    state.hash = stateHash(f, fStop, variables.data(), state.variableCount);
+    formulaPool.insert(formulaPool.end(), f, f + fStop);
+    variablePool.insert(variablePool.end(), variables.begin(), variables.end());
+    states.push_back(state);
+    return (int) states.size() - 1;
+}
+
+template <class LawSet>
+bool ProofMinimizer<LawSet>::sameState(const ProofState& x, const ProofState& y) const {
+    // The hashes only tell states apart, so equal hashes are confirmed
+    if (x.hash != y.hash || x.formulaStop != y.formulaStop || x.variableCount != y.variableCount) {
+        return false;
+    }
+    if (!std::equal(formulaPool.begin() + x.formulaStart, formulaPool.begin() + x.formulaStart + x.formulaStop,
+        formulaPool.begin() + y.formulaStart))
+    {
+        return false;
+    }
+    for (int v = 0; v < x.variableCount; v++) {
+        const VariableRecord& a = variablePool[x.variablesStart + v];
+        const VariableRecord& b = variablePool[y.variablesStart + v];
+        if (a.name != b.name || a.count != b.count || a.type != b.type || a.a != b.a || a.b != b.b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class LawSet>
+void ProofMinimizer<LawSet>::load(const ProofState& state, std::vector<int>& f) {
+    // The expression padded with STOP to the array length of the proof
+    f.assign(arrayLength, STOP);
+    std::copy(formulaPool.begin() + state.formulaStart, formulaPool.begin() + state.formulaStart + state.formulaStop, f.begin());
+}
+
+template <class LawSet>
+bool ProofMinimizer<LawSet>::store(const std::vector<int>& proofStates, int target, SearchProof* proof) {
+    // The proof through the states, and true if it is correct
+    if (proofStates.size() < 2) {
+        return false;
+    }
+    proof->fLength = arrayLength;
+    load(states[proofStates[0]], proof->formula);
+    proof->laws.clear();
+    proof->formulas.clear();
+    for (size_t i = 1; i < proofStates.size(); i++) {
+        proof->laws.push_back(states[proofStates[i]].law);
+        proof->formulas.emplace_back();
+        load(states[proofStates[i]], proof->formulas.back());
+    }
+    std::vector<Tuple> sequence = proof->sequence();
+    return checker.isProofSequence(proof->formula.data(), proof->fLength, sequence.data(), proof->length(), target);
+}
+
+template <class LawSet>
+int ProofMinimizer<LawSet>::lawBetween(const ProofState& from, const ProofState& to) {
+    // A law whose step from one state reaches the expression and the variables in use of the other state
+    int fStop = from.formulaStop;
+    int gStop = to.formulaStop;
+    int longestRule = rules == nullptr ? 0 : rules->longestSideLength();
+    if (std::abs(fStop - gStop) > std::max(6, longestRule)) {
+        // No law changes the length by more than a + (b * c) = (a + b) * (a + c) or a rule does
+        return noLaw;
+    }
+    load(from, previousFormula);
+    load(to, nextFormula);
+    const VariableRecord* variables = variablePool.data() + from.variablesStart;
+    checker.variables().restore(variables, from.variableCount);
+    int identified = checker.identifyLaw(previousFormula.data(), nextFormula.data(), arrayLength);
+    if (identified == noLaw) {
+        return noLaw;
+    }
+    int lawCount = ProofChecker<LawSet>::firstRuleLaw + (rules == nullptr ? 0 : rules->size());
+    for (int k = -1; k < lawCount; k++) {
+        // The identified law first, then every other law, which may change the variables in use differently
+        int law = k < 0 ? identified : k;
+        if (k == identified) {
+            continue;
+        }
+        checker.variables().restore(variables, from.variableCount);
+        if (!checker.isTransformationByLaw(previousFormula.data(), nextFormula.data(), arrayLength, law)) {
+            continue;
+        }
+        checker.variables().save(saved);
+        if (stateHash(nextFormula.data(), gStop, saved.data(), (int) saved.size()) == to.hash
+            && (int) saved.size() == to.variableCount
+            && std::equal(saved.begin(), saved.end(), variablePool.begin() + to.variablesStart,
+                [](const VariableRecord& x, const VariableRecord& y) {
+                    return x.name == y.name && x.count == y.count && x.type == y.type && x.a == y.a && x.b == y.b;
+                }))
+        {
+            return law;
+        }
+    }
+    return noLaw;
+}
+
+template <class LawSet>
+void ProofMinimizer<LawSet>::removeCycles() {
+    // Loop erasure: a state that is already on the path cuts the path back to its first visit
+    std::unordered_map<uint64_t, std::vector<int>> positions; // Positions on the path of the states of each hash
+    std::vector<int> erased;
+    erased.swap(path);
+    for (int state : erased) {
+        std::vector<int>& candidates = positions[states[state].hash];
+        int visited = -1;
+        for (int position : candidates) {
+            if (position < (int) path.size() && path[position] >= 0 && sameState(states[path[position]], states[state])) {
+                visited = position;
+            }
+        }
+        if (visited < 0) {
+            candidates.push_back((int) path.size());
+            path.push_back(state);
+            continue;
+        }
+        // The steps after the first visit lead back to it, so the path ends at the first visit
+        removedByCycles += (int) path.size() - visited;
+        path.resize(visited + 1);
+    }
+}
+
+template <class LawSet>
+bool ProofMinimizer<LawSet>::shortcut() {
+    // One pass that joins each state of the path to the furthest state within the window that it reaches in
+    // fewer steps, and true if the path is shorter
+    std::vector<int> joined;
+    joined.push_back(path[0]);
+    int last = (int) path.size() - 1;
+    int i = 0;
+    int firstRemoved = removedByShortcuts;
+    while (i < last) {
+        const ProofState from = states[path[i]];
+        int reached = i + 1;
+        int via = -1;
+        bool expanded = false;
+        for (int j = std::min(last, i + window); j >= i + 2 && reached == i + 1; j--) {
+            const ProofState to = states[path[j]];
+            int law = lawBetween(from, to);
+            if (law != noLaw) {
+                states[path[j]].law = law;
+                reached = j;
+                break;
+            }
+            if (j < i + 3) {
+                break;
+            }
+            if (!expanded) {
+                // The successors of the state are only found once, for the first state that is 3 or more steps away
+                expanded = true;
+                successors.clear();
+                // The successors are added to the pools, so the expander reads a copy of the variables of the state
+                load(from, previousFormula);
+                current.assign(variablePool.begin() + from.variablesStart, variablePool.begin() + from.variablesStart + from.variableCount);
+                expander.expand(previousFormula.data(), from.formulaStop, arrayLength, current.data(), from.variableCount,
+                    [&](int law, int, const int* g, int gStop, const std::vector<VariableRecord>& variables) {
+                        int state = addState(law, g, gStop, variables);
+                        successors.push_back(states[state]);
+                        states.pop_back();
+                    });
+            }
+            for (const ProofState& middle : successors) {
+                int secondLaw = lawBetween(middle, to);
+                if (secondLaw != noLaw) {
+                    states.push_back(middle);
+                    via = (int) states.size() - 1;
+                    states[path[j]].law = secondLaw;
+                    reached = j;
+                    break;
+                }
+            }
+        }
+        if (via >= 0) {
+            joined.push_back(via);
+        }
+        joined.push_back(path[reached]);
+        removedByShortcuts += reached - i - 1 - (via >= 0 ? 1 : 0);
+        i = reached;
+    }
+    path.swap(joined);
+    return removedByShortcuts > firstRemoved;
+}
+
+template <class LawSet>
+bool ProofMinimizer<LawSet>::minimize(int formula[], int fLength, Tuple sequence[], int sequenceLength, int target, SearchProof* proof) {
+    // False if the proof is not correct for isProofSequence, and otherwise the minimized proof, whose expressions
+    // are padded with STOP to the length of the longest expression of the proof with room to look ahead
+    removedByCycles = 0;
+    removedByShortcuts = 0;
+    formulaPool.clear();
+    variablePool.clear();
+    states.clear();
+    path.clear();
+    int fStop = indexOfStop(formula, fLength);
+    if (fStop < 1 || sequenceLength < 1 || (target != TRUE && target != FALSE)) {
+        // The Boolean expression or sequence length must be at least 1, and the target must be a truth value
+        return false;
+    }
+    checker.storeInitialVariables(formula);
+    checker.variables().save(saved);
+    path.push_back(addState(noLaw, formula, fStop, saved));
+    int longest = fStop;
+    int* previous = formula;
+    bool reachedTarget = false;
+    for (int i = 0; i < sequenceLength && !reachedTarget; i++) {
+        int* next = sequence[i].formula;
+        if (!checker.isTransformationByLaw(previous, next, fLength, sequence[i].law)) {
+            return false;
+        }
+        int gStop = indexOfStop(next, fLength);
+        checker.variables().save(saved);
+        path.push_back(addState(sequence[i].law, next, gStop, saved));
+        longest = std::max(longest, gStop);
+        reachedTarget = next[0] == target && next[1] == STOP;
+        previous = next;
+    }
+    if (!reachedTarget) {
+        return false;
+    }
+    // The matchers look ahead by up to 8 symbols, and rules by up to the length of a side
+    arrayLength = longest + 1 + std::max(8, rules == nullptr ? 0 : rules->longestSideLength());
+    std::vector<int> replayed = path;
+    std::vector<int> laws;
+    for (int state : replayed) {
+        laws.push_back(states[state].law);
+    }
+    removeCycles();
+    while (path.size() > 2 && shortcut()) {
+        // Each pass may bring states that were joined into the window of an earlier state
+    }
+    if (store(path, target, proof)) {
+        return true;
+    }
+    // A proof from the target itself has no steps left after its cycles are cut, so the proof is kept as it was
+    removedByCycles = 0;
+    removedByShortcuts = 0;
+    for (size_t i = 0; i < replayed.size(); i++) {
+        states[replayed[i]].law = laws[i];
+    }
+    return store(replayed, target, proof);
+}
+
+#endif
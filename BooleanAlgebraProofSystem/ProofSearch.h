@@ -0,0 +1,772 @@
+#ifndef PROOF_SEARCH_H
+#define PROOF_SEARCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "ProofEngine.h"
+#include "SearchBounds.h"
+
+// Proof search for a law set, which finds a proof sequence of minimal length that transforms a Boolean expression
+// into TRUE or FALSE. A state of the search is an expression with the variables in use, including the
+// sub-expressions of substituted variables, and every step is confirmed by a ProofChecker, so that
+// isProofSequence accepts every proof that is found
+
+// A proof found by a search, with every expression padded with STOP to the same length
+class SearchProof {
+    public:
+        int fLength;
+        std::vector<int> formula;
+        std::vector<int> laws;
+        std::vector<std::vector<int>> formulas;
+        int length() const {
+            return (int) laws.size();
+        }
+        std::vector<Tuple> sequence() {
+            // Tuples that point into the expressions of this proof
+            std::vector<Tuple> tuples;
+            for (int i = 0; i < length(); i++) {
+                tuples.push_back(Tuple(laws[i], formulas[i].data()));
+            }
+            return tuples;
+        }
+        ProofArena arena() const {
+            // The expressions of this proof in one arena
+            ProofArena proof;
+            proof.reserve((size_t) (length() + 2) * fLength, length());
+            proof.setFormula(formula.data(), fLength);
+            for (int i = 0; i < length(); i++) {
+                proof.addStep(laws[i], formulas[i].data(), fLength);
+            }
+            return proof;
+        }
+};
+
+// Generator of the steps that each law of a law set can take from an expression, in both directions.
+// Operands that a law introduces, such as 'a' in 1 = a + -a, are TRUE, FALSE or a variable in use, and also
+// the lowest variable that is not in use if new variables are allowed. A substitution introduces that variable
+template <class LawSet>
+class MoveGenerator {
+    public:
+        MoveGenerator();
+        void allowNewVariables(bool allowed);
+        void focus(int law, int index);
+        template <class Visit> void generate(const int f[], int fStop, const VariableRecord* variables, int variableCount, Visit visit);
+    private:
+        std::vector<int> booleans;
+        int freshVariable;
+        bool newVariables;
+        int focusLaw; // Only steps of this law at this index, or -1 for every law and index
+        int focusIndex;
+        template <class Visit> void movesAt(int law, int matcher, int op, const int f[], int fStop, int i, const VariableRecord* variables, int variableCount, Visit& visit);
+};
+
+template <class LawSet>
+MoveGenerator<LawSet>::MoveGenerator() {
+    freshVariable = minVariable;
+    newVariables = false;
+    focusLaw = -1;
+    focusIndex = -1;
+}
+
+template <class LawSet>
+void MoveGenerator<LawSet>::allowNewVariables(bool allowed) {
+    newVariables = allowed;
+}
+
+template <class LawSet>
+void MoveGenerator<LawSet>::focus(int law, int index) {
+    focusLaw = law;
+    focusIndex = index;
+}
+
+template <class LawSet>
+template <class Visit>
+void MoveGenerator<LawSet>::generate(const int f[], int fStop, const VariableRecord* variables, int variableCount, Visit visit) {
+    // The visitor receives the law, the index of the step, and the symbols that replace some symbols from the index
+    booleans.assign({FALSE, TRUE});
+    freshVariable = minVariable;
+    for (int v = 0; v < variableCount; v++) {
+        // The records are in increasing order of name
+        booleans.push_back(variables[v].name);
+        if (variables[v].name == freshVariable) {
+            freshVariable++;
+        }
+    }
+    if (newVariables) {
+        booleans.push_back(freshVariable);
+    }
+    for (int i = 0; i < fStop; i++) {
+        if (focusIndex >= 0 && i != focusIndex) {
+            continue;
+        }
+        for (int law = 0; law < LawSet::lawCount; law++) {
+            if (focusLaw >= 0 && law != focusLaw) {
+                continue;
+            }
+            int matcher = LawSet::rules[law].matcher;
+            int form = LawSet::rules[law].form;
+            if (matcher == doubleNegationMatcher || matcher == negationMatcher || matcher == substitutionMatcher) {
+                // Laws without forms
+                movesAt(law, matcher, OR, f, fStop, i, variables, variableCount, visit);
+                continue;
+            }
+            if (form != AND) {
+                movesAt(law, matcher, OR, f, fStop, i, variables, variableCount, visit);
+            }
+            if (form != OR) {
+                movesAt(law, matcher, AND, f, fStop, i, variables, variableCount, visit);
+            }
+        }
+    }
+}
+
+template <class LawSet>
+template <class Visit>
+void MoveGenerator<LawSet>::movesAt(int law, int matcher, int op, const int f[], int fStop, int i, const VariableRecord* variables, int variableCount, Visit& visit) {
+    auto at = [&](int k) { return k < fStop ? f[k] : STOP; };
+    int other = otherOperator(op);
+    int x = f[i];
+    int a = at(i + 1);
+    int b = at(i + 2);
+    if (matcher == identityMatcher) {
+        // + a 0 = a, * a 1 = a
+        if (x == op && isBoolean(a) && b == identityElement(op)) {
+            int r[] = {a};
+            visit(law, i, r, 1, 3);
+        }
+        if (isBoolean(x)) {
+            int r[] = {op, x, identityElement(op)};
+            visit(law, i, r, 3, 1);
+        }
+    } else if (matcher == idempotentMatcher) {
+        // + a a = a, * a a = a
+        if (x == op && isBoolean(a) && a == b) {
+            int r[] = {a};
+            visit(law, i, r, 1, 3);
+        }
+        if (isBoolean(x)) {
+            int r[] = {op, x, x};
+            visit(law, i, r, 3, 1);
+        }
+    } else if (matcher == commutativeMatcher) {
+        // + a b = + b a, * a b = * b a
+        if (x == op && isBoolean(a) && isBoolean(b) && a != b) {
+            int r[] = {op, b, a};
+            visit(law, i, r, 3, 3);
+        }
+    } else if (matcher == associativeMatcher) {
+        // + a + b c = + + a b c, * a * b c = * * a b c
+        if (x == op && isBoolean(a) && b == op && isBoolean(at(i + 3)) && isBoolean(at(i + 4))) {
+            int r[] = {op, op, a, at(i + 3), at(i + 4)};
+            visit(law, i, r, 5, 5);
+        }
+        if (x == op && a == op && isBoolean(b) && isBoolean(at(i + 3)) && isBoolean(at(i + 4))) {
+            int r[] = {op, b, op, at(i + 3), at(i + 4)};
+            visit(law, i, r, 5, 5);
+        }
+    } else if (matcher == distributiveMatcher) {
+        // + a * b c = * + a b + a c, * a + b c = + * a b * a c
+        if (x == op && isBoolean(a) && b == other && isBoolean(at(i + 3)) && isBoolean(at(i + 4))) {
+            int r[] = {other, op, a, at(i + 3), op, a, at(i + 4)};
+            visit(law, i, r, 7, 5);
+        }
+        if (x == other && a == op && isBoolean(b) && isBoolean(at(i + 3)) && at(i + 4) == op && at(i + 5) == b && isBoolean(at(i + 6))) {
+            int r[] = {op, b, other, at(i + 3), at(i + 6)};
+            visit(law, i, r, 5, 7);
+        }
+    } else if (matcher == deMorganMatcher) {
+        // - + a b = * - a - b, - * a b = + - a - b
+        if (x == NOT && a == op && isBoolean(b) && isBoolean(at(i + 3))) {
+            int r[] = {other, NOT, b, NOT, at(i + 3)};
+            visit(law, i, r, 5, 4);
+        }
+        if (x == other && a == NOT && isBoolean(b) && at(i + 3) == NOT && isBoolean(at(i + 4))) {
+            int r[] = {NOT, op, b, at(i + 4)};
+            visit(law, i, r, 4, 5);
+        }
+    } else if (matcher == complementMatcher) {
+        // + a - a = 1, * a - a = 0
+        if (x == op && isBoolean(a) && b == NOT && at(i + 3) == a) {
+            int r[] = {dominatingElement(op)};
+            visit(law, i, r, 1, 4);
+        }
+        if (x == dominatingElement(op)) {
+            for (int operand : booleans) {
+                int r[] = {op, operand, NOT, operand};
+                visit(law, i, r, 4, 1);
+            }
+        }
+    } else if (matcher == dominationMatcher) {
+        // + a 1 = 1, * a 0 = 0
+        if (x == op && isBoolean(a) && b == dominatingElement(op)) {
+            int r[] = {b};
+            visit(law, i, r, 1, 3);
+        }
+        if (x == dominatingElement(op)) {
+            for (int operand : booleans) {
+                int r[] = {op, operand, x};
+                visit(law, i, r, 3, 1);
+            }
+        }
+    } else if (matcher == absorptionMatcher) {
+        // + a * a b = a, * a + a b = a
+        if (x == op && isBoolean(a) && b == other && at(i + 3) == a && isBoolean(at(i + 4))) {
+            int r[] = {a};
+            visit(law, i, r, 1, 5);
+        }
+        if (isBoolean(x)) {
+            for (int operand : booleans) {
+                int r[] = {op, x, other, x, operand};
+                visit(law, i, r, 5, 1);
+            }
+        }
+    } else if (matcher == doubleNegationMatcher) {
+        // - - a = a
+        if (x == NOT && a == NOT && isBoolean(b)) {
+            int r[] = {b};
+            visit(law, i, r, 1, 3);
+        }
+        if (isBoolean(x)) {
+            int r[] = {NOT, NOT, x};
+            visit(law, i, r, 3, 1);
+        }
+    } else if (matcher == negationMatcher) {
+        // - 1 = 0, - 0 = 1
+        if (x == NOT && isTruthValue(a)) {
+            int r[] = {a == TRUE ? FALSE : TRUE};
+            visit(law, i, r, 1, 2);
+        }
+        if (isTruthValue(x)) {
+            int r[] = {NOT, x == TRUE ? FALSE : TRUE};
+            visit(law, i, r, 2, 1);
+        }
+    } else if (matcher == substitutionMatcher) {
+        // - a = x, + a b = x, * a b = x
+        if (x == NOT && isBoolean(a)) {
+            int r[] = {freshVariable};
+            visit(law, i, r, 1, 2);
+        }
+        if ((x == OR || x == AND) && isBoolean(a) && isBoolean(b)) {
+            int r[] = {freshVariable};
+            visit(law, i, r, 1, 3);
+        }
+        if (isVariable(x)) {
+            const VariableRecord* end = variables + variableCount;
+            const VariableRecord* record = std::lower_bound(variables, end, x, [](const VariableRecord& y, int name) { return y.name < name; });
+            if (record != end && record->name == x && record->type == 1) {
+                int r[] = {NOT, record->a};
+                visit(law, i, r, 2, 1);
+            } else if (record != end && record->name == x && record->type >= OR) {
+                int r[] = {record->type, record->a, record->b};
+                visit(law, i, r, 3, 1);
+            }
+        }
+    }
+}
+
+// Fixed-size table of visited states, keyed by a hash of the state, where each bucket holds 4 states
+// and a full bucket replaces its deepest state, since shallow states prune more of the search
+class TranspositionTable {
+    public:
+        explicit TranspositionTable(int log2Buckets = 16) {
+            resize(log2Buckets);
+        }
+        void resize(int log2Buckets) {
+            entries.assign((size_t) bucketSize << log2Buckets, TranspositionEntry{0, 0});
+            bucketMask = ((size_t) 1 << log2Buckets) - 1;
+        }
+        void clear() {
+            std::fill(entries.begin(), entries.end(), TranspositionEntry{0, 0});
+        }
+        bool visit(uint64_t key, int depth) {
+            // True if the state has not been visited, or has only been visited after more steps
+            key |= 1; // Key 0 marks an empty entry
+            TranspositionEntry* bucket = entries.data() + (size_t) ((key >> 32) & bucketMask) * bucketSize;
+            TranspositionEntry* replaced = bucket;
+            for (int k = 0; k < bucketSize; k++) {
+                if (bucket[k].key == key) {
+                    if (bucket[k].depth <= depth) {
+                        return false;
+                    }
+                    bucket[k].depth = depth;
+                    return true;
+                }
+                if (bucket[k].key == 0 || (replaced->key != 0 && bucket[k].depth > replaced->depth)) {
+                    replaced = bucket + k;
+                }
+            }
+            *replaced = TranspositionEntry{key, depth};
+            return true;
+        }
+    private:
+        class TranspositionEntry {
+            public:
+                uint64_t key;
+                int depth;
+        };
+        static constexpr int bucketSize = 4;
+        std::vector<TranspositionEntry> entries;
+        size_t bucketMask;
+};
+
+inline uint64_t mixStateHash(uint64_t hash, uint64_t value) {
+    hash = (hash ^ value) * 0xBF58476D1CE4E5B9ULL;
+    return hash ^ (hash >> 31);
+}
+
+// Hash of an expression together with the variables in use
+inline uint64_t stateHash(const int f[], int fStop, const VariableRecord* variables, int variableCount) {
+    uint64_t hash = (uint64_t) fStop;
+    for (int i = 0; i < fStop; i++) {
+        hash = mixStateHash(hash, (uint64_t) (uint32_t) f[i]);
+    }
+    for (int v = 0; v < variableCount; v++) {
+        const VariableRecord& record = variables[v];
+        hash = mixStateHash(hash, ((uint64_t) (uint32_t) record.name << 32) | (uint32_t) record.count);
+        hash = mixStateHash(hash, ((uint64_t) (uint32_t) record.type << 32) ^ ((uint64_t) (uint32_t) record.a << 16) ^ (uint32_t) record.b);
+    }
+    return hash;
+}
+
+// Correct steps from a state of a search, where each step from the MoveGenerator is confirmed by a ProofChecker
+// that also gives the variables in use after the step
+template <class LawSet>
+class StepExpander {
+    public:
+        void initialVariables(int f[], std::vector<VariableRecord>& variables);
+        MoveGenerator<LawSet>& generator();
+        template <class Visit> void expand(int f[], int fStop, int arrayLength, const VariableRecord* variables, int variableCount, Visit visit);
+    private:
+        ProofChecker<LawSet> checker;
+        MoveGenerator<LawSet> moves;
+        std::vector<int> next;
+        std::vector<VariableRecord> nextVariables;
+};
+
+template <class LawSet>
+void StepExpander<LawSet>::initialVariables(int f[], std::vector<VariableRecord>& variables) {
+    checker.storeInitialVariables(f);
+    checker.variables().save(variables);
+}
+
+template <class LawSet>
+MoveGenerator<LawSet>& StepExpander<LawSet>::generator() {
+    return moves;
+}
+
+template <class LawSet>
+template <class Visit>
+void StepExpander<LawSet>::expand(int f[], int fStop, int arrayLength, const VariableRecord* variables, int variableCount, Visit visit) {
+    // The expression is in an array of arrayLength symbols padded with STOP, and so is every next expression,
+    // which the visitor receives with the law and index of its step and its variables
+    next.resize(arrayLength);
+    checker.variables().restore(variables, variableCount);
+    moves.generate(f, fStop, variables, variableCount,
+        [&](int law, int index, const int* replacement, int replacementLength, int replacedLength) {
+            int gStop = fStop - replacedLength + replacementLength;
+            if (gStop >= arrayLength) {
+                return;
+            }
+            std::copy(f, f + index, next.begin());
+            std::copy(replacement, replacement + replacementLength, next.begin() + index);
+            std::copy(f + index + replacedLength, f + fStop, next.begin() + index + replacementLength);
+            std::fill(next.begin() + gStop, next.end(), STOP);
+            if (!checker.isTransformationByLaw(f, next.data(), arrayLength, law)) {
+                // The matchers only update the variables when a step is correct
+                return;
+            }
+            checker.variables().save(nextVariables);
+            checker.variables().restore(variables, variableCount);
+            visit(law, index, (const int*) next.data(), gStop, (const std::vector<VariableRecord>&) nextVariables);
+        });
+}
+
+// Best-first search in order of steps taken plus a lower bound on the steps left, which is A* with an admissible
+// bound from SearchBounds.h. States reached again in no fewer steps are skipped through a transposition table,
+// and the search gives up once it has stored a limited number of states
+template <class LawSet, class Bound = LengthBound>
+class ProofSearch {
+    public:
+        ProofSearch();
+        void setMaxLength(int length);
+        void setMaxDepth(int depth);
+        void setNodeLimit(size_t limit);
+        void setTableSize(int log2Buckets);
+        Bound& lowerBound();
+        bool findProof(int formula[], int fLength, int target, SearchProof* proof);
+        size_t nodesExpanded() const;
+        size_t nodesGenerated() const;
+        double nodesPerSecond() const;
+    private:
+        // A state of the search, whose expression and variables are stored in shared pools
+        class SearchNode {
+            public:
+                int parent;
+                int law;
+                int depth;
+                int formulaStart;
+                int formulaStop;
+                int variablesStart;
+                int variableCount;
+        };
+        class OpenEntry {
+            public:
+                int estimate; // Steps taken plus the lower bound on the steps left
+                int depth;
+                int node;
+                bool operator<(const OpenEntry& other) const {
+                    // The lowest estimate first, and the deepest state among equal estimates
+                    return estimate != other.estimate ? estimate > other.estimate : depth < other.depth;
+                }
+        };
+        StepExpander<LawSet> steps;
+        Bound bound;
+        TranspositionTable visited;
+        int maxLength; // Longest expression, or 0 for 8 symbols more than the initial expression
+        int maxDepth;
+        size_t nodeLimit;
+        size_t expanded;
+        double seconds;
+        std::vector<SearchNode> nodes;
+        std::vector<int> formulaPool;
+        std::vector<VariableRecord> variablePool;
+        int addNode(int parent, int law, int depth, const int f[], int fStop, const std::vector<VariableRecord>& variables);
+        void buildProof(int goal, int arrayLength, SearchProof* proof);
+};
+
+template <class LawSet, class Bound>
+ProofSearch<LawSet, Bound>::ProofSearch() {
+    maxLength = 0;
+    maxDepth = 64;
+    nodeLimit = 1 << 20;
+    expanded = 0;
+    seconds = 0;
+}
+
+template <class LawSet, class Bound>
+void ProofSearch<LawSet, Bound>::setMaxLength(int length) {
+    maxLength = length;
+}
+
+template <class LawSet, class Bound>
+void ProofSearch<LawSet, Bound>::setMaxDepth(int depth) {
+    maxDepth = depth;
+}
+
+template <class LawSet, class Bound>
+void ProofSearch<LawSet, Bound>::setNodeLimit(size_t limit) {
+    nodeLimit = limit;
+}
+
+template <class LawSet, class Bound>
+void ProofSearch<LawSet, Bound>::setTableSize(int log2Buckets) {
+    visited.resize(log2Buckets);
+}
+
+template <class LawSet, class Bound>
+Bound& ProofSearch<LawSet, Bound>::lowerBound() {
+    return bound;
+}
+
+template <class LawSet, class Bound>
+size_t ProofSearch<LawSet, Bound>::nodesExpanded() const {
+    return expanded;
+}
+
+template <class LawSet, class Bound>
+size_t ProofSearch<LawSet, Bound>::nodesGenerated() const {
+    return nodes.size();
+}
+
+template <class LawSet, class Bound>
+double ProofSearch<LawSet, Bound>::nodesPerSecond() const {
+    return seconds > 0 ? expanded / seconds : 0;
+}
+
+template <class LawSet, class Bound>
+int ProofSearch<LawSet, Bound>::addNode(int parent, int law, int depth, const int f[], int fStop, const std::vector<VariableRecord>& variables) {
+    nodes.push_back(SearchNode{parent, law, depth, (int) formulaPool.size(), fStop, (int) variablePool.size(), (int) variables.size()});
+    formulaPool.insert(formulaPool.end(), f, f + fStop);
+    variablePool.insert(variablePool.end(), variables.begin(), variables.end());
+    return (int) nodes.size() - 1;
+}
+
+template <class LawSet, class Bound>
+bool ProofSearch<LawSet, Bound>::findProof(int formula[], int fLength, int target, SearchProof* proof) {
+    int fStop = indexOfStop(formula, fLength);
+    if (fStop < 1 || (target != TRUE && target != FALSE)) {
+        // The Boolean expression must not be empty, and the target must be a truth value
+        return false;
+    }
+    int longest = maxLength > 0 ? maxLength : fStop + 8;
+    if (fStop > longest) {
+        return false;
+    }
+    bound.prepare(longest);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    // Every expression of the search and of the proof is in an array with room for the longest expression and STOP
+    int arrayLength = longest + 1;
+    std::vector<int> f(arrayLength, STOP);
+    std::copy(formula, formula + fStop, f.begin());
+    std::vector<VariableRecord> variables;
+    steps.initialVariables(f.data(), variables);
+    nodes.clear();
+    formulaPool.clear();
+    variablePool.clear();
+    visited.clear();
+    expanded = 0;
+    std::priority_queue<OpenEntry> open;
+    visited.visit(stateHash(f.data(), fStop, variables.data(), (int) variables.size()), 0);
+    open.push(OpenEntry{bound.estimate(f.data(), fStop, target), 0, addNode(-1, noLaw, 0, f.data(), fStop, variables)});
+    bool found = false;
+    bool full = false;
+    while (!open.empty() && !found && !full) {
+        int current = open.top().node;
+        open.pop();
+        SearchNode node = nodes[current];
+        const int* symbols = formulaPool.data() + node.formulaStart;
+        if (node.depth > 0 && node.formulaStop == 1 && symbols[0] == target) {
+            buildProof(current, arrayLength, proof);
+            found = true;
+            break;
+        }
+        if (node.depth >= maxDepth) {
+            continue;
+        }
+        expanded++;
+        std::fill(f.begin(), f.end(), STOP);
+        std::copy(symbols, symbols + node.formulaStop, f.begin());
+        variables.assign(variablePool.begin() + node.variablesStart, variablePool.begin() + node.variablesStart + node.variableCount);
+        steps.expand(f.data(), node.formulaStop, arrayLength, variables.data(), node.variableCount,
+            [&](int law, int index, const int g[], int gStop, const std::vector<VariableRecord>& nextVariables) {
+                (void) index;
+                if (full || !visited.visit(stateHash(g, gStop, nextVariables.data(), (int) nextVariables.size()), node.depth + 1)) {
+                    return;
+                }
+                if (nodes.size() >= nodeLimit) {
+                    // Out of memory for states
+                    full = true;
+                    return;
+                }
+                int child = addNode(current, law, node.depth + 1, g, gStop, nextVariables);
+                open.push(OpenEntry{node.depth + 1 + bound.estimate(g, gStop, target), node.depth + 1, child});
+            });
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return found;
+}
+
+template <class LawSet, class Bound>
+void ProofSearch<LawSet, Bound>::buildProof(int goal, int arrayLength, SearchProof* proof) {
+    if (proof == nullptr) {
+        return;
+    }
+    std::vector<int> path;
+    for (int n = goal; n >= 0; n = nodes[n].parent) {
+        path.push_back(n);
+    }
+    std::reverse(path.begin(), path.end());
+    proof->fLength = arrayLength;
+    proof->formula.assign(arrayLength, STOP);
+    std::copy(formulaPool.begin() + nodes[path[0]].formulaStart, formulaPool.begin() + nodes[path[0]].formulaStart + nodes[path[0]].formulaStop, proof->formula.begin());
+    proof->laws.clear();
+    proof->formulas.clear();
+    for (size_t k = 1; k < path.size(); k++) {
+        const SearchNode& node = nodes[path[k]];
+        proof->laws.push_back(node.law);
+        proof->formulas.push_back(std::vector<int>(arrayLength, STOP));
+        std::copy(formulaPool.begin() + node.formulaStart, formulaPool.begin() + node.formulaStart + node.formulaStop, proof->formulas.back().begin());
+    }
+}
+
+// Iterative deepening A*, which repeats a depth-first search with a growing limit on the steps taken plus the
+// lower bound on the steps left. It only stores the states on the current path and their next states, so its
+// memory is linear in the length of the proof, and it skips states that are already on the path
+template <class LawSet, class Bound = LengthBound>
+class DeepeningProofSearch {
+    public:
+        DeepeningProofSearch();
+        void setMaxLength(int length);
+        void setMaxDepth(int depth);
+        Bound& lowerBound();
+        bool findProof(int formula[], int fLength, int target, SearchProof* proof);
+        size_t nodesExpanded() const;
+        double nodesPerSecond() const;
+    private:
+        // Next states of a state on the path, in order of their lower bounds
+        class DeepeningLevel {
+            public:
+                std::vector<int> formulas; // arrayLength symbols for each next state
+                std::vector<int> laws;
+                std::vector<int> stops;
+                std::vector<int> estimates;
+                std::vector<int> variablesStarts;
+                std::vector<VariableRecord> variables;
+                std::vector<int> order;
+        };
+        StepExpander<LawSet> steps;
+        Bound bound;
+        int maxLength; // Longest expression, or 0 for 8 symbols more than the initial expression
+        int maxDepth;
+        int arrayLength;
+        int target;
+        size_t expanded;
+        double seconds;
+        std::vector<DeepeningLevel> levels;
+        std::vector<uint64_t> pathHashes;
+        std::vector<int> pathLaws;
+        std::vector<int*> pathFormulas;
+        int goalDepth;
+        static constexpr int foundProof = -1;
+        int deepen(int f[], int fStop, const VariableRecord* variables, int variableCount, int depth, int limit);
+};
+
+template <class LawSet, class Bound>
+DeepeningProofSearch<LawSet, Bound>::DeepeningProofSearch() {
+    maxLength = 0;
+    maxDepth = 64;
+    arrayLength = 0;
+    target = TRUE;
+    goalDepth = 0;
+    expanded = 0;
+    seconds = 0;
+}
+
+template <class LawSet, class Bound>
+void DeepeningProofSearch<LawSet, Bound>::setMaxLength(int length) {
+    maxLength = length;
+}
+
+template <class LawSet, class Bound>
+void DeepeningProofSearch<LawSet, Bound>::setMaxDepth(int depth) {
+    maxDepth = depth;
+}
+
+template <class LawSet, class Bound>
+Bound& DeepeningProofSearch<LawSet, Bound>::lowerBound() {
+    return bound;
+}
+
+template <class LawSet, class Bound>
+size_t DeepeningProofSearch<LawSet, Bound>::nodesExpanded() const {
+    return expanded;
+}
+
+template <class LawSet, class Bound>
+double DeepeningProofSearch<LawSet, Bound>::nodesPerSecond() const {
+    return seconds > 0 ? expanded / seconds : 0;
+}
+
+template <class LawSet, class Bound>
+int DeepeningProofSearch<LawSet, Bound>::deepen(int f[], int fStop, const VariableRecord* variables, int variableCount, int depth, int limit) {
+    // Returns foundProof, or the lowest estimate above the limit of the states that were cut off
+    if (depth > 0 && fStop == 1 && f[0] == target) {
+        goalDepth = depth;
+        return foundProof;
+    }
+    if (depth >= maxDepth) {
+        return INT32_MAX;
+    }
+    expanded++;
+    DeepeningLevel& level = levels[depth];
+    level.formulas.clear();
+    level.laws.clear();
+    level.stops.clear();
+    level.estimates.clear();
+    level.variablesStarts.clear();
+    level.variables.clear();
+    steps.expand(f, fStop, arrayLength, variables, variableCount,
+        [&](int law, int index, const int g[], int gStop, const std::vector<VariableRecord>& nextVariables) {
+            (void) index;
+            uint64_t hash = stateHash(g, gStop, nextVariables.data(), (int) nextVariables.size());
+            if (std::find(pathHashes.begin(), pathHashes.begin() + depth + 1, hash) != pathHashes.begin() + depth + 1) {
+                // A cycle back to a state on the path
+                return;
+            }
+            level.formulas.insert(level.formulas.end(), g, g + arrayLength);
+            level.laws.push_back(law);
+            level.stops.push_back(gStop);
+            level.estimates.push_back(depth + 1 + bound.estimate(g, gStop, target));
+            level.variablesStarts.push_back((int) level.variables.size());
+            level.variables.insert(level.variables.end(), nextVariables.begin(), nextVariables.end());
+        });
+    int count = (int) level.laws.size();
+    level.variablesStarts.push_back((int) level.variables.size());
+    level.order.resize(count);
+    for (int k = 0; k < count; k++) {
+        level.order[k] = k;
+    }
+    std::stable_sort(level.order.begin(), level.order.end(), [&](int x, int y) { return level.estimates[x] < level.estimates[y]; });
+    int nextLimit = INT32_MAX;
+    for (int k : level.order) {
+        if (level.estimates[k] > limit) {
+            nextLimit = std::min(nextLimit, level.estimates[k]);
+            // The rest are in order of their estimates
+            break;
+        }
+        int* g = level.formulas.data() + (size_t) k * arrayLength;
+        pathHashes[depth + 1] = stateHash(g, level.stops[k], level.variables.data() + level.variablesStarts[k], level.variablesStarts[k + 1] - level.variablesStarts[k]);
+        pathLaws[depth + 1] = level.laws[k];
+        pathFormulas[depth + 1] = g;
+        int result = deepen(g, level.stops[k], level.variables.data() + level.variablesStarts[k], level.variablesStarts[k + 1] - level.variablesStarts[k], depth + 1, limit);
+        if (result == foundProof) {
+            return foundProof;
+        }
+        nextLimit = std::min(nextLimit, result);
+    }
+    return nextLimit;
+}
+
+template <class LawSet, class Bound>
+bool DeepeningProofSearch<LawSet, Bound>::findProof(int formula[], int fLength, int searchTarget, SearchProof* proof) {
+    int fStop = indexOfStop(formula, fLength);
+    if (fStop < 1 || (searchTarget != TRUE && searchTarget != FALSE)) {
+        // The Boolean expression must not be empty, and the target must be a truth value
+        return false;
+    }
+    int longest = maxLength > 0 ? maxLength : fStop + 8;
+    if (fStop > longest) {
+        return false;
+    }
+    bound.prepare(longest);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    target = searchTarget;
+    arrayLength = longest + 1;
+    std::vector<int> f(arrayLength, STOP);
+    std::copy(formula, formula + fStop, f.begin());
+    std::vector<VariableRecord> variables;
+    steps.initialVariables(f.data(), variables);
+    levels.resize(maxDepth + 1);
+    pathHashes.assign(maxDepth + 1, 0);
+    pathLaws.assign(maxDepth + 1, noLaw);
+    pathFormulas.assign(maxDepth + 1, nullptr);
+    pathHashes[0] = stateHash(f.data(), fStop, variables.data(), (int) variables.size());
+    expanded = 0;
+    int limit = bound.estimate(f.data(), fStop, target);
+    int result = limit;
+    while (result != foundProof && limit <= maxDepth) {
+        result = deepen(f.data(), fStop, variables.data(), (int) variables.size(), 0, limit);
+        limit = result;
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (result != foundProof) {
+        return false;
+    }
+    if (proof != nullptr) {
+        proof->fLength = arrayLength;
+        proof->formula = f;
+        proof->laws.clear();
+        proof->formulas.clear();
+        for (int depth = 1; depth <= goalDepth; depth++) {
+            proof->laws.push_back(pathLaws[depth]);
+            proof->formulas.push_back(std::vector<int>(pathFormulas[depth], pathFormulas[depth] + arrayLength));
+        }
+    }
+    return true;
+}
+
+#endif
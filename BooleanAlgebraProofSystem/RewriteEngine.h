@@ -0,0 +1,204 @@
+#ifndef REWRITE_ENGINE_H
+#define REWRITE_ENGINE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "ProofEngine.h"
+#include "ProofSearch.h"
+
+// Engine that applies steps of a law set to one Boolean expression in place, where a step replaces
+// replacedLength symbols from an index by the symbols of a replacement. Each step is checked by a ProofChecker on
+// the symbols around the index only, since the symbols before and after are unchanged, and its variable updates
+// go to a journal. The undo entry of a step holds the replaced symbols and the size of the journal before the
+// step, so undo takes time in the size of the change and copies no expression. Steps that change the length
+// move the symbols after the replaced ones in the buffer
+
+// Most symbols that a law replaces or puts in place, which is a + (b * c) = (a + b) * (a + c)
+const int maxRewriteSymbols = 7;
+
+// Step of a law at an index, as a replacement of symbols
+class Rewrite {
+    public:
+        int law;
+        int index;
+        int replacedLength;
+        int replacementLength;
+        int replacement[maxRewriteSymbols];
+};
+
+template <class LawSet>
+class RewriteEngine {
+    public:
+        RewriteEngine();
+        RewriteEngine(const RewriteEngine&) = delete;
+        RewriteEngine& operator=(const RewriteEngine&) = delete;
+        bool load(int f[], int fLength);
+        const int* formula() const;
+        int length() const;
+        VariableTable& variables();
+        void steps(std::vector<Rewrite>& rewrites);
+        bool apply(int law, int index, const int replacement[], int replacementLength, int replacedLength);
+        bool apply(const Rewrite& rewrite);
+        size_t depth() const;
+        void undo();
+        void undoTo(size_t stepDepth);
+        size_t journalSize() const;
+    private:
+        class UndoEntry {
+            public:
+                int index;
+                int replacementLength;
+                int replacedLength;
+                size_t replacedStart; // Replaced symbols in the stack of replaced symbols
+                size_t journalMark;
+        };
+        // Symbols after a step that the matchers may look at, in addition to the replaced ones
+        static constexpr int lookahead = 8;
+        ProofChecker<LawSet> checker;
+        MoveGenerator<LawSet> moves;
+        std::vector<int> buffer; // Expression and STOP
+        int fStop;
+        std::vector<VariableRecord> journal;
+        std::vector<UndoEntry> entries;
+        std::vector<int> replacedSymbols;
+        std::vector<int> previousWindow;
+        std::vector<int> nextWindow;
+        std::vector<VariableRecord> records;
+        void splice(int index, int replacedLength, const int replacement[], int replacementLength);
+};
+
+template <class LawSet>
+RewriteEngine<LawSet>::RewriteEngine() {
+    fStop = 0;
+    buffer.assign(1, STOP);
+    checker.variables().setJournal(&journal);
+}
+
+template <class LawSet>
+bool RewriteEngine<LawSet>::load(int f[], int fLength) {
+    // Copies the expression once, and forgets every step
+    int stop = indexOfStop(f, fLength);
+    if (stop < 1) {
+        return false;
+    }
+    fStop = stop;
+    buffer.assign(f, f + fStop);
+    buffer.push_back(STOP);
+    checker.variables().setJournal(nullptr);
+    checker.storeInitialVariables(buffer.data());
+    checker.variables().setJournal(&journal);
+    journal.clear();
+    entries.clear();
+    replacedSymbols.clear();
+    return true;
+}
+
+template <class LawSet>
+const int* RewriteEngine<LawSet>::formula() const {
+    return buffer.data();
+}
+
+template <class LawSet>
+int RewriteEngine<LawSet>::length() const {
+    return fStop;
+}
+
+template <class LawSet>
+VariableTable& RewriteEngine<LawSet>::variables() {
+    return checker.variables();
+}
+
+template <class LawSet>
+size_t RewriteEngine<LawSet>::depth() const {
+    return entries.size();
+}
+
+template <class LawSet>
+size_t RewriteEngine<LawSet>::journalSize() const {
+    return journal.size();
+}
+
+template <class LawSet>
+void RewriteEngine<LawSet>::steps(std::vector<Rewrite>& rewrites) {
+    // Steps of the MoveGenerator from the expression, which are checked when they are applied
+    rewrites.clear();
+    checker.variables().save(records);
+    moves.generate(buffer.data(), fStop, records.data(), (int) records.size(),
+        [&](int law, int index, const int* replacement, int replacementLength, int replacedLength) {
+            Rewrite rewrite;
+            rewrite.law = law;
+            rewrite.index = index;
+            rewrite.replacedLength = replacedLength;
+            rewrite.replacementLength = replacementLength;
+            std::copy(replacement, replacement + replacementLength, rewrite.replacement);
+            rewrites.push_back(rewrite);
+        });
+}
+
+template <class LawSet>
+void RewriteEngine<LawSet>::splice(int index, int replacedLength, const int replacement[], int replacementLength) {
+    int change = replacementLength - replacedLength;
+    if (change > 0) {
+        buffer.resize(fStop + 1 + change);
+        std::copy_backward(buffer.begin() + index + replacedLength, buffer.begin() + fStop + 1, buffer.begin() + fStop + 1 + change);
+    } else if (change < 0) {
+        std::copy(buffer.begin() + index + replacedLength, buffer.begin() + fStop + 1, buffer.begin() + index + replacementLength);
+        buffer.resize(fStop + 1 + change);
+    }
+    std::copy(replacement, replacement + replacementLength, buffer.begin() + index);
+    fStop += change;
+}
+
+template <class LawSet>
+bool RewriteEngine<LawSet>::apply(int law, int index, const int replacement[], int replacementLength, int replacedLength) {
+    if (law < 0 || law >= LawSet::lawCount || index < 0 || replacedLength < 1 || replacementLength < 1
+        || index + replacedLength > fStop || replacementLength > maxRewriteSymbols || replacedLength > maxRewriteSymbols) {
+        return false;
+    }
+    // Windows from the index of the replaced symbols and of the replacement, with the same symbols after them
+    int after = std::min(lookahead, fStop - index - replacedLength);
+    int windowLength = std::max(replacedLength, replacementLength) + after + 1;
+    previousWindow.assign(windowLength, STOP);
+    nextWindow.assign(windowLength, STOP);
+    std::copy(buffer.begin() + index, buffer.begin() + index + replacedLength + after, previousWindow.begin());
+    std::copy(replacement, replacement + replacementLength, nextWindow.begin());
+    std::copy(buffer.begin() + index + replacedLength, buffer.begin() + index + replacedLength + after, nextWindow.begin() + replacementLength);
+    size_t journalMark = journal.size();
+    if (!checker.isTransformationByLaw(previousWindow.data(), nextWindow.data(), windowLength, law)) {
+        // The matchers only update the variables when a step is correct, but they may have saved records
+        checker.variables().undo(journalMark);
+        return false;
+    }
+    entries.push_back(UndoEntry{index, replacementLength, replacedLength, replacedSymbols.size(), journalMark});
+    replacedSymbols.insert(replacedSymbols.end(), buffer.begin() + index, buffer.begin() + index + replacedLength);
+    splice(index, replacedLength, replacement, replacementLength);
+    return true;
+}
+
+template <class LawSet>
+bool RewriteEngine<LawSet>::apply(const Rewrite& rewrite) {
+    return apply(rewrite.law, rewrite.index, rewrite.replacement, rewrite.replacementLength, rewrite.replacedLength);
+}
+
+template <class LawSet>
+void RewriteEngine<LawSet>::undo() {
+    if (entries.empty()) {
+        return;
+    }
+    UndoEntry entry = entries.back();
+    entries.pop_back();
+    splice(entry.index, entry.replacementLength, replacedSymbols.data() + entry.replacedStart, entry.replacedLength);
+    replacedSymbols.resize(entry.replacedStart);
+    checker.variables().undo(entry.journalMark);
+}
+
+template <class LawSet>
+void RewriteEngine<LawSet>::undoTo(size_t stepDepth) {
+    while (entries.size() > stepDepth) {
+        undo();
+    }
+}
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef SEARCH_BOUNDS_H
+#define SEARCH_BOUNDS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "ProofEngine.h"
+
+// Admissible lower bounds on the number of steps from a Boolean expression to TRUE or FALSE, for the proof searches.
+// A bound has prepare, which a search calls with its longest expression before it starts, and estimate
+
+// Every law changes the length of an expression by at most 4 symbols, such as absorption
+class LengthBound {
+    public:
+        void prepare(int longest) {
+            (void) longest;
+        }
+        int estimate(const int f[], int fStop, int target) const {
+            (void) f;
+            (void) target;
+            return (fStop - 1 + 3) / 4;
+        }
+};
+
+// Pattern database over an abstraction of expressions, where the pattern of an expression is its number of NOT,
+// OR, AND, TRUE and FALSE symbols. Every step of a law changes the pattern by the counts of the two sides of
+// the law, for operands that are TRUE, FALSE or variables, so the fewest steps between patterns, found by a
+// breadth-first search from the pattern of the target, is a lower bound for the expressions
+template <class LawSet>
+class PatternDatabaseBound {
+    public:
+        PatternDatabaseBound();
+        void prepare(int longest);
+        int estimate(const int f[], int fStop, int target) const;
+        int longestPattern() const;
+    private:
+        // Symbols counted in a pattern, where the variables follow from the others
+        static constexpr int countedSymbols = 5;
+        class PatternMove {
+            public:
+                int required[countedSymbols]; // Counts of the side that is replaced
+                int change[countedSymbols];
+        };
+        int longest;
+        int operatorLimit; // Most OR or AND symbols in an expression of the longest length
+        int valueLimit; // Most TRUE or FALSE symbols
+        std::vector<PatternMove> patternMoves;
+        std::vector<uint8_t> distances[2]; // Steps from each pattern to FALSE and to TRUE, or unreachable
+        static constexpr uint8_t unreachable = 255;
+        static int slotOf(int symbol);
+        int indexOf(const int counts[countedSymbols]) const;
+        bool isPattern(const int counts[countedSymbols]) const;
+        void addSides(const std::vector<int>& previous, const std::vector<int>& next);
+        void addLaw(int matcher, int op);
+        void search(int target, std::vector<uint8_t>& distance);
+};
+
+template <class LawSet>
+PatternDatabaseBound<LawSet>::PatternDatabaseBound() {
+    longest = 0;
+    operatorLimit = 0;
+    valueLimit = 0;
+}
+
+template <class LawSet>
+int PatternDatabaseBound<LawSet>::slotOf(int symbol) {
+    // NOT, OR, AND, FALSE and TRUE are counted, and variables are not
+    return symbol >= NOT && symbol <= TRUE ? symbol - NOT : -1;
+}
+
+template <class LawSet>
+int PatternDatabaseBound<LawSet>::indexOf(const int counts[countedSymbols]) const {
+    int index = counts[0];
+    index = index * (operatorLimit + 1) + counts[1];
+    index = index * (operatorLimit + 1) + counts[2];
+    index = index * (valueLimit + 1) + counts[3];
+    return index * (valueLimit + 1) + counts[4];
+}
+
+template <class LawSet>
+bool PatternDatabaseBound<LawSet>::isPattern(const int counts[countedSymbols]) const {
+    // Counts of an expression within the longest length, which has one more operand than OR and AND symbols
+    int operators = counts[1] + counts[2];
+    int values = counts[3] + counts[4];
+    for (int k = 0; k < countedSymbols; k++) {
+        if (counts[k] < 0) {
+            return false;
+        }
+    }
+    return values <= operators + 1 && counts[0] + 2 * operators + 1 <= longest;
+}
+
+template <class LawSet>
+void PatternDatabaseBound<LawSet>::addSides(const std::vector<int>& previous, const std::vector<int>& next) {
+    // Both directions of a law, since every law is two-way
+    PatternMove forward = {};
+    PatternMove backward = {};
+    for (int symbol : previous) {
+        if (slotOf(symbol) >= 0) {
+            forward.required[slotOf(symbol)]++;
+            forward.change[slotOf(symbol)]--;
+        }
+    }
+    for (int symbol : next) {
+        if (slotOf(symbol) >= 0) {
+            backward.required[slotOf(symbol)]++;
+            forward.change[slotOf(symbol)]++;
+        }
+    }
+    for (int k = 0; k < countedSymbols; k++) {
+        backward.change[k] = -forward.change[k];
+    }
+    for (const PatternMove& move : {forward, backward}) {
+        bool known = false;
+        for (const PatternMove& added : patternMoves) {
+            known = known || (std::equal(move.required, move.required + countedSymbols, added.required)
+                && std::equal(move.change, move.change + countedSymbols, added.change));
+        }
+        if (!known) {
+            patternMoves.push_back(move);
+        }
+    }
+}
+
+template <class LawSet>
+void PatternDatabaseBound<LawSet>::addLaw(int matcher, int op) {
+    int other = otherOperator(op);
+    int identity = identityElement(op);
+    int dominating = dominatingElement(op);
+    // Each operand is FALSE, TRUE or a variable, which stands for every variable
+    const int operands[3] = {FALSE, TRUE, minVariable};
+    for (int a : operands) {
+        if (matcher == identityMatcher) {
+            addSides({op, a, identity}, {a});
+        } else if (matcher == idempotentMatcher) {
+            addSides({op, a, a}, {a});
+        } else if (matcher == complementMatcher) {
+            addSides({op, a, NOT, a}, {dominating});
+        } else if (matcher == dominationMatcher) {
+            addSides({op, a, dominating}, {dominating});
+        } else if (matcher == doubleNegationMatcher) {
+            addSides({NOT, NOT, a}, {a});
+        } else if (matcher == substitutionMatcher) {
+            addSides({NOT, a}, {minVariable});
+        }
+        for (int b : operands) {
+            if (matcher == deMorganMatcher) {
+                addSides({NOT, op, a, b}, {other, NOT, a, NOT, b});
+            } else if (matcher == absorptionMatcher) {
+                addSides({op, a, other, a, b}, {a});
+            } else if (matcher == substitutionMatcher) {
+                addSides({OR, a, b}, {minVariable});
+                addSides({AND, a, b}, {minVariable});
+            }
+            for (int c : operands) {
+                if (matcher == distributiveMatcher) {
+                    addSides({op, a, other, b, c}, {other, op, a, b, op, a, c});
+                }
+            }
+        }
+    }
+    if (matcher == negationMatcher) {
+        addSides({NOT, TRUE}, {FALSE});
+        addSides({NOT, FALSE}, {TRUE});
+    }
+    // Commutative and associative steps keep the pattern
+}
+
+template <class LawSet>
+void PatternDatabaseBound<LawSet>::search(int target, std::vector<uint8_t>& distance) {
+    int size = (longest + 1) * (operatorLimit + 1) * (operatorLimit + 1) * (valueLimit + 1) * (valueLimit + 1);
+    distance.assign(size, unreachable);
+    int goal[countedSymbols] = {0, 0, 0, target == FALSE ? 1 : 0, target == TRUE ? 1 : 0};
+    std::deque<int> queue; // Packed patterns in order of distance
+    distance[indexOf(goal)] = 0;
+    queue.push_back(indexOf(goal));
+    int limits[countedSymbols] = {longest + 1, operatorLimit + 1, operatorLimit + 1, valueLimit + 1, valueLimit + 1};
+    while (!queue.empty()) {
+        int index = queue.front();
+        queue.pop_front();
+        int counts[countedSymbols];
+        int rest = index;
+        for (int k = countedSymbols - 1; k >= 0; k--) {
+            counts[k] = rest % limits[k];
+            rest /= limits[k];
+        }
+        int steps = distance[index];
+        if (steps + 1 >= unreachable) {
+            continue;
+        }
+        for (const PatternMove& move : patternMoves) {
+            int next[countedSymbols];
+            bool applies = true;
+            for (int k = 0; k < countedSymbols; k++) {
+                applies = applies && counts[k] >= move.required[k];
+                next[k] = counts[k] + move.change[k];
+            }
+            if (!applies || !isPattern(next)) {
+                continue;
+            }
+            int nextIndex = indexOf(next);
+            if (distance[nextIndex] == unreachable) {
+                distance[nextIndex] = (uint8_t) (steps + 1);
+                queue.push_back(nextIndex);
+            }
+        }
+    }
+}
+
+template <class LawSet>
+void PatternDatabaseBound<LawSet>::prepare(int longestLength) {
+    // Steps through longer expressions than the search allows are not needed, but the database must cover every
+    // expression of the search, so it is only built again for a longer search
+    if (longestLength <= longest) {
+        return;
+    }
+    longest = longestLength;
+    operatorLimit = (longest - 1) / 2;
+    valueLimit = operatorLimit + 1;
+    patternMoves.clear();
+    for (int law = 0; law < LawSet::lawCount; law++) {
+        int matcher = LawSet::rules[law].matcher;
+        int form = LawSet::rules[law].form;
+        if (form != AND) {
+            addLaw(matcher, OR);
+        }
+        if (form != OR && matcher != doubleNegationMatcher && matcher != negationMatcher && matcher != substitutionMatcher) {
+            addLaw(matcher, AND);
+        }
+    }
+    search(FALSE, distances[0]);
+    search(TRUE, distances[1]);
+}
+
+template <class LawSet>
+int PatternDatabaseBound<LawSet>::estimate(const int f[], int fStop, int target) const {
+    int bound = LengthBound().estimate(f, fStop, target);
+    if (fStop > longest) {
+        return bound;
+    }
+    int counts[countedSymbols] = {0, 0, 0, 0, 0};
+    for (int i = 0; i < fStop; i++) {
+        if (slotOf(f[i]) >= 0) {
+            counts[slotOf(f[i])]++;
+        }
+    }
+    int steps = distances[target == TRUE ? 1 : 0][indexOf(counts)];
+    if (steps == unreachable) {
+        // No expression with this pattern has a proof within the longest length
+        return unreachable;
+    }
+    return std::max(bound, steps);
+}
+
+template <class LawSet>
+int PatternDatabaseBound<LawSet>::longestPattern() const {
+    return longest;
+}
+
+#endif
@@ -0,0 +1,293 @@
+#ifndef SYMBOL_KERNELS_H
+#define SYMBOL_KERNELS_H
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SYMBOL_KERNELS_X86 1
+#endif
+
+// Scanning kernels over arrays of 8, 16 or 32-bit symbols, with AVX-512, AVX2 and SSE2 versions that are chosen at
+// run time. Every kernel reads only the first n symbols of its arrays
+
+// Levels of kernels
+const int scalarKernels = 0;
+const int sse2Kernels = 1;
+const int avx2Kernels = 2;
+const int avx512Kernels = 3; // AVX-512F and AVX-512BW, which compares 8 and 16-bit symbols
+
+// Ranges shorter than this are scanned without calling through the dispatch table
+const int shortScan = 16;
+
+template <class Symbol>
+inline int scalarFirstMismatch(const Symbol* f, const Symbol* g, int n) {
+    for (int i = 0; i < n; i++) {
+        if (f[i] != g[i]) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <class Symbol>
+inline int scalarFindStop(const Symbol* f, int n) {
+    for (int i = 0; i < n; i++) {
+        if (f[i] == 0) {
+            return i;
+        }
+    }
+    return n;
+}
+
+#ifdef SYMBOL_KERNELS_X86
+
+template <class Symbol>
+inline int sse2FirstMismatch(const Symbol* f, const Symbol* g, int n) {
+    const int width = 16 / (int) sizeof(Symbol);
+    int i = 0;
+    for (; i + width <= n; i += width) {
+        __m128i a = _mm_loadu_si128((const __m128i*) (f + i));
+        __m128i b = _mm_loadu_si128((const __m128i*) (g + i));
+        __m128i equal;
+        if constexpr (sizeof(Symbol) == 1) {
+            equal = _mm_cmpeq_epi8(a, b);
+        } else if constexpr (sizeof(Symbol) == 2) {
+            equal = _mm_cmpeq_epi16(a, b);
+        } else {
+            equal = _mm_cmpeq_epi32(a, b);
+        }
+        unsigned int different = ~(unsigned int) _mm_movemask_epi8(equal) & 0xFFFFu;
+        if (different != 0) {
+            // Each symbol sets as many bits of the mask as it has bytes
+            return i + __builtin_ctz(different) / (int) sizeof(Symbol);
+        }
+    }
+    return i + scalarFirstMismatch(f + i, g + i, n - i);
+}
+
+template <class Symbol>
+inline int sse2FindStop(const Symbol* f, int n) {
+    const int width = 16 / (int) sizeof(Symbol);
+    __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + width <= n; i += width) {
+        __m128i a = _mm_loadu_si128((const __m128i*) (f + i));
+        __m128i stop;
+        if constexpr (sizeof(Symbol) == 1) {
+            stop = _mm_cmpeq_epi8(a, zero);
+        } else if constexpr (sizeof(Symbol) == 2) {
+            stop = _mm_cmpeq_epi16(a, zero);
+        } else {
+            stop = _mm_cmpeq_epi32(a, zero);
+        }
+        unsigned int found = (unsigned int) _mm_movemask_epi8(stop);
+        if (found != 0) {
+            return i + __builtin_ctz(found) / (int) sizeof(Symbol);
+        }
+    }
+    return i + scalarFindStop(f + i, n - i);
+}
+
+template <class Symbol>
+__attribute__((target("avx2"))) int avx2FirstMismatch(const Symbol* f, const Symbol* g, int n) {
+    const int width = 32 / (int) sizeof(Symbol);
+    int i = 0;
+    for (; i + width <= n; i += width) {
+        __m256i a = _mm256_loadu_si256((const __m256i*) (f + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*) (g + i));
+        __m256i equal;
+        if constexpr (sizeof(Symbol) == 1) {
+            equal = _mm256_cmpeq_epi8(a, b);
+        } else if constexpr (sizeof(Symbol) == 2) {
+            equal = _mm256_cmpeq_epi16(a, b);
+        } else {
+            equal = _mm256_cmpeq_epi32(a, b);
+        }
+        unsigned int different = ~(unsigned int) _mm256_movemask_epi8(equal);
+        if (different != 0) {
+            return i + __builtin_ctz(different) / (int) sizeof(Symbol);
+        }
+    }
+    return i + scalarFirstMismatch(f + i, g + i, n - i);
+}
+
+template <class Symbol>
+__attribute__((target("avx2"))) int avx2FindStop(const Symbol* f, int n) {
+    const int width = 32 / (int) sizeof(Symbol);
+    __m256i zero = _mm256_setzero_si256();
+    int i = 0;
+    for (; i + width <= n; i += width) {
+        __m256i a = _mm256_loadu_si256((const __m256i*) (f + i));
+        __m256i stop;
+        if constexpr (sizeof(Symbol) == 1) {
+            stop = _mm256_cmpeq_epi8(a, zero);
+        } else if constexpr (sizeof(Symbol) == 2) {
+            stop = _mm256_cmpeq_epi16(a, zero);
+        } else {
+            stop = _mm256_cmpeq_epi32(a, zero);
+        }
+        unsigned int found = (unsigned int) _mm256_movemask_epi8(stop);
+        if (found != 0) {
+            return i + __builtin_ctz(found) / (int) sizeof(Symbol);
+        }
+    }
+    return i + scalarFindStop(f + i, n - i);
+}
+
+template <class Symbol>
+__attribute__((target("avx512f,avx512bw"))) int avx512FirstMismatch(const Symbol* f, const Symbol* g, int n) {
+    const int width = 64 / (int) sizeof(Symbol);
+    int i = 0;
+    for (; i + width <= n; i += width) {
+        __m512i a = _mm512_loadu_si512((const void*) (f + i));
+        __m512i b = _mm512_loadu_si512((const void*) (g + i));
+        // One bit per symbol rather than per byte
+        uint64_t different;
+        if constexpr (sizeof(Symbol) == 1) {
+            different = _mm512_cmpneq_epi8_mask(a, b);
+        } else if constexpr (sizeof(Symbol) == 2) {
+            different = _mm512_cmpneq_epi16_mask(a, b);
+        } else {
+            different = _mm512_cmpneq_epi32_mask(a, b);
+        }
+        if (different != 0) {
+            return i + __builtin_ctzll(different);
+        }
+    }
+    if (i < n) {
+        // The tail is loaded with a mask, which does not touch the symbols after n
+        uint64_t tail = (~0ULL) >> (64 - (n - i));
+        uint64_t different;
+        if constexpr (sizeof(Symbol) == 1) {
+            different = _mm512_mask_cmpneq_epi8_mask(tail, _mm512_maskz_loadu_epi8(tail, f + i), _mm512_maskz_loadu_epi8(tail, g + i));
+        } else if constexpr (sizeof(Symbol) == 2) {
+            __mmask32 mask = (__mmask32) tail;
+            different = _mm512_mask_cmpneq_epi16_mask(mask, _mm512_maskz_loadu_epi16(mask, f + i), _mm512_maskz_loadu_epi16(mask, g + i));
+        } else {
+            __mmask16 mask = (__mmask16) tail;
+            different = _mm512_mask_cmpneq_epi32_mask(mask, _mm512_maskz_loadu_epi32(mask, f + i), _mm512_maskz_loadu_epi32(mask, g + i));
+        }
+        return i + (different != 0 ? __builtin_ctzll(different) : n - i);
+    }
+    return n;
+}
+
+template <class Symbol>
+__attribute__((target("avx512f,avx512bw"))) int avx512FindStop(const Symbol* f, int n) {
+    const int width = 64 / (int) sizeof(Symbol);
+    __m512i zero = _mm512_setzero_si512();
+    int i = 0;
+    for (; i + width <= n; i += width) {
+        __m512i a = _mm512_loadu_si512((const void*) (f + i));
+        uint64_t found;
+        if constexpr (sizeof(Symbol) == 1) {
+            found = _mm512_cmpeq_epi8_mask(a, zero);
+        } else if constexpr (sizeof(Symbol) == 2) {
+            found = _mm512_cmpeq_epi16_mask(a, zero);
+        } else {
+            found = _mm512_cmpeq_epi32_mask(a, zero);
+        }
+        if (found != 0) {
+            return i + __builtin_ctzll(found);
+        }
+    }
+    if (i < n) {
+        uint64_t tail = (~0ULL) >> (64 - (n - i));
+        uint64_t found;
+        if constexpr (sizeof(Symbol) == 1) {
+            found = _mm512_mask_cmpeq_epi8_mask(tail, _mm512_maskz_loadu_epi8(tail, f + i), zero);
+        } else if constexpr (sizeof(Symbol) == 2) {
+            found = _mm512_mask_cmpeq_epi16_mask((__mmask32) tail, _mm512_maskz_loadu_epi16((__mmask32) tail, f + i), zero);
+        } else {
+            found = _mm512_mask_cmpeq_epi32_mask((__mmask16) tail, _mm512_maskz_loadu_epi32((__mmask16) tail, f + i), zero);
+        }
+        return i + (found != 0 ? __builtin_ctzll(found) : n - i);
+    }
+    return n;
+}
+
+#endif
+
+inline int supportedKernelLevel() {
+#ifdef SYMBOL_KERNELS_X86
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx2")) {
+        return avx512Kernels;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return avx2Kernels;
+    }
+    // SSE2 is part of every x86-64 processor
+    return __builtin_cpu_supports("sse2") ? sse2Kernels : scalarKernels;
+#else
+    return scalarKernels;
+#endif
+}
+
+// Kernels of one symbol size, chosen once for the processor
+template <class Symbol>
+class SymbolKernels {
+    public:
+        int level;
+        int (*firstMismatch)(const Symbol* f, const Symbol* g, int n);
+        int (*findStop)(const Symbol* f, int n);
+        SymbolKernels() {
+            select(supportedKernelLevel());
+        }
+        void select(int kernelLevel) {
+            level = std::min(kernelLevel, supportedKernelLevel());
+            firstMismatch = scalarFirstMismatch<Symbol>;
+            findStop = scalarFindStop<Symbol>;
+#ifdef SYMBOL_KERNELS_X86
+            if (level == sse2Kernels) {
+                firstMismatch = sse2FirstMismatch<Symbol>;
+                findStop = sse2FindStop<Symbol>;
+            } else if (level == avx2Kernels) {
+                firstMismatch = avx2FirstMismatch<Symbol>;
+                findStop = avx2FindStop<Symbol>;
+            } else if (level >= avx512Kernels) {
+                firstMismatch = avx512FirstMismatch<Symbol>;
+                findStop = avx512FindStop<Symbol>;
+            }
+#endif
+        }
+};
+
+template <class Symbol>
+inline SymbolKernels<Symbol>& symbolKernels() {
+    static SymbolKernels<Symbol> kernels;
+    return kernels;
+}
+
+// Forces a lower level of kernels for every symbol size, such as for benchmarks, before any checking starts
+inline void selectKernelLevel(int kernelLevel) {
+    symbolKernels<uint8_t>().select(kernelLevel);
+    symbolKernels<uint16_t>().select(kernelLevel);
+    symbolKernels<int>().select(kernelLevel);
+}
+
+// Index of the first symbol where both arrays differ, or n if the first n symbols are the same
+template <class Symbol>
+inline int firstMismatch(const Symbol* f, const Symbol* g, int n) {
+    if (n < shortScan) {
+        return scalarFirstMismatch(f, g, n);
+    }
+    return symbolKernels<Symbol>().firstMismatch(f, g, n);
+}
+
+// Index of the first STOP symbol, or n if there is none in the first n symbols
+template <class Symbol>
+inline int findStop(const Symbol* f, int n) {
+    if (n < shortScan) {
+        return scalarFindStop(f, n);
+    }
+    return symbolKernels<Symbol>().findStop(f, n);
+}
+
+template <class Symbol>
+inline bool rangesEqual(const Symbol* f, const Symbol* g, int n) {
+    return firstMismatch(f, g, n) == n;
+}
+
+#endif
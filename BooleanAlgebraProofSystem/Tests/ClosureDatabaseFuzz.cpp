@@ -0,0 +1,289 @@
+// Compares ClosureDatabase with a forward breadth-first search on expressions of the closure and on random
+// expressions: the steps and the truth value that distance gives, and the proofs of findProof, which
+// isProofSequence must accept. Images with a corrupt header must not attach, and images with corrupt records
+// must still give only proofs that isProofSequence accepts
+// g++ -std=c++17 -O2 -I.. ClosureDatabaseFuzz.cpp -o ClosureDatabaseFuzz
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+#include "../PE21LF.h"
+#include "../ClosureDatabase.h"
+
+const int maxSteps = 3;
+const int maxLength = 9;
+const int maxVariables = 2;
+
+// Keys of the expressions one step from a key, with the steps of the closure: no substitution, operands that
+// are TRUE, FALSE, a variable in use or a new variable, and expressions that have a key
+std::vector<std::string> nextKeys(StepExpander<PE21LF>& steps, const std::string& key) {
+    std::vector<int> f(maxLength + 1, STOP);
+    for (size_t i = 0; i < key.size(); i++) {
+        f[i] = (uint8_t) key[i];
+    }
+    std::vector<VariableRecord> variables;
+    steps.initialVariables(f.data(), variables);
+    std::vector<std::string> keys;
+    std::string nextKey;
+    steps.expand(f.data(), (int) key.size(), maxLength + 1, variables.data(), (int) variables.size(),
+        [&](int law, int index, const int g[], int gStop, const std::vector<VariableRecord>& nextVariables) {
+            (void) index;
+            (void) nextVariables;
+            if (PE21LF::rules[law].matcher != substitutionMatcher && closureKey(g, gStop, maxLength, maxVariables, nextKey)) {
+                keys.push_back(nextKey);
+            }
+        });
+    return keys;
+}
+
+bool isTruthValue(const std::string& key, int* target) {
+    if (key.size() == 1 && (key[0] == TRUE || key[0] == FALSE)) {
+        *target = key[0];
+        return true;
+    }
+    return false;
+}
+
+// Fewest steps from a key to TRUE or FALSE, or -1 if there are more than maxSteps. The last step is found by
+// meeting the keys one step from TRUE and FALSE, since every law is two-way
+int forwardDistance(StepExpander<PE21LF>& steps, const std::map<std::string, int>& nearTargets, const std::string& start, int* target) {
+    if (isTruthValue(start, target)) {
+        return 0;
+    }
+    std::set<std::string> seen = {start};
+    std::vector<std::string> level = {start};
+    for (int distance = 1; distance <= maxSteps; distance++) {
+        if (distance == maxSteps) {
+            for (const std::string& key : level) {
+                auto near = nearTargets.find(key);
+                if (near != nearTargets.end()) {
+                    *target = near->second;
+                    return distance;
+                }
+            }
+            return -1;
+        }
+        std::vector<std::string> next;
+        for (const std::string& key : level) {
+            for (const std::string& nextKey : nextKeys(steps, key)) {
+                if (isTruthValue(nextKey, target)) {
+                    return distance;
+                }
+                if (seen.insert(nextKey).second) {
+                    next.push_back(nextKey);
+                }
+            }
+        }
+        level.swap(next);
+    }
+    return -1;
+}
+
+void randomExpression(std::mt19937& random, int variableCount, int depth, std::vector<int>& f) {
+    int kind = (int) (random() % 10);
+    if (depth == 0 || kind < 3) {
+        int leaf = (int) (random() % 8);
+        f.push_back(leaf == 0 ? FALSE : leaf == 1 ? TRUE : minVariable + 3 + (int) (random() % variableCount));
+    } else if (kind < 5) {
+        f.push_back(NOT);
+        randomExpression(random, variableCount, depth - 1, f);
+    } else {
+        f.push_back(kind < 8 ? OR : AND);
+        randomExpression(random, variableCount, depth - 1, f);
+        randomExpression(random, variableCount, depth - 1, f);
+    }
+}
+
+long failures = 0;
+
+void fail(const char* message) {
+    if (failures < 10) {
+        std::cout << message << "\n";
+    }
+    failures++;
+}
+
+// A proof of findProof, which isProofSequence must accept, or -1
+int checkedProofLength(ClosureDatabase<PE21LF>& database, std::vector<int>& f, int target) {
+    SearchProof proof;
+    if (!database.findProof(f.data(), (int) f.size(), target, &proof)) {
+        return -1;
+    }
+    std::vector<Tuple> sequence = proof.sequence();
+    ProofChecker<PE21LF> checker;
+    if (proof.length() == 0 || !checker.isProofSequence(proof.formula.data(), proof.fLength, sequence.data(), proof.length(), target)) {
+        fail("a proof that isProofSequence rejects");
+    }
+    return proof.length();
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    ClosureBuilder<PE21LF> builder;
+    builder.setMaxSteps(maxSteps);
+    builder.setMaxLength(maxLength);
+    builder.setMaxVariables(maxVariables);
+    size_t built = builder.build();
+    std::vector<uint8_t> image;
+    builder.serialize(image);
+    ClosureDatabase<PE21LF> database;
+    if (!database.attach(image.data(), image.size()) || database.size() != built || database.maxSteps() != maxSteps) {
+        fail("the image did not attach");
+        return 1;
+    }
+    StepExpander<PE21LF> steps;
+    steps.generator().allowNewVariables(true);
+    std::map<std::string, int> nearTargets;
+    for (int target : {FALSE, TRUE}) {
+        for (const std::string& key : nextKeys(steps, std::string(1, (char) target))) {
+            nearTargets[key] = target;
+        }
+    }
+    // The expressions of the closure, from the records of the image, and random expressions, which are mostly not
+    ClosureHeader header;
+    std::memcpy(&header, image.data(), sizeof(ClosureHeader));
+    size_t recordsStart = sizeof(ClosureHeader) + (size_t) header.bucketCount * sizeof(uint32_t);
+    std::vector<std::vector<int>> expressions;
+    std::vector<size_t> sampleRecords;
+    for (uint32_t slot = 0; slot < header.slotCount; slot++) {
+        const uint8_t* record = image.data() + recordsStart + (size_t) slot * header.recordSize;
+        if (record[0] != 0 && random() % 40 == 0) {
+            expressions.push_back(std::vector<int>(record + closureRecordFields, record + closureRecordFields + record[0]));
+            sampleRecords.push_back(record - image.data());
+        }
+    }
+    size_t closureSamples = expressions.size();
+    for (int i = 0; i < 400; i++) {
+        std::vector<int> f;
+        randomExpression(random, i % 4 == 0 ? 3 : 2, 1 + (int) (random() % 3), f);
+        expressions.push_back(f);
+    }
+    long found = 0, proofs = 0;
+    for (std::vector<int>& f : expressions) {
+        std::string key;
+        int expectedTarget = noLaw;
+        int expected = closureKey(f.data(), (int) f.size(), maxLength, maxVariables, key) ? forwardDistance(steps, nearTargets, key, &expectedTarget) : -1;
+        std::vector<int> array = f;
+        array.resize(f.size() + 1 + random() % 3, STOP);
+        int target = noLaw;
+        int distance = database.distance(array.data(), (int) array.size(), &target);
+        if (distance != expected || (distance >= 0 && target != expectedTarget)) {
+            fail("wrong distance");
+            continue;
+        }
+        if (distance < 0) {
+            if (checkedProofLength(database, array, FALSE) >= 0 || checkedProofLength(database, array, TRUE) >= 0) {
+                fail("a proof of an expression that is not in the closure");
+            }
+            continue;
+        }
+        found++;
+        // A proof of the steps that distance gives, and none of the other truth value or of a truth value itself
+        int length = checkedProofLength(database, array, target);
+        if (length != (distance == 0 ? -1 : distance) || checkedProofLength(database, array, target == TRUE ? FALSE : TRUE) >= 0) {
+            fail("wrong proof");
+        }
+        proofs += length > 0;
+    }
+    // The same closure from a file
+    const char* path = "ClosureDatabaseFuzz.closure";
+    ClosureDatabase<PE21LF> opened;
+    if (!builder.save(path) || !opened.open(path) || opened.size() != built) {
+        fail("the saved closure did not open");
+    } else {
+        for (size_t i = 0; i < expressions.size(); i += 7) {
+            int target = noLaw, openedTarget = noLaw;
+            std::vector<int> array = expressions[i];
+            array.push_back(STOP);
+            if (opened.distance(array.data(), (int) array.size(), &openedTarget) != database.distance(array.data(), (int) array.size(), &target)
+                || openedTarget != target) {
+                fail("the saved closure differs");
+            }
+        }
+        opened.close();
+    }
+    std::remove(path);
+    // Corrupt headers, which must not attach, and an image of the wrong size
+    long rejected = 0;
+    for (int field = 0; field < (int) (sizeof(ClosureHeader) / sizeof(uint32_t)); field++) {
+        static const char* names[] = {"magic", "version", "maxSteps", "maxLength", "maxVariables", "recordSize", "formulaCount", "bucketCount", "slotCount"};
+        for (uint32_t value : {0u, 1u, 255u, 256u, 1000u, 0xFFFFFFFFu}) {
+            std::vector<uint8_t> corrupt = image;
+            uint32_t* fields = (uint32_t*) corrupt.data();
+            if (fields[field] == value) {
+                continue;
+            }
+            fields[field] = value;
+            // maxSteps and formulaCount are not needed to read the closure, and maxVariables and maxLength may shrink
+            bool harmless = field == 2 || field == 6 || (field == 4 && value <= 255 - minVariable);
+            bool attached = database.attach(corrupt.data(), corrupt.size());
+            if (attached && !harmless) {
+                std::cout << "Corrupt " << names[field] << " " << value << ": ";
+                fail("a corrupt header attached");
+            }
+            rejected += !attached;
+        }
+    }
+    for (size_t size : {(size_t) 0, sizeof(ClosureHeader) - 1, image.size() - 1, image.size() + 1}) {
+        std::vector<uint8_t> resized = image;
+        resized.resize(size);
+        if (database.attach(resized.data(), resized.size())) {
+            fail("an image of the wrong size attached");
+        }
+        rejected++;
+    }
+    // Corrupt records: any lookup may fail, but every proof must still be a proof. First the records of an
+    // expression and of the next one on its proof claim that the proof ends one step early
+    std::map<std::string, size_t> recordOf;
+    for (uint32_t slot = 0; slot < header.slotCount; slot++) {
+        const uint8_t* record = image.data() + recordsStart + (size_t) slot * header.recordSize;
+        recordOf[std::string((const char*) record + closureRecordFields, record[0])] = record - image.data();
+    }
+    long corruptProofs = 0;
+    for (size_t i = 0; i < closureSamples; i++) {
+        std::vector<int> array = expressions[i];
+        array.push_back(STOP);
+        int target = noLaw;
+        SearchProof proof;
+        if (!database.attach(image.data(), image.size()) || database.distance(array.data(), (int) array.size(), &target) < 2
+            || !database.findProof(array.data(), (int) array.size(), target, &proof)) {
+            continue;
+        }
+        std::string key;
+        closureKey(proof.formulas[0].data(), indexOfStop(proof.formulas[0].data(), proof.fLength), maxLength, maxVariables, key);
+        std::vector<uint8_t> corrupt = image;
+        corrupt[sampleRecords[i] + 1] = 1;
+        corrupt[recordOf[key] + 1] = 0;
+        database.attach(corrupt.data(), corrupt.size());
+        corruptProofs += checkedProofLength(database, array, target) > 0;
+    }
+    for (int trial = 0; trial < 200; trial++) {
+        std::vector<uint8_t> corrupt = image;
+        // Anywhere in the records, and in the records of the expressions that are looked up
+        for (int flip = 0; flip < 1 + trial; flip++) {
+            size_t at = flip % 2 == 0 ? recordsStart + random() % (corrupt.size() - recordsStart)
+                : sampleRecords[random() % sampleRecords.size()] + random() % header.recordSize;
+            int kind = (int) (random() % 3);
+            corrupt[at] = kind == 0 ? (uint8_t) (random() % 256) : kind == 1 ? (uint8_t) (corrupt[at] + 1) : 0;
+        }
+        if (!database.attach(corrupt.data(), corrupt.size())) {
+            fail("an image with corrupt records did not attach");
+            continue;
+        }
+        for (size_t i = trial % 5; i < closureSamples; i += 5) {
+            std::vector<int> array = expressions[i];
+            array.push_back(STOP);
+            int target = noLaw;
+            database.distance(array.data(), (int) array.size(), &target);
+            for (int proofTarget : {FALSE, TRUE}) {
+                corruptProofs += checkedProofLength(database, array, proofTarget) > 0;
+            }
+        }
+    }
+    std::cout << built << " expressions in the closure, " << found << " of " << expressions.size() << " found, " << proofs
+              << " proofs, " << rejected << " corrupt images rejected, " << corruptProofs << " proofs from corrupt records: "
+              << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
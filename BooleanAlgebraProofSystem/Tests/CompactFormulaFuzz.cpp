@@ -0,0 +1,245 @@
+// Compares the checker on compact uint8_t and uint16_t expressions with the checker on int expressions, at every
+// level of scanning kernels, with and without rewrite rules. Random steps rewrite one subtree of a random expression
+// of up to 100 symbols, by a law, by a rule or at random, and must get the same verdict and leave the same variables
+// in use; random sequences of them must get the same verdict
+// g++ -std=c++17 -O2 -I.. CompactFormulaFuzz.cpp -o CompactFormulaFuzz
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "../PE21LF.h"
+
+const int newVariable = minVariable + 9; // Never in a random expression, so a substitution can define it
+
+void randomExpression(std::mt19937& random, int variableCount, int depth, std::vector<int>& f) {
+    int kind = (int) (random() % 10);
+    if (depth == 0 || kind < 3) {
+        int leaf = (int) (random() % 10);
+        f.push_back(leaf == 0 ? FALSE : leaf == 1 ? TRUE : minVariable + (int) (random() % variableCount));
+    } else if (kind < 5) {
+        f.push_back(NOT);
+        randomExpression(random, variableCount, depth - 1, f);
+    } else {
+        f.push_back(kind < 8 ? OR : AND);
+        randomExpression(random, variableCount, depth - 1, f);
+        randomExpression(random, variableCount, depth - 1, f);
+    }
+}
+
+// Index after the subtree that starts at position
+int subtreeEnd(const std::vector<int>& f, int position) {
+    int needed = 1;
+    while (needed > 0) {
+        int symbol = f[position++];
+        needed += symbol == NOT ? 0 : symbol == OR || symbol == AND ? 1 : -1;
+    }
+    return position;
+}
+
+// f with one subtree rewritten, by a law in most cases, which may still be a step that no law allows
+std::vector<int> randomStep(std::mt19937& random, const std::vector<int>& f) {
+    int start = (int) (random() % f.size());
+    int end = subtreeEnd(f, start);
+    std::vector<int> t(f.begin() + start, f.begin() + end);
+    std::vector<int> u;
+    int kind = (int) (random() % 8);
+    if (kind == 0 && (t[0] == OR || t[0] == AND)) {
+        // a + b = b + a
+        int middle = subtreeEnd(t, 1);
+        u.push_back(t[0]);
+        u.insert(u.end(), t.begin() + middle, t.end());
+        u.insert(u.end(), t.begin() + 1, t.begin() + middle);
+    } else if (kind == 1) {
+        // a = --a, and --a = a
+        if (t.size() > 2 && t[0] == NOT && t[1] == NOT) {
+            u.assign(t.begin() + 2, t.end());
+        } else {
+            u = {NOT, NOT};
+            u.insert(u.end(), t.begin(), t.end());
+        }
+    } else if (kind == 2) {
+        // a = a * 1, or a = a + a
+        bool identity = random() % 2 == 0;
+        u.push_back(identity ? AND : OR);
+        u.insert(u.end(), t.begin(), t.end());
+        if (identity) {
+            u.push_back(TRUE);
+        } else {
+            u.insert(u.end(), t.begin(), t.end());
+        }
+    } else if (kind == 3 && t[0] == NOT && (t[1] == OR || t[1] == AND)) {
+        // -(a + b) = -a * -b
+        int middle = subtreeEnd(t, 2);
+        u.push_back(t[1] == OR ? AND : OR);
+        u.push_back(NOT);
+        u.insert(u.end(), t.begin() + 2, t.begin() + middle);
+        u.push_back(NOT);
+        u.insert(u.end(), t.begin() + middle, t.end());
+    } else if (kind == 4 && t.size() > 1) {
+        // A substitution of a new variable
+        u = {newVariable};
+    } else {
+        randomExpression(random, 3, (int) (random() % 3), u);
+    }
+    std::vector<int> g(f.begin(), f.begin() + start);
+    g.insert(g.end(), u.begin(), u.end());
+    g.insert(g.end(), f.begin() + end, f.end());
+    return g;
+}
+
+// A subtree of f replaced by the left side of a rewrite rule over random variables, and g with the right side
+void ruleStep(std::mt19937& random, std::vector<int>& f, std::vector<int>& g) {
+    int start = (int) (random() % f.size());
+    int end = subtreeEnd(f, start);
+    int a = minVariable + (int) (random() % 3), b = minVariable + (int) (random() % 3), c = minVariable + (int) (random() % 3);
+    std::vector<int> left, right;
+    if (random() % 2 == 0) {
+        // consensus: a * b + -a * c + b * c = a * b + -a * c
+        left = {OR, OR, AND, a, b, AND, NOT, a, c, AND, b, c};
+        right = {OR, AND, a, b, AND, NOT, a, c};
+    } else {
+        // rotation: a * (b * c) = b * (c * a)
+        left = {AND, a, AND, b, c};
+        right = {AND, b, AND, c, a};
+    }
+    g.assign(f.begin(), f.begin() + start);
+    g.insert(g.end(), right.begin(), right.end());
+    g.insert(g.end(), f.begin() + end, f.end());
+    f.erase(f.begin() + start, f.begin() + end);
+    f.insert(f.begin() + start, left.begin(), left.end());
+}
+
+class CompactCopy {
+    public:
+        std::vector<uint8_t> narrow;
+        std::vector<uint16_t> wide;
+        CompactCopy(std::vector<int> f) {
+            f.push_back(STOP);
+            appendCompactFormula(f.data(), (int) f.size(), narrow);
+            appendCompactFormula(f.data(), (int) f.size(), wide);
+        }
+};
+
+// The variables in use, which the random expressions and steps take from minVariable to newVariable
+bool sameVariables(ProofChecker<PE21LF>& x, ProofChecker<PE21LF>& y) {
+    for (int name = minVariable; name <= newVariable; name++) {
+        VariableRecord* a = x.variables().find(name);
+        VariableRecord* b = y.variables().find(name);
+        if ((a == nullptr) != (b == nullptr)
+            || (a != nullptr && (a->count != b->count || a->type != b->type || a->a != b->a || a->b != b->b))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+long failures = 0;
+
+void fail(int trial, int level, const char* message) {
+    if (failures < 10) {
+        std::cout << "Trial " << trial << ", kernel level " << level << ": " << message << "\n";
+    }
+    failures++;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    RuleSet rules;
+    std::istringstream ruleText("consensus: 2 2 3 a b 3 1 a c 3 b c = 2 3 a b 3 1 a c\nrotation: 3 a 3 b c = 3 b 3 c a\n");
+    rules.parse(ruleText);
+    long steps = 0, correct = 0, sequences = 0, proofs = 0;
+    for (int level = scalarKernels; level <= supportedKernelLevel(); level++) {
+        selectKernelLevel(level);
+        for (int trial = 0; trial < 100000; trial++) {
+            std::vector<int> f;
+            randomExpression(random, 1 + (int) (random() % 6), 2 + (int) (random() % 6), f);
+            if (f.size() > 90) {
+                continue;
+            }
+            const RuleSet* ruleSet = random() % 2 == 0 ? &rules : nullptr;
+            std::vector<int> g;
+            if (ruleSet != nullptr && random() % 4 == 0) {
+                ruleStep(random, f, g);
+            } else {
+                g = randomStep(random, f);
+            }
+            ProofChecker<PE21LF> checker, narrowChecker, wideChecker;
+            for (ProofChecker<PE21LF>* c : {&checker, &narrowChecker, &wideChecker}) {
+                c->setRules(ruleSet);
+            }
+            // Either array is long enough for the other expression
+            int fLength = (int) std::max(f.size(), g.size()) + 1;
+            std::vector<int> fArray = f, gArray = g;
+            fArray.resize(fLength, STOP);
+            gArray.resize(fLength, STOP);
+            CompactCopy fCopy(f), gCopy(g);
+            CompactFormula<uint8_t> fNarrow(fCopy.narrow.data(), (int) f.size()), gNarrow(gCopy.narrow.data(), (int) g.size());
+            CompactFormula<uint16_t> fWide(fCopy.wide.data(), (int) f.size()), gWide(gCopy.wide.data(), (int) g.size());
+            // The law that the int checker identifies, no law, or any law
+            checker.storeInitialVariables(fArray.data());
+            int choice = (int) (random() % 3);
+            int law = choice == 0 ? checker.identifyLaw(fArray.data(), gArray.data(), fLength) : choice == 1 ? unlabeled
+                : (int) (random() % (PE21LF::lawCount + 2));
+            checker.storeInitialVariables(fArray.data());
+            narrowChecker.storeInitialVariables(fNarrow);
+            wideChecker.storeInitialVariables(fWide);
+            bool expected = checker.isTransformationByLaw(fArray.data(), gArray.data(), fLength, law);
+            if (narrowChecker.isTransformationByLaw(fNarrow, gNarrow, law) != expected) {
+                fail(trial, level, "a uint8_t step has another verdict");
+            }
+            if (wideChecker.isTransformationByLaw(fWide, gWide, law) != expected) {
+                fail(trial, level, "a uint16_t step has another verdict");
+            }
+            if (expected && (!sameVariables(checker, narrowChecker) || !sameVariables(checker, wideChecker))) {
+                fail(trial, level, "a compact step left other variables in use");
+            }
+            steps++;
+            correct += expected;
+            // A sequence of steps from f, which reaches FALSE when its last step rewrites the whole expression
+            if (trial % 4 == 0) {
+                std::vector<std::vector<int>> formulas = {f};
+                int length = 1 + (int) (random() % 6);
+                for (int i = 0; i < length; i++) {
+                    formulas.push_back(i + 1 == length && random() % 2 == 0 ? std::vector<int>{FALSE} : randomStep(random, formulas.back()));
+                }
+                int longest = 0;
+                for (std::vector<int>& h : formulas) {
+                    longest = std::max(longest, (int) h.size());
+                }
+                std::vector<std::vector<int>> arrays;
+                std::vector<uint8_t> narrowStorage;
+                std::vector<uint16_t> wideStorage;
+                for (std::vector<int>& h : formulas) {
+                    arrays.push_back(h);
+                    arrays.back().resize(longest + 1, STOP);
+                    appendCompactFormula(arrays.back().data(), longest + 1, narrowStorage);
+                    appendCompactFormula(arrays.back().data(), longest + 1, wideStorage);
+                }
+                std::vector<Tuple> sequence;
+                std::vector<CompactTuple<uint8_t>> narrowSequence;
+                std::vector<CompactTuple<uint16_t>> wideSequence;
+                int offset = (int) formulas[0].size();
+                for (int i = 1; i <= length; i++) {
+                    int stepLaw = random() % 2 == 0 ? unlabeled : (int) (random() % PE21LF::lawCount);
+                    int size = (int) formulas[i].size();
+                    sequence.push_back(Tuple(stepLaw, arrays[i].data()));
+                    narrowSequence.push_back(CompactTuple<uint8_t>(stepLaw, CompactFormula<uint8_t>(narrowStorage.data() + offset, size)));
+                    wideSequence.push_back(CompactTuple<uint16_t>(stepLaw, CompactFormula<uint16_t>(wideStorage.data() + offset, size)));
+                    offset += size;
+                }
+                bool sequenceExpected = checker.isProofSequence(arrays[0].data(), longest + 1, sequence.data(), length, FALSE);
+                CompactFormula<uint8_t> narrowFormula(narrowStorage.data(), (int) formulas[0].size());
+                CompactFormula<uint16_t> wideFormula(wideStorage.data(), (int) formulas[0].size());
+                if (narrowChecker.isProofSequence(narrowFormula, narrowSequence.data(), length, FALSE) != sequenceExpected
+                    || wideChecker.isProofSequence(wideFormula, wideSequence.data(), length, FALSE) != sequenceExpected) {
+                    fail(trial, level, "a compact sequence has another verdict");
+                }
+                sequences++;
+                proofs += sequenceExpected;
+            }
+        }
+    }
+    std::cout << steps << " steps, " << correct << " correct, and " << sequences << " sequences, " << proofs
+              << " proofs, up to kernel level " << supportedKernelLevel() << ": " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
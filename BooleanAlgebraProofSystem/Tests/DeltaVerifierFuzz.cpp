@@ -0,0 +1,108 @@
+// Compares DeltaVerifier with isProofSequence on random proofs, on corrupted copies of them, and on delta steps whose
+// index or lengths are moved, which are expanded back into whole expressions for the reference
+// g++ -std=c++17 -O2 -I.. DeltaVerifierFuzz.cpp -o DeltaVerifierFuzz
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../PE21LF.h"
+#include "../DeltaProof.h"
+#include "RandomProofs.h"
+
+// Whole expressions of a delta proof, or false if a step is out of range
+bool expandDeltaProof(const SearchProof& proof, const DeltaProof& delta, std::vector<std::vector<int>>& formulas) {
+    std::vector<int> previous(proof.formula.begin(), proof.formula.begin() + indexOfStop((int*) proof.formula.data(), proof.fLength));
+    formulas.clear();
+    for (const DeltaStep& step : delta.steps) {
+        int fStop = (int) previous.size();
+        if (step.index < 0 || step.removedLength < 0 || step.index + step.removedLength > fStop) {
+            return false;
+        }
+        std::vector<int> next(previous.begin(), previous.begin() + step.index);
+        next.insert(next.end(), delta.inserted.begin() + step.insertedStart, delta.inserted.begin() + step.insertedStart + step.insertedLength);
+        next.insert(next.end(), previous.begin() + step.index + step.removedLength, previous.end());
+        if ((int) next.size() + 1 > proof.fLength) {
+            return false;
+        }
+        previous = next;
+        next.resize(proof.fLength, STOP);
+        formulas.push_back(next);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    long proofs = 0, accepted = 0, rejected = 0, failures = 0;
+    for (int trial = 0; trial < 600; trial++) {
+        SearchProof proof;
+        if (!randomProof<PE21LF>(random, (int) (random() % 6), &proof)) {
+            continue;
+        }
+        proofs++;
+        for (int mutation = 0; mutation < 12; mutation++) {
+            SearchProof changed = proof;
+            int target = FALSE;
+            int step = (int) (random() % changed.length());
+            int kind = mutation == 0 ? 0 : 1 + (int) (random() % 5);
+            if (kind == 1) {
+                changed.laws[step] = random() % 4 == 0 ? unlabeled : (int) (random() % PE21LF::lawCount);
+            } else if (kind == 2) {
+                int stop = indexOfStop(changed.formulas[step].data(), changed.fLength);
+                changed.formulas[step][random() % (stop + 1)] = (int) (random() % 9);
+            } else if (kind == 3 && changed.length() > 1) {
+                changed.laws.erase(changed.laws.begin() + step);
+                changed.formulas.erase(changed.formulas.begin() + step);
+            } else if (kind == 4) {
+                target = TRUE;
+            }
+            std::vector<Tuple> sequence = changed.sequence();
+            ProofChecker<PE21LF> checker;
+            DeltaVerifier<PE21LF> verifier;
+            DeltaProof delta;
+            bool expected = checker.isProofSequence(changed.formula.data(), changed.fLength, sequence.data(), changed.length(), target);
+            bool encoded = delta.encode(changed.formula.data(), changed.fLength, sequence.data(), changed.length());
+            if (encoded && kind == 5) {
+                // Moves the index or a length of a delta step, so the reference checks the expressions that it makes
+                DeltaStep& moved = delta.steps[step];
+                int change = random() % 2 == 0 ? 1 : -1;
+                int field = (int) (random() % 3);
+                (field == 0 ? moved.index : field == 1 ? moved.removedLength : moved.insertedLength) += change;
+                if (moved.insertedLength < 0 || moved.insertedStart + moved.insertedLength > (int) delta.inserted.size()) {
+                    moved.insertedLength -= change;
+                }
+                std::vector<std::vector<int>> formulas;
+                if (expandDeltaProof(changed, delta, formulas)) {
+                    std::vector<Tuple> expanded;
+                    for (size_t i = 0; i < formulas.size(); i++) {
+                        expanded.push_back(Tuple(delta.steps[i].law, formulas[i].data()));
+                    }
+                    expected = checker.isProofSequence(changed.formula.data(), changed.fLength, expanded.data(), (int) expanded.size(), target)
+                        && indexOfStop(formulas[step].data(), changed.fLength) > 0;
+                } else {
+                    expected = false;
+                }
+            }
+            bool result = encoded && verifier.isProofSequence(changed.formula.data(), changed.fLength, delta, target);
+            if (result != expected) {
+                std::cout << "Trial " << trial << ", change " << kind << " at step " << step << ": the delta verifier "
+                          << (result ? "accepted" : "rejected") << " what isProofSequence " << (expected ? "accepted" : "rejected") << "\n";
+                failures++;
+            }
+            if (mutation == 0 && !result) {
+                std::cout << "Trial " << trial << ": a proof from the search was rejected\n";
+                failures++;
+            }
+            if (result) {
+                std::vector<int> last;
+                verifier.formula(last);
+                if (last.size() != 2 || last[0] != target || last[1] != STOP) {
+                    std::cout << "Trial " << trial << ": an accepted proof did not end at its target\n";
+                    failures++;
+                }
+            }
+            (result ? accepted : rejected)++;
+        }
+    }
+    std::cout << proofs << " proofs, " << accepted << " accepted and " << rejected << " rejected versions: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+// Compares FormulaTape with a brute-force evaluator on random expressions of up to 9 variables, with every
+// assignment in one block of 64, 256 or 512 lanes and through evaluate, and checks the shape of the tape: each
+// instruction reads only earlier registers, there is no more than one instruction per operator, and no two
+// instructions are the same. Expressions without STOP or that are not one Polish expression must not compile
+// g++ -std=c++17 -O2 -I.. FormulaTapeFuzz.cpp -o FormulaTapeFuzz
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+#include "../FormulaTape.h"
+
+void randomExpression(std::mt19937& random, int variableCount, int depth, std::vector<int>& f) {
+    int kind = (int) (random() % 10);
+    if (depth == 0 || kind < 3) {
+        int leaf = (int) (random() % 12);
+        f.push_back(leaf == 0 ? FALSE : leaf == 1 ? TRUE : minVariable + (int) (random() % variableCount));
+    } else if (kind < 5) {
+        f.push_back(NOT);
+        randomExpression(random, variableCount, depth - 1, f);
+    } else {
+        f.push_back(kind < 8 ? OR : AND);
+        randomExpression(random, variableCount, depth - 1, f);
+        randomExpression(random, variableCount, depth - 1, f);
+    }
+}
+
+// Value of the subexpression at position, which moves past it, where the variable register v has the value of bit v
+bool evaluate(const std::vector<int>& f, size_t& position, const std::vector<int>& names, uint64_t values) {
+    int symbol = f[position++];
+    if (symbol == NOT) {
+        return !evaluate(f, position, names, values);
+    }
+    if (symbol == OR || symbol == AND) {
+        bool left = evaluate(f, position, names, values);
+        bool right = evaluate(f, position, names, values);
+        return symbol == OR ? left || right : left && right;
+    }
+    if (!isVariable(symbol)) {
+        return symbol == TRUE;
+    }
+    int v = (int) (std::lower_bound(names.begin(), names.end(), symbol) - names.begin());
+    return (values >> v) & 1;
+}
+
+long failures = 0;
+
+void fail(int trial, const char* message) {
+    if (failures < 10) {
+        std::cout << "Trial " << trial << ": " << message << "\n";
+    }
+    failures++;
+}
+
+// Runs the tape on lanes assignments at once, where lane a gives variable register v the value of bit v of a,
+// and compares every lane with the brute-force evaluator
+template <int words>
+void checkBlock(int trial, const FormulaTape& tape, const std::vector<int>& f) {
+    std::vector<AssignmentBlock<words>> registers(tape.registerCount());
+    for (int v = 0; v < tape.variableCount(); v++) {
+        for (int w = 0; w < words; w++) {
+            uint64_t bits = 0;
+            for (int lane = 0; lane < 64; lane++) {
+                bits |= (uint64_t) (((w * 64 + lane) >> v) & 1) << lane;
+            }
+            registers[v].bits[w] = bits;
+        }
+    }
+    tape.run<words>(registers.data());
+    AssignmentBlock<words> result = tape.result<words>(registers.data());
+    int assignments = std::min(words * 64, 1 << tape.variableCount());
+    for (int a = 0; a < assignments; a++) {
+        size_t position = 0;
+        if (((result.bits[a / 64] >> (a % 64)) & 1) != evaluate(f, position, tape.variables(), (uint64_t) a)) {
+            fail(trial, "wrong value in a block");
+            return;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    long instructionTotal = 0, operatorTotal = 0, constants = 0;
+    FormulaTape tape;
+    for (int trial = 0; trial < 20000; trial++) {
+        int variableCount = 1 + (int) (random() % 9);
+        std::vector<int> f;
+        randomExpression(random, variableCount, 2 + (int) (random() % 7), f);
+        std::vector<int> array = f;
+        array.resize(f.size() + 1 + random() % 4, STOP);
+        if (!tape.compile(array.data(), (int) array.size())) {
+            fail(trial, "an expression did not compile");
+            continue;
+        }
+        std::vector<int> names;
+        for (int symbol : f) {
+            if (isVariable(symbol)) {
+                names.push_back(symbol);
+            }
+        }
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        if (tape.variables() != names || tape.variableCount() != (int) names.size()) {
+            fail(trial, "wrong variables");
+        }
+        // The shape of the tape
+        int operators = (int) std::count_if(f.begin(), f.end(), [](int symbol) { return symbol == NOT || symbol == OR || symbol == AND; });
+        const std::vector<TapeInstruction>& instructions = tape.instructions();
+        if ((int) instructions.size() > operators || tape.registerCount() != tape.variableCount() + (int) instructions.size()) {
+            fail(trial, "more instructions than operators");
+        }
+        std::set<std::tuple<int, int, uint64_t, uint64_t>> distinct;
+        for (int i = 0; i < (int) instructions.size(); i++) {
+            const TapeInstruction& instruction = instructions[i];
+            int destination = tape.variableCount() + i;
+            if (instruction.left < 0 || instruction.left >= destination || instruction.right < 0 || instruction.right >= destination) {
+                fail(trial, "an instruction reads a later register");
+            }
+            distinct.insert(std::make_tuple(std::min(instruction.left, instruction.right), std::max(instruction.left, instruction.right),
+                instruction.orMask, instruction.invertMask));
+        }
+        if (distinct.size() != instructions.size()) {
+            fail(trial, "two instructions are the same");
+        }
+        if (tape.output() >= tape.registerCount() || tape.output() < tapeTrue || (tape.output() < 0 && !instructions.empty())) {
+            fail(trial, "wrong output register");
+        }
+        instructionTotal += (long) instructions.size();
+        operatorTotal += operators;
+        constants += tape.output() < 0;
+        // Every assignment in one block, and random assignments one at a time
+        checkBlock<1>(trial, tape, f);
+        checkBlock<4>(trial, tape, f);
+        checkBlock<8>(trial, tape, f);
+        for (int i = 0; i < 4; i++) {
+            uint64_t values = random();
+            std::vector<char> assignment(tape.variableCount());
+            for (int v = 0; v < tape.variableCount(); v++) {
+                assignment[v] = (values >> v) & 1;
+            }
+            size_t position = 0;
+            if (tape.evaluate(assignment) != evaluate(f, position, names, values)) {
+                fail(trial, "wrong value of evaluate");
+            }
+        }
+        // Expressions that must not compile
+        std::vector<int> broken = f;
+        int kind = (int) (random() % 4);
+        if (kind == 0) {
+            // No STOP
+        } else if (kind == 1) {
+            // An operand is missing
+            broken.pop_back();
+            broken.push_back(STOP);
+        } else if (kind == 2) {
+            // Two expressions
+            broken.push_back(minVariable);
+            broken.push_back(STOP);
+        } else {
+            // Nothing before STOP
+            broken.assign(1 + random() % 3, STOP);
+        }
+        if (tape.compile(broken.data(), (int) broken.size())) {
+            fail(trial, "an expression that is not one Polish expression compiled");
+        }
+    }
+    std::cout << operatorTotal << " operators compiled to " << instructionTotal << " instructions, " << constants
+              << " constant expressions: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
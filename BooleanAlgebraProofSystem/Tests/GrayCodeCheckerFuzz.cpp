@@ -0,0 +1,226 @@
+// Compares GrayCodeChecker with a brute-force evaluator on random expressions of up to 14 variables, and with
+// TruthTable on expressions of up to 22 variables, at every lane width with 1, 3 and 8 threads: the class of each
+// expression, and the value of every assignment that findAssignment, isTautology and isContradiction return.
+// Loads that fail, of expressions without STOP, that are not one Polish expression or that have too many variables,
+// must leave no expression loaded. A cancel, before a search or from another thread during one, must hold until reset
+// g++ -std=c++17 -O2 -I.. GrayCodeCheckerFuzz.cpp -o GrayCodeCheckerFuzz -pthread
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../GrayCodeChecker.h"
+
+void randomExpression(std::mt19937& random, int variableCount, int depth, std::vector<int>& f) {
+    int kind = (int) (random() % 10);
+    if (depth == 0 || kind < 3) {
+        int leaf = (int) (random() % 12);
+        f.push_back(leaf == 0 ? FALSE : leaf == 1 ? TRUE : minVariable + (int) (random() % variableCount));
+    } else if (kind < 5) {
+        f.push_back(NOT);
+        randomExpression(random, variableCount, depth - 1, f);
+    } else {
+        f.push_back(kind < 8 ? OR : AND);
+        randomExpression(random, variableCount, depth - 1, f);
+        randomExpression(random, variableCount, depth - 1, f);
+    }
+}
+
+// Value of the subexpression at position, which moves past it, where variable v has the value of bit v - minVariable
+bool evaluate(const std::vector<int>& f, size_t& position, uint64_t values) {
+    int symbol = f[position++];
+    if (symbol == NOT) {
+        return !evaluate(f, position, values);
+    }
+    if (symbol == OR || symbol == AND) {
+        bool left = evaluate(f, position, values);
+        bool right = evaluate(f, position, values);
+        return symbol == OR ? left || right : left && right;
+    }
+    return symbol == TRUE || (isVariable(symbol) && ((values >> (symbol - minVariable)) & 1));
+}
+
+// Value under an assignment of the variables that the checker lists, in its order
+bool evaluateAssignment(const std::vector<int>& f, const std::vector<int>& names, const std::vector<char>& assignment) {
+    uint64_t values = 0;
+    for (size_t v = 0; v < names.size() && v < assignment.size(); v++) {
+        values |= (uint64_t) (assignment[v] != 0) << (names[v] - minVariable);
+    }
+    size_t position = 0;
+    return evaluate(f, position, values);
+}
+
+long failures = 0;
+
+void fail(int trial, int threads, int lanes, const char* message) {
+    if (failures < 10) {
+        std::cout << "Trial " << trial << ", " << threads << " threads, " << lanes << " lanes: " << message << "\n";
+    }
+    failures++;
+}
+
+// A tautology over variableCount variables, whose search for a falsifying assignment walks every assignment
+std::vector<int> longTautology(int variableCount) {
+    std::vector<int> f = {OR, OR, minVariable, NOT, minVariable};
+    for (int v = 1; v < variableCount; v++) {
+        f.push_back(v + 1 < variableCount ? AND : minVariable + v);
+        if (v + 1 < variableCount) {
+            f.push_back(minVariable + v);
+        }
+    }
+    f.push_back(STOP);
+    return f;
+}
+
+// A cancel before a search, and one from another thread during a search, stop every search until reset
+void checkCancel(GrayCodeChecker& checker, int threads) {
+    // Short enough for a lost cancel to show up as a wrong class rather than a search that never ends
+    std::vector<int> f = longTautology(28);
+    std::vector<int> small = {OR, minVariable, NOT, minVariable, STOP};
+    checker.load(f.data(), (int) f.size());
+    checker.cancel();
+    if (checker.isTautology(nullptr) || checker.isContradiction(nullptr) || checker.classify() != cancelledSearch
+        || !checker.wasCancelled()) {
+        fail(-1, threads, checker.lanes(), "a cancel before the search was lost");
+    }
+    checker.load(small.data(), (int) small.size());
+    if (checker.isTautology(nullptr) || checker.classify() != cancelledSearch) {
+        fail(-1, threads, checker.lanes(), "a cancel did not hold until reset");
+    }
+    checker.reset();
+    if (!checker.isTautology(nullptr) || checker.classify() != tautology || checker.wasCancelled()) {
+        fail(-1, threads, checker.lanes(), "reset did not allow searches again");
+    }
+    f = longTautology(45);
+    checker.load(f.data(), (int) f.size());
+    auto start = std::chrono::steady_clock::now();
+    std::thread canceller([&checker]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        checker.cancel();
+    });
+    int result = checker.classify();
+    canceller.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (result != cancelledSearch || seconds > 10) {
+        fail(-1, threads, checker.lanes(), "a cancel during the search did not stop it");
+    }
+    checker.reset();
+    checker.load(small.data(), (int) small.size());
+    if (checker.classify() != tautology) {
+        fail(-1, threads, checker.lanes(), "reset did not allow searches again");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    long counts[3] = {0, 0, 0};
+    GrayCodeChecker checkers[3] = {GrayCodeChecker(1), GrayCodeChecker(3), GrayCodeChecker(8)};
+    const int threadCounts[3] = {1, 3, 8};
+    for (int trial = 0; trial < 5000; trial++) {
+        bool wide = trial % 20 == 0;
+        int variableCount = wide ? 15 + (int) (random() % 8) : 1 + (int) (random() % 14);
+        std::vector<int> f;
+        randomExpression(random, variableCount, wide ? 9 : 2 + (int) (random() % 6), f);
+        std::vector<int> array = f;
+        array.resize(f.size() + 1 + random() % 4, STOP);
+        // The class of the expression over every assignment of the variables it has, which TruthTable gives for
+        // the expressions with too many variables to walk one by one
+        int expected;
+        if (wide) {
+            TruthTable table;
+            table.load(array.data(), (int) array.size());
+            expected = table.classify();
+        } else {
+            uint64_t mask = 0;
+            for (int symbol : f) {
+                if (isVariable(symbol)) {
+                    mask |= 1ULL << (symbol - minVariable);
+                }
+            }
+            bool satisfied = false, falsified = false;
+            for (uint64_t values = 0; ; values = (values - mask) & mask) {
+                size_t position = 0;
+                (evaluate(f, position, values) ? satisfied : falsified) = true;
+                if (((values - mask) & mask) == 0) {
+                    break;
+                }
+            }
+            expected = !falsified ? tautology : !satisfied ? contradiction : contingent;
+        }
+        counts[expected]++;
+        std::vector<int> names;
+        for (int symbol : f) {
+            if (isVariable(symbol)) {
+                names.push_back(symbol);
+            }
+        }
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        for (int c = 0; c < 3; c++) {
+            GrayCodeChecker& checker = checkers[c];
+            for (int lanes : {64, 256, 512}) {
+                checker.selectLanes(lanes);
+                if (!checker.load(array.data(), (int) array.size())) {
+                    fail(trial, threadCounts[c], lanes, "an expression was not loaded");
+                    continue;
+                }
+                if (checker.variables() != names) {
+                    fail(trial, threadCounts[c], lanes, "wrong variables");
+                }
+                for (bool value : {false, true}) {
+                    std::vector<char> assignment;
+                    bool found = checker.findAssignment(value, &assignment);
+                    if (found != (expected != (value ? contradiction : tautology))
+                        || (found && evaluateAssignment(f, names, assignment) != value)) {
+                        fail(trial, threadCounts[c], lanes, "wrong assignment");
+                    }
+                }
+                std::vector<char> counterexample;
+                if (checker.isTautology(&counterexample) != (expected == tautology)
+                    || (expected != tautology && evaluateAssignment(f, names, counterexample))) {
+                    fail(trial, threadCounts[c], lanes, "wrong tautology verdict");
+                }
+                if (checker.isContradiction(&counterexample) != (expected == contradiction)
+                    || (expected != contradiction && !evaluateAssignment(f, names, counterexample))) {
+                    fail(trial, threadCounts[c], lanes, "wrong contradiction verdict");
+                }
+            }
+            // A load that fails after this expression leaves none loaded
+            std::vector<int> broken = f;
+            int kind = (int) (random() % 4);
+            if (kind == 1) {
+                // An operand is missing
+                broken.pop_back();
+            } else if (kind == 2) {
+                // Two expressions
+                broken.push_back(minVariable);
+            } else if (kind == 3) {
+                // More variables than the counters hold
+                broken.clear();
+                for (int v = 0; v < 6 + maxGrayCodeVariables + 64; v++) {
+                    if (v > 0) {
+                        broken.insert(broken.begin(), OR);
+                    }
+                    broken.push_back(minVariable + v);
+                }
+            }
+            if (kind != 0) {
+                broken.push_back(STOP);
+            }
+            if (checker.load(broken.data(), (int) broken.size())) {
+                fail(trial, threadCounts[c], checker.lanes(), "an expression that cannot be searched was loaded");
+            }
+            std::vector<char> assignment;
+            if (checker.classify() != notLoaded || checker.isTautology(nullptr) || checker.isContradiction(nullptr)
+                || checker.findAssignment(true, &assignment) || checker.findAssignment(false, &assignment)) {
+                fail(trial, threadCounts[c], checker.lanes(), "a failed load left an expression loaded");
+            }
+        }
+    }
+    for (int c = 0; c < 3; c++) {
+        checkCancel(checkers[c], threadCounts[c]);
+    }
+    std::cout << counts[contingent] << " contingent, " << counts[tautology] << " tautologies, " << counts[contradiction]
+              << " contradictions, lanes up to " << checkers[0].lanes() << ": " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
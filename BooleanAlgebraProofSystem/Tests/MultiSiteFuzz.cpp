@@ -0,0 +1,154 @@
+// Compares isTransformationAtSites with a dynamic program over the single-site moves of MoveGenerator, which asks
+// whether non-overlapping moves of the law turn the previous expression into the next one, on random choices of
+// moves and changed copies of them. Accepted steps must leave the variables in use of the next expression, rejected
+// steps must leave them unchanged, and the chosen sites, when listed, must be accepted for steps that were not
+// changed and rejected for steps that the reference rejects
+// g++ -std=c++17 -O2 -I.. MultiSiteFuzz.cpp -o MultiSiteFuzz
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../PE21LF.h"
+#include "RandomProofs.h"
+
+const int arrayLength = 80;
+
+class Move {
+    public:
+        int replaced;
+        std::vector<int> replacement;
+};
+
+void randomExpression(std::mt19937& random, int depth, std::vector<int>& f) {
+    int kind = (int) (random() % 10);
+    if (depth == 0 || kind < 3) {
+        int leaf = (int) (random() % 5);
+        f.push_back(leaf < 2 ? FALSE + leaf : 6 + (int) (random() % 2));
+    } else if (kind < 5) {
+        f.push_back(NOT);
+        randomExpression(random, depth - 1, f);
+    } else {
+        f.push_back(kind < 8 ? OR : AND);
+        randomExpression(random, depth - 1, f);
+        randomExpression(random, depth - 1, f);
+    }
+}
+
+// Whether moves at non-overlapping indices turn f into g, where reachable[a][b] holds if the symbols of f from a
+// become the symbols of g from b
+bool reference(const std::vector<int>& f, int fStop, const std::vector<int>& g, int gStop, const std::vector<std::vector<Move>>& moves) {
+    if (fStop == gStop && std::equal(f.begin(), f.begin() + fStop, g.begin())) {
+        return false;
+    }
+    std::vector<std::vector<char>> reachable(fStop + 1, std::vector<char>(gStop + 1, 0));
+    reachable[fStop][gStop] = 1;
+    for (int a = fStop; a >= 0; a--) {
+        for (int b = gStop; b >= 0; b--) {
+            if (a == fStop && b == gStop) {
+                continue;
+            }
+            bool result = a < fStop && b < gStop && f[a] == g[b] && reachable[a + 1][b + 1];
+            for (size_t k = 0; k < moves[a].size() && !result; k++) {
+                const Move& move = moves[a][k];
+                int end = b + (int) move.replacement.size();
+                result = end <= gStop && std::equal(move.replacement.begin(), move.replacement.end(), g.begin() + b)
+                    && reachable[a + move.replaced][end];
+            }
+            reachable[a][b] = result;
+        }
+    }
+    return reachable[0][0];
+}
+
+long failures = 0;
+
+void fail(int law, const char* message) {
+    if (failures < 10) {
+        std::cout << "Law " << law << ": " << message << "\n";
+    }
+    failures++;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    long steps = 0, accepted = 0, multiSite = 0;
+    MoveGenerator<PE21LF> generator;
+    std::vector<VariableRecord> names = {{6, 1, 0, 0, 0}, {7, 1, 0, 0, 0}, {8, 1, 0, 0, 0}};
+    ProofChecker<PE21LF> checker, reader;
+    for (int trial = 0; trial < 60000; trial++) {
+        std::vector<int> f;
+        randomExpression(random, 3 + (int) (random() % 3), f);
+        if ((int) f.size() > 50) {
+            continue;
+        }
+        int fStop = (int) f.size();
+        f.resize(arrayLength, STOP);
+        int law = (int) (random() % PE21LF::lawCount);
+        if (PE21LF::rules[law].matcher == substitutionMatcher) {
+            // Each site of a substitution would need its own new variable
+            continue;
+        }
+        std::vector<std::vector<Move>> moves(fStop + 1);
+        generator.focus(law, -1);
+        generator.generate(f.data(), fStop, names.data(), (int) names.size(),
+            [&](int, int index, const int* replacement, int replacementLength, int replaced) {
+                moves[index].push_back(Move{replaced, std::vector<int>(replacement, replacement + replacementLength)});
+            });
+        // Moves at random sites, each of which starts after the part that the previous one replaced
+        std::vector<int> g;
+        std::vector<int> sites;
+        int i = 0;
+        while (i < fStop) {
+            if (!moves[i].empty() && random() % 2 == 0) {
+                const Move& move = moves[i][random() % moves[i].size()];
+                g.insert(g.end(), move.replacement.begin(), move.replacement.end());
+                sites.push_back(i);
+                i += move.replaced;
+            } else {
+                g.push_back(f[i++]);
+            }
+        }
+        if ((int) g.size() >= arrayLength - 1) {
+            continue;
+        }
+        bool changed = random() % 4 == 0 && !g.empty();
+        if (changed) {
+            g[random() % g.size()] = 1 + (int) (random() % 8);
+        }
+        int gStop = (int) g.size();
+        g.resize(arrayLength, STOP);
+        steps++;
+        checker.storeInitialVariables(f.data());
+        std::vector<VariableRecord> before, after;
+        checker.variables().save(before);
+        bool result = checker.isTransformationAtSites(f.data(), g.data(), arrayLength, law, nullptr, 0);
+        bool expected = reference(f, fStop, g, gStop, moves);
+        checker.variables().save(after);
+        if (result != expected) {
+            fail(law, result ? "the step was accepted and the reference rejects it"
+                : "the step was rejected and the reference accepts it");
+        } else if (result) {
+            accepted++;
+            multiSite += sites.size() > 1;
+            std::vector<VariableRecord> read;
+            reader.storeInitialVariables(g.data());
+            reader.variables().save(read);
+            if (!sameVariables(after, read)) {
+                fail(law, "wrong variables in use after the step");
+            }
+        } else if (!sameVariables(after, before)) {
+            fail(law, "a rejected step changed the variables in use");
+        }
+        if (!sites.empty()) {
+            checker.storeInitialVariables(f.data());
+            bool listed = checker.isTransformationAtSites(f.data(), g.data(), arrayLength, law, sites.data(), (int) sites.size());
+            if (!changed && !listed) {
+                fail(law, "the chosen sites were rejected");
+            } else if (listed && !expected) {
+                fail(law, "the chosen sites were accepted and the reference rejects the step");
+            }
+        }
+    }
+    std::cout << steps << " steps, " << accepted << " accepted, " << multiSite << " at several sites: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
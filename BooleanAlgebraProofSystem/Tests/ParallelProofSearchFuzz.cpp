@@ -0,0 +1,168 @@
+// Compares ParallelProofSearch at 1, 3 and 8 threads with DeepeningProofSearch on random small expressions:
+// every proof must be accepted by isProofSequence and be as short as the proof of DeepeningProofSearch, and
+// expressions that are not tautologies or contradictions must have no proof. A cancel, before a search or from
+// another thread during one, must hold until reset
+// g++ -std=c++17 -O2 -I.. ParallelProofSearchFuzz.cpp -o ParallelProofSearchFuzz -pthread
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../PE21LF.h"
+#include "../ParallelProofSearch.h"
+
+void randomExpression(std::mt19937& random, int variableCount, int depth, std::vector<int>& f) {
+    int kind = (int) (random() % 10);
+    if (depth == 0 || kind < 3) {
+        int leaf = (int) (random() % 8);
+        f.push_back(leaf == 0 ? FALSE : leaf == 1 ? TRUE : minVariable + (int) (random() % variableCount));
+    } else if (kind < 5) {
+        f.push_back(NOT);
+        randomExpression(random, variableCount, depth - 1, f);
+    } else {
+        f.push_back(kind < 8 ? OR : AND);
+        randomExpression(random, variableCount, depth - 1, f);
+        randomExpression(random, variableCount, depth - 1, f);
+    }
+}
+
+bool evaluate(const std::vector<int>& f, size_t& position, uint64_t values) {
+    int symbol = f[position++];
+    if (symbol == NOT) {
+        return !evaluate(f, position, values);
+    }
+    if (symbol == OR || symbol == AND) {
+        bool left = evaluate(f, position, values);
+        bool right = evaluate(f, position, values);
+        return symbol == OR ? left || right : left && right;
+    }
+    return symbol == TRUE || (isVariable(symbol) && ((values >> (symbol - minVariable)) & 1));
+}
+
+long failures = 0;
+
+void fail(int trial, int threads, const char* message) {
+    if (failures < 10) {
+        std::cout << "Trial " << trial << ", " << threads << " threads: " << message << "\n";
+    }
+    failures++;
+}
+
+// Length of the proof that a search found, or -1, which isProofSequence must accept
+template <class Search>
+int checkedProofLength(int trial, int threads, Search& search, std::vector<int>& f, int target) {
+    SearchProof proof;
+    if (!search.findProof(f.data(), (int) f.size(), target, &proof)) {
+        return -1;
+    }
+    std::vector<Tuple> sequence = proof.sequence();
+    ProofChecker<PE21LF> checker;
+    if (proof.length() == 0 || !checker.isProofSequence(proof.formula.data(), proof.fLength, sequence.data(), proof.length(), target)) {
+        fail(trial, threads, "a proof that isProofSequence rejects");
+    }
+    return proof.length();
+}
+
+// A cancel before a search, and one from another thread during a search, stop every search until reset
+void checkCancel(int threads) {
+    ParallelProofSearch<PE21LF> search(threads);
+    std::vector<int> f = {AND, 6, NOT, 6, STOP};
+    search.cancel();
+    if (search.findProof(f.data(), (int) f.size(), FALSE, nullptr) || !search.wasCancelled()) {
+        fail(-1, threads, "a cancel before the search was lost");
+    }
+    search.reset();
+    if (checkedProofLength(-1, threads, search, f, FALSE) != 1 || search.wasCancelled()) {
+        fail(-1, threads, "reset did not allow searches again");
+    }
+    // TRUE cannot be reached, so the search only ends at the greatest depth
+    std::vector<int> contradiction = {AND, OR, 6, 7, AND, NOT, 6, NOT, 7, STOP};
+    search.setMaxDepth(254);
+    auto start = std::chrono::steady_clock::now();
+    std::thread canceller([&search]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        search.cancel();
+    });
+    bool found = search.findProof(contradiction.data(), (int) contradiction.size(), TRUE, nullptr);
+    canceller.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (found || !search.wasCancelled() || seconds > 10) {
+        fail(-1, threads, "a cancel during the search did not stop it");
+    }
+    if (search.findProof(f.data(), (int) f.size(), FALSE, nullptr)) {
+        fail(-1, threads, "a cancel did not hold until reset");
+    }
+    search.reset();
+    if (checkedProofLength(-1, threads, search, f, FALSE) != 1) {
+        fail(-1, threads, "reset did not allow searches again");
+    }
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    long proofs = 0, contingents = 0, lengthTotal = 0, steals = 0;
+    const int threadCounts[3] = {1, 3, 8};
+    ProofSearch<PE21LF> bestFirst;
+    bestFirst.setNodeLimit(100000);
+    for (int trial = 0; trial < 600; trial++) {
+        std::vector<int> f;
+        randomExpression(random, 1 + (int) (random() % 2), 1 + (int) (random() % 3), f);
+        if (f.size() > 7 || f.size() < 2) {
+            continue;
+        }
+        bool satisfied = false, falsified = false;
+        for (uint64_t values = 0; values < 4; values++) {
+            size_t position = 0;
+            (evaluate(f, position, values) ? satisfied : falsified) = true;
+        }
+        std::vector<int> array = f;
+        array.push_back(STOP);
+        if (satisfied && falsified) {
+            // No proof of either value within a few steps
+            contingents++;
+            for (int threads : threadCounts) {
+                ParallelProofSearch<PE21LF> search(threads);
+                search.setMaxDepth(3);
+                for (int target : {FALSE, TRUE}) {
+                    if (checkedProofLength(trial, threads, search, array, target) >= 0 || search.wasCancelled()) {
+                        fail(trial, threads, "a proof of an expression that is neither a tautology nor a contradiction");
+                    }
+                }
+            }
+            continue;
+        }
+        // The steps of the reference are bounded by the proof that a best-first search finds, if it finds one
+        int target = satisfied ? TRUE : FALSE;
+        SearchProof bestFirstProof;
+        if (!bestFirst.findProof(array.data(), (int) array.size(), target, &bestFirstProof)) {
+            continue;
+        }
+        DeepeningProofSearch<PE21LF> deepening;
+        deepening.setMaxDepth(bestFirstProof.length());
+        int length = checkedProofLength(trial, 0, deepening, array, target);
+        if (length < 0) {
+            fail(trial, 0, "no proof from DeepeningProofSearch");
+            continue;
+        }
+        proofs++;
+        lengthTotal += length;
+        for (int threads : threadCounts) {
+            ParallelProofSearch<PE21LF> search(threads);
+            search.setMaxDepth(length + 1);
+            if (checkedProofLength(trial, threads, search, array, target) != length) {
+                fail(trial, threads, "a proof of another length");
+            }
+            steals += (long) search.steals();
+            ParallelProofSearch<PE21LF, PatternDatabaseBound<PE21LF>> patternSearch(threads);
+            patternSearch.setMaxDepth(length + 1);
+            if (checkedProofLength(trial, threads, patternSearch, array, target) != length) {
+                fail(trial, threads, "a proof of another length with PatternDatabaseBound");
+            }
+        }
+    }
+    for (int threads : threadCounts) {
+        checkCancel(threads);
+    }
+    std::cout << proofs << " proofs of mean length " << (proofs > 0 ? (double) lengthTotal / proofs : 0) << ", "
+              << contingents << " without proofs, " << steals << " steals: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
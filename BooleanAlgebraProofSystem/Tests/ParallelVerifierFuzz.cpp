@@ -0,0 +1,217 @@
+// Compares ProofVerifierPool at 1, 3 and 8 threads, with and without rewrite rules, with isProofSequence on proofs
+// of hundreds of steps, which walk out and back with substitution steps before a proof of FALSE, and on corrupted
+// copies of them. A proof is checked on its own as tuples and as an arena, and all versions of one as a batch
+// g++ -std=c++17 -O2 -I.. ParallelVerifierFuzz.cpp -o ParallelVerifierFuzz -pthread
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "../PE21LF.h"
+#include "../ProofSearch.h"
+
+const int arrayLength = 40;
+
+bool sameVariables(const std::vector<VariableRecord>& x, const std::vector<VariableRecord>& y) {
+    if (x.size() != y.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < x.size(); i++) {
+        if (x[i].name != y[i].name || x[i].count != y[i].count || x[i].type != y[i].type || x[i].a != y[i].a || x[i].b != y[i].b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A random walk of up to walkLength steps from a small contradiction, some of which define new variables by
+// substitution, then the same steps back to where it started, and a proof of FALSE from there that a ProofSearch
+// finds. Only steps that have a step back are taken
+bool randomWalk(std::mt19937& random, int walkLength, SearchProof* proof, long* substitutions) {
+    static const std::vector<std::vector<int>> starts = {
+        {AND, 7, AND, 6, NOT, 6}, {OR, AND, 6, NOT, 6, AND, 7, FALSE}, {AND, OR, 6, FALSE, NOT, OR, 6, FALSE},
+        {AND, NOT, 6, AND, 7, 6}, {OR, FALSE, AND, 6, NOT, 6}};
+    const std::vector<int>& start = starts[random() % starts.size()];
+    proof->fLength = arrayLength;
+    proof->formula.assign(arrayLength, STOP);
+    std::copy(start.begin(), start.end(), proof->formula.begin());
+    proof->laws.clear();
+    proof->formulas.clear();
+    ProofSearch<PE21LF> search;
+    search.setNodeLimit(20000);
+    search.setMaxLength(16);
+    SearchProof found;
+    if (!search.findProof(proof->formula.data(), arrayLength, FALSE, &found)) {
+        return false;
+    }
+    StepExpander<PE21LF> expander;
+    expander.generator().allowNewVariables(true);
+    std::vector<std::vector<int>> path = {proof->formula};
+    std::vector<std::vector<VariableRecord>> pathVariables(1);
+    expander.initialVariables(proof->formula.data(), pathVariables[0]);
+    std::vector<int> backLaws;
+    for (int k = 0; k < walkLength; k++) {
+        std::vector<int>& current = path.back();
+        std::vector<VariableRecord>& variables = pathVariables.back();
+        std::vector<std::vector<int>> nexts;
+        std::vector<int> laws;
+        std::vector<std::vector<VariableRecord>> nextVariables;
+        expander.expand(current.data(), indexOfStop(current.data(), arrayLength), arrayLength, variables.data(), (int) variables.size(),
+            [&](int law, int, const int g[], int gStop, const std::vector<VariableRecord>& records) {
+                if (gStop <= 14 && records.size() <= 6) {
+                    nexts.emplace_back(g, g + arrayLength);
+                    laws.push_back(law);
+                    nextVariables.push_back(records);
+                }
+            });
+        if (nexts.empty()) {
+            break;
+        }
+        int choice = (int) (random() % nexts.size());
+        int backLaw = noLaw;
+        expander.expand(nexts[choice].data(), indexOfStop(nexts[choice].data(), arrayLength), arrayLength, nextVariables[choice].data(),
+            (int) nextVariables[choice].size(), [&](int law, int, const int g[], int, const std::vector<VariableRecord>& records) {
+                if (backLaw == noLaw && std::equal(g, g + arrayLength, current.begin()) && sameVariables(records, variables)) {
+                    backLaw = law;
+                }
+            });
+        if (backLaw == noLaw) {
+            continue;
+        }
+        proof->laws.push_back(laws[choice]);
+        proof->formulas.push_back(nexts[choice]);
+        *substitutions += laws[choice] == substitution;
+        backLaws.push_back(backLaw);
+        path.push_back(nexts[choice]);
+        pathVariables.push_back(nextVariables[choice]);
+    }
+    for (int i = (int) backLaws.size() - 1; i >= 0; i--) {
+        proof->laws.push_back(backLaws[i]);
+        proof->formulas.push_back(path[i]);
+    }
+    for (int i = 0; i < found.length(); i++) {
+        std::vector<int> g(arrayLength, STOP);
+        std::copy(found.formulas[i].begin(), found.formulas[i].begin() + std::min((int) found.formulas[i].size(), arrayLength), g.begin());
+        proof->laws.push_back(found.laws[i]);
+        proof->formulas.push_back(g);
+    }
+    return true;
+}
+
+long failures = 0;
+
+void fail(int trial, int threads, const char* message) {
+    if (failures < 10) {
+        std::cout << "Trial " << trial << ", " << threads << " threads: " << message << "\n";
+    }
+    failures++;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    RuleSet rules;
+    std::istringstream ruleText("consensus: 2 2 3 a b 3 1 a c 3 b c = 2 3 a b 3 1 a c\nrotation: 3 a 3 b c = 3 b 3 c a\n"
+        "first: 2 a b = a\n");
+    rules.parse(ruleText);
+    const int threadCounts[3] = {1, 3, 8};
+    std::vector<ProofVerifierPool<PE21LF>*> pools;
+    for (int threads : threadCounts) {
+        pools.push_back(new ProofVerifierPool<PE21LF>(threads));
+        pools.push_back(new ProofVerifierPool<PE21LF>(threads, &rules));
+    }
+    long walks = 0, steps = 0, substitutions = 0, accepted = 0, rejected = 0;
+    for (int trial = 0; trial < 120; trial++) {
+        SearchProof proof;
+        if (!randomWalk(random, 1 + (int) (random() % 600), &proof, &substitutions)) {
+            continue;
+        }
+        walks++;
+        steps += proof.length();
+        // The walk, and copies with a wrong law, symbol or target, a missing step, no steps, a target that is not
+        // a truth value, or unlabeled steps in place of every step of a law
+        std::vector<SearchProof> versions;
+        std::vector<int> targets;
+        for (int mutation = 0; mutation < 8; mutation++) {
+            SearchProof changed = proof;
+            int target = FALSE;
+            int step = (int) (random() % changed.length());
+            int kind = mutation == 0 ? 0 : 1 + (int) (random() % 7);
+            if (kind == 1) {
+                int choice = (int) (random() % 4);
+                changed.laws[step] = choice == 0 ? unlabeled : choice == 1 ? ProofChecker<PE21LF>::firstRuleLaw + (int) (random() % 2)
+                    : (int) (random() % PE21LF::lawCount);
+            } else if (kind == 2) {
+                int stop = indexOfStop(changed.formulas[step].data(), changed.fLength);
+                changed.formulas[step][random() % (stop + 1)] = (int) (random() % 9);
+            } else if (kind == 3 && changed.length() > 1) {
+                changed.laws.erase(changed.laws.begin() + step);
+                changed.formulas.erase(changed.formulas.begin() + step);
+            } else if (kind == 4) {
+                target = TRUE;
+            } else if (kind == 5) {
+                target = random() % 2 == 0 ? minVariable : STOP;
+            } else if (kind == 6) {
+                changed.laws.clear();
+                changed.formulas.clear();
+            } else if (kind == 7) {
+                int law = random() % 2 == 0 ? substitution : changed.laws[step];
+                std::replace(changed.laws.begin(), changed.laws.end(), law, unlabeled);
+            }
+            versions.push_back(changed);
+            targets.push_back(target);
+        }
+        std::vector<std::vector<Tuple>> sequences;
+        std::vector<ProofArena> arenas;
+        for (SearchProof& version : versions) {
+            sequences.push_back(version.sequence());
+            arenas.push_back(version.arena());
+        }
+        for (int ruled = 0; ruled < 2; ruled++) {
+            ProofChecker<PE21LF> checker;
+            checker.setRules(ruled == 1 ? &rules : nullptr);
+            std::vector<char> expected;
+            std::vector<Proof> batch;
+            for (size_t i = 0; i < versions.size(); i++) {
+                SearchProof& version = versions[i];
+                expected.push_back(checker.isProofSequence(version.formula.data(), version.fLength, sequences[i].data(), version.length(), targets[i]));
+                batch.emplace_back(version.formula.data(), version.fLength, sequences[i].data(), version.length(), targets[i]);
+                if (checker.isProofSequence(arenas[i], targets[i]) != (bool) expected[i]) {
+                    fail(trial, 0, "an arena and its tuples have different verdicts");
+                }
+                (expected[i] ? accepted : rejected)++;
+            }
+            for (int p = 0; p < 3; p++) {
+                ProofVerifierPool<PE21LF>& pool = *pools[2 * p + ruled];
+                for (size_t i = 0; i < versions.size(); i++) {
+                    if (pool.verifyProof(batch[i]) != (bool) expected[i]) {
+                        fail(trial, threadCounts[p], "the verdict on a proof differs from isProofSequence");
+                    }
+                    if (pool.verifyProof(arenas[i], targets[i]) != (bool) expected[i]) {
+                        fail(trial, threadCounts[p], "the verdict on an arena differs from isProofSequence");
+                    }
+                }
+                if (pool.verifyBatch(batch) != expected) {
+                    fail(trial, threadCounts[p], "the verdicts of a batch differ from isProofSequence");
+                }
+            }
+        }
+    }
+    // An unlabeled step that looks like a substitution of a variable already in use, which only a rule identifies.
+    // The rule a + b = a does not hold, which the checker does not need to know
+    int f[] = {AND, 6, NOT, OR, 6, 7, STOP};
+    int g[] = {AND, 6, NOT, 6, STOP, 0, 0};
+    int h[] = {FALSE, STOP, 0, 0, 0, 0, 0};
+    Tuple sequence[] = {{unlabeled, g}, {unlabeled, h}};
+    Proof ruleProof(f, 7, sequence, 2, FALSE);
+    for (int p = 0; p < 6; p++) {
+        if (pools[p]->verifyProof(ruleProof) != (p % 2 == 1)) {
+            fail(-1, threadCounts[p / 2], "the verdict on an unlabeled step of a rule is wrong");
+        }
+    }
+    for (ProofVerifierPool<PE21LF>* pool : pools) {
+        delete pool;
+    }
+    std::cout << walks << " walks of mean length " << (walks > 0 ? (double) steps / walks : 0) << " with " << substitutions
+              << " substitutions, " << accepted << " accepted and " << rejected << " rejected versions: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
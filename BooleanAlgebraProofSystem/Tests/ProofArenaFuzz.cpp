@@ -0,0 +1,58 @@
+// Compares isProofSequence on a ProofArena with isProofSequence on tuples, on random proofs and corrupted copies of
+// them, in either operand mode
+// g++ -std=c++17 -O2 -I.. ProofArenaFuzz.cpp -o ProofArenaFuzz
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../PE21LF.h"
+#include "RandomProofs.h"
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    long proofs = 0, accepted = 0, rejected = 0, failures = 0;
+    for (int trial = 0; trial < 600; trial++) {
+        SearchProof proof;
+        if (!randomProof<PE21LF>(random, (int) (random() % 6), &proof)) {
+            continue;
+        }
+        proofs++;
+        for (int mutation = 0; mutation < 12; mutation++) {
+            SearchProof changed = proof;
+            int target = FALSE;
+            int step = (int) (random() % changed.length());
+            int kind = mutation == 0 ? 0 : 1 + (int) (random() % 4);
+            if (kind == 1) {
+                changed.laws[step] = random() % 4 == 0 ? unlabeled : (int) (random() % PE21LF::lawCount);
+            } else if (kind == 2) {
+                // A changed symbol, which may also be an early STOP
+                int stop = indexOfStop(changed.formulas[step].data(), changed.fLength);
+                changed.formulas[step][random() % (stop + 1)] = (int) (random() % 9);
+            } else if (kind == 3 && changed.length() > 1) {
+                changed.laws.erase(changed.laws.begin() + step);
+                changed.formulas.erase(changed.formulas.begin() + step);
+            } else if (kind == 4) {
+                target = TRUE;
+            }
+            std::vector<Tuple> sequence = changed.sequence();
+            ProofArena arena = changed.arena();
+            int operandMode = random() % 2 == 0 ? symbolOperands : subtreeOperands;
+            ProofChecker<PE21LF> tupleChecker, arenaChecker;
+            tupleChecker.setOperandMode(operandMode);
+            arenaChecker.setOperandMode(operandMode);
+            bool expected = tupleChecker.isProofSequence(changed.formula.data(), changed.fLength, sequence.data(), changed.length(), target);
+            bool result = arenaChecker.isProofSequence(arena, target);
+            if (result != expected) {
+                std::cout << "Trial " << trial << ", change " << kind << " at step " << step << " in operand mode " << operandMode
+                          << ": the arena was " << (result ? "accepted" : "rejected") << " and the tuples were not\n";
+                failures++;
+            }
+            if (mutation == 0 && operandMode == symbolOperands && !result) {
+                std::cout << "Trial " << trial << ": a proof from the search was rejected\n";
+                failures++;
+            }
+            (result ? accepted : rejected)++;
+        }
+    }
+    std::cout << proofs << " proofs, " << accepted << " accepted and " << rejected << " rejected versions: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
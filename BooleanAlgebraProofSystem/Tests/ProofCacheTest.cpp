@@ -0,0 +1,433 @@
+// Tests ProofCache on a file in the current directory, or at the path of the first argument: lookups of renamed
+// expressions, records torn by a writer that stopped, which the checksum rejects and the next writer writes over,
+// processes that append while another one compacts, and readers that refresh after a compaction put another file at
+// the path. Then times lookups in the table of a compacted file and among appended records
+// g++ -std=c++17 -O2 -I.. ProofCacheTest.cpp -o ProofCacheTest
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../PE21LF.h"
+#include "../ProofCache.h"
+
+const int arrayLength = 40;
+
+class CacheItem {
+    public:
+        std::vector<int> formula;
+        DeltaProof proof;
+        int target;
+};
+
+long failures = 0;
+
+void fail(const std::string& message) {
+    if (failures < 20) {
+        std::cout << message << "\n";
+    }
+    failures++;
+}
+
+// Expressions that a random walk reaches from small contradictions and tautologies, with a proof from a ProofSearch
+std::vector<CacheItem> makeItems(int seed, int count) {
+    static const std::vector<std::vector<int>> starts = {
+        {AND, 7, AND, 6, NOT, 6}, {OR, AND, 6, NOT, 6, AND, 7, FALSE}, {AND, OR, 6, FALSE, NOT, OR, 6, FALSE},
+        {AND, NOT, 6, AND, 7, 6}, {OR, FALSE, AND, 6, NOT, 6}, {OR, 6, NOT, 6}, {OR, NOT, 8, OR, 7, 8}};
+    std::mt19937 random(seed);
+    std::vector<CacheItem> items;
+    while ((int) items.size() < count) {
+        const std::vector<int>& start = starts[random() % starts.size()];
+        std::vector<int> current(arrayLength, STOP);
+        std::copy(start.begin(), start.end(), current.begin());
+        StepExpander<PE21LF> expander;
+        expander.generator().allowNewVariables(true);
+        std::vector<VariableRecord> variables;
+        expander.initialVariables(current.data(), variables);
+        int walkLength = (int) (random() % 5);
+        for (int k = 0; k < walkLength; k++) {
+            std::vector<std::vector<int>> nexts;
+            std::vector<std::vector<VariableRecord>> nextVariables;
+            expander.expand(current.data(), indexOfStop(current.data(), arrayLength), arrayLength, variables.data(), (int) variables.size(),
+                [&](int, int, const int g[], int gStop, const std::vector<VariableRecord>& records) {
+                    if (gStop <= 12) {
+                        nexts.emplace_back(g, g + arrayLength);
+                        nextVariables.push_back(records);
+                    }
+                });
+            if (nexts.empty()) {
+                break;
+            }
+            int choice = (int) (random() % nexts.size());
+            current = nexts[choice];
+            variables = nextVariables[choice];
+        }
+        for (int target : {FALSE, TRUE}) {
+            ProofSearch<PE21LF> search;
+            search.setNodeLimit(5000);
+            search.setMaxLength(14);
+            SearchProof found;
+            if (!search.findProof(current.data(), arrayLength, target, &found)) {
+                continue;
+            }
+            std::vector<std::vector<int>> formulas;
+            std::vector<Tuple> sequence;
+            for (int i = 0; i < found.length(); i++) {
+                formulas.emplace_back(arrayLength, STOP);
+                std::copy(found.formulas[i].begin(), found.formulas[i].begin() + std::min((int) found.formulas[i].size(), arrayLength),
+                    formulas.back().begin());
+            }
+            for (int i = 0; i < found.length(); i++) {
+                sequence.push_back(Tuple(found.laws[i], formulas[i].data()));
+            }
+            CacheItem item;
+            item.formula = current;
+            item.target = target;
+            DeltaVerifier<PE21LF> verifier;
+            if (item.proof.encode(current.data(), arrayLength, sequence.data(), (int) sequence.size())
+                && verifier.isProofSequence(current.data(), arrayLength, item.proof, target))
+            {
+                items.push_back(item);
+            }
+            break;
+        }
+    }
+    return items;
+}
+
+// The expression with its variables permuted and shifted, which has the same proofs with other names
+std::vector<int> renameVariables(const std::vector<int>& f, std::mt19937& random) {
+    std::vector<int> names = {6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    std::shuffle(names.begin(), names.end(), random);
+    int shift = (int) (random() % 5);
+    std::vector<int> g = f;
+    for (int& symbol : g) {
+        if (symbol >= 6 && symbol < 16) {
+            symbol = names[symbol - 6] + shift;
+        }
+    }
+    return g;
+}
+
+// Every item is found under its own names and renamed, with a proof that is correct for the renamed expression
+void checkItems(ProofCache& cache, const std::vector<CacheItem>& items, std::mt19937& random, const std::string& phase) {
+    for (const CacheItem& item : items) {
+        for (int renaming = 0; renaming < 3; renaming++) {
+            std::vector<int> f = renaming == 0 ? item.formula : renameVariables(item.formula, random);
+            DeltaProof proof;
+            int target;
+            bool correct;
+            if (!cache.lookup(f.data(), (int) f.size(), &proof, &target, &correct)) {
+                fail(phase + ": an expression that was added is missing");
+                continue;
+            }
+            DeltaVerifier<PE21LF> verifier;
+            if (!correct || target != item.target || proof.steps.size() > item.proof.steps.size()
+                || !verifier.isProofSequence(f.data(), (int) f.size(), proof, target))
+            {
+                fail(phase + ": the proof that was found is not correct for the renamed expression");
+            }
+        }
+    }
+}
+
+std::vector<char> readFile(const std::string& path) {
+    std::ifstream input(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+}
+
+void appendBytes(const std::string& path, const std::vector<char>& bytes) {
+    std::ofstream output(path, std::ios::binary | std::ios::app);
+    output.write(bytes.data(), (std::streamsize) bytes.size());
+}
+
+// Items of the seed that the cache does not have yet, with different expressions
+std::vector<CacheItem> freshItems(ProofCache& cache, int seed, int count) {
+    std::vector<CacheItem> fresh;
+    for (; (int) fresh.size() < count; seed++) {
+        for (const CacheItem& item : makeItems(seed, 10)) {
+            CachedProof known;
+            bool added = cache.lookup(item.formula.data(), (int) item.formula.size(), &known);
+            for (const CacheItem& other : fresh) {
+                added = added || other.formula == item.formula;
+            }
+            if (!added && (int) fresh.size() < count) {
+                fresh.push_back(item);
+            }
+        }
+    }
+    return fresh;
+}
+
+void testRenamings(const std::string& path, std::mt19937& random) {
+    ProofCache cache;
+    if (!cache.open(path.c_str())) {
+        fail("The cache cannot be opened");
+        return;
+    }
+    std::vector<CacheItem> items = makeItems(1, 150);
+    for (const CacheItem& item : items) {
+        // Each item is added under other names first, so lookups must rename the stored proof back
+        std::vector<int> renamed = renameVariables(item.formula, random);
+        DeltaProof proof;
+        int target;
+        bool correct;
+        if (!cache.add(item.formula.data(), (int) item.formula.size(), item.proof, item.target, true)
+            || !cache.lookup(renamed.data(), (int) renamed.size(), &proof, &target, &correct))
+        {
+            fail("An added expression is not found under other names");
+        }
+    }
+    checkItems(cache, items, random, "Added");
+    int absent[] = {OR, 6, AND, 7, 6, STOP};
+    CachedProof found;
+    if (cache.lookup(absent, 6, &found)) {
+        fail("An expression that was never added is found");
+    }
+    // A proof of more steps for a known expression is not appended
+    size_t bytes = cache.bytes();
+    DeltaProof longer = items[0].proof;
+    longer.steps.push_back(longer.steps[0]);
+    cache.add(items[0].formula.data(), (int) items[0].formula.size(), longer, items[0].target, true);
+    if (cache.bytes() != bytes) {
+        fail("A proof of more steps was appended");
+    }
+    // A correct proof replaces one that is not correct, and then a proof of fewer steps replaces it
+    CacheItem item = freshItems(cache, 50, 1)[0];
+    DeltaProof slower = item.proof;
+    slower.steps.push_back(slower.steps[0]);
+    int lengths[] = {(int) item.proof.steps.size(), (int) slower.steps.size(), (int) item.proof.steps.size()};
+    bool verdicts[] = {false, true, true};
+    for (int k = 0; k < 3; k++) {
+        cache.add(item.formula.data(), (int) item.formula.size(), k == 1 ? slower : item.proof, item.target, verdicts[k]);
+        if (!cache.lookup(item.formula.data(), (int) item.formula.size(), &found) || found.stepCount != lengths[k]
+            || found.correct != verdicts[k])
+        {
+            fail("A better proof of a known expression does not replace its proof");
+        }
+    }
+    std::cout << "Renamings: " << cache.size() << " expressions\n";
+}
+
+void testTornRecords(const std::string& path) {
+    // Records of new items, as another cache file of the same law set writes them
+    ProofCache cache;
+    cache.open(path.c_str());
+    std::vector<CacheItem> items = freshItems(cache, 100, 3);
+    std::string otherPath = path + ".records";
+    std::remove(otherPath.c_str());
+    ProofCache::create(otherPath.c_str(), PE21LF::lawCount);
+    ProofCache other;
+    other.open(otherPath.c_str());
+    size_t start = other.bytes();
+    other.add(items[0].formula.data(), (int) items[0].formula.size(), items[0].proof, items[0].target, true);
+    std::vector<char> record = readFile(otherPath);
+    record.erase(record.begin(), record.begin() + (long) start);
+    other.close();
+    std::remove(otherPath.c_str());
+    size_t expressions = cache.size();
+    size_t validBytes = cache.bytes();
+    for (int kind = 0; kind < 2; kind++) {
+        // A writer that stopped in the middle of the record, or a record of the whole length with a changed symbol of
+        // the expression, since the padding at the end is not checked
+        std::vector<char> torn = record;
+        if (kind == 0) {
+            torn.resize(torn.size() / 2);
+        } else {
+            torn[sizeof(ProofCacheRecord)] ^= 1;
+        }
+        appendBytes(path, torn);
+        ProofCache reader;
+        CachedProof found;
+        if (!cache.refresh() || !reader.open(path.c_str()) || cache.size() != expressions || reader.size() != expressions
+            || cache.lookup(items[0].formula.data(), (int) items[0].formula.size(), &found)
+            || reader.lookup(items[0].formula.data(), (int) items[0].formula.size(), &found))
+        {
+            fail("A torn record was read");
+        }
+        // The next writer cuts the torn record and appends in its place
+        int added = kind + 1;
+        if (!cache.add(items[added].formula.data(), (int) items[added].formula.size(), items[added].proof, items[added].target, true)) {
+            fail("No record is appended after a torn record");
+        }
+        if (!reader.refresh() || reader.size() != expressions + 1 || cache.size() != expressions + 1
+            || reader.bytes() != readFile(path).size() || readFile(path).size() <= validBytes
+            || !reader.lookup(items[added].formula.data(), (int) items[added].formula.size(), &found)
+            || reader.lookup(items[0].formula.data(), (int) items[0].formula.size(), &found))
+        {
+            fail("The record after a torn record is not read in its place");
+        }
+        expressions = cache.size();
+        validBytes = cache.bytes();
+    }
+    std::cout << "Torn records: " << cache.size() << " expressions\n";
+}
+
+void testCompactionWithAppenders(const std::string& path, std::mt19937& random) {
+    // Appenders add the items of their seeds while this process compacts the file again and again. Each item is added
+    // with proofs of fewer and fewer repeated steps before its own proof, so that every add appends a record and the
+    // last record of the item is the one that a compaction must not lose
+    const int appenders = 4;
+    const int itemCount = 60;
+    const int rounds = 12;
+    std::vector<std::vector<CacheItem>> items;
+    for (int p = 0; p < appenders; p++) {
+        items.push_back(makeItems(200 + p, itemCount));
+    }
+    std::vector<pid_t> children;
+    for (int p = 0; p < appenders; p++) {
+        pid_t child = fork();
+        if (child == 0) {
+            ProofCache cache;
+            if (!cache.open(path.c_str())) {
+                _exit(3);
+            }
+            for (int round = rounds; round >= 0; round--) {
+                for (const CacheItem& item : items[p]) {
+                    DeltaProof proof = item.proof;
+                    for (int k = 0; k < round; k++) {
+                        proof.steps.push_back(proof.steps[0]);
+                    }
+                    // The cache has the proof or a better one when add returns, in the file at the path
+                    CachedProof found;
+                    if (!cache.add(item.formula.data(), (int) item.formula.size(), proof, item.target, true)
+                        || !cache.lookup(item.formula.data(), (int) item.formula.size(), &found)
+                        || found.stepCount > (int) proof.steps.size())
+                    {
+                        _exit(4);
+                    }
+                }
+            }
+            _exit(0);
+        }
+        children.push_back(child);
+    }
+    ProofCache cache;
+    cache.open(path.c_str());
+    int compactions = 0;
+    int running = appenders;
+    while (running > 0) {
+        if (!cache.compact()) {
+            fail("A compaction failed while processes were appending");
+        }
+        compactions++;
+        int status;
+        pid_t child;
+        while ((child = waitpid(-1, &status, WNOHANG)) > 0) {
+            running--;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                fail("An appender failed while the file was compacted");
+            }
+        }
+    }
+    // No record that an appender wrote is lost by a compaction that moved the file
+    if (!cache.refresh()) {
+        fail("The cache cannot be refreshed");
+    }
+    for (int p = 0; p < appenders; p++) {
+        checkItems(cache, items[p], random, "Appended while compacting");
+    }
+    size_t expressions = cache.size();
+    if (!cache.compact() || cache.size() != expressions) {
+        fail("A compaction after the appenders changed the expressions");
+    }
+    for (int p = 0; p < appenders; p++) {
+        checkItems(cache, items[p], random, "Compacted");
+    }
+    std::cout << "Compaction with appenders: " << compactions << " compactions, " << cache.size() << " expressions\n";
+}
+
+void testRefreshAfterCompaction(const std::string& path, std::mt19937& random) {
+    ProofCache reader;
+    ProofCache writer;
+    reader.open(path.c_str());
+    writer.open(path.c_str());
+    std::vector<CacheItem> items = freshItems(writer, 300, 40);
+    // A few appended records, which the compaction moves into the table of a smaller file
+    for (int i = 0; i < 4; i++) {
+        writer.add(items[i].formula.data(), (int) items[i].formula.size(), items[i].proof, items[i].target, true);
+    }
+    reader.refresh();
+    size_t oldBytes = reader.bytes();
+    if (!writer.compact()) {
+        fail("The file cannot be compacted");
+    }
+    // Then enough records that the new file is longer than the one the reader mapped, so its length tells nothing
+    for (size_t i = 4; i < items.size(); i++) {
+        writer.add(items[i].formula.data(), (int) items[i].formula.size(), items[i].proof, items[i].target, true);
+    }
+    if (writer.bytes() <= oldBytes) {
+        fail("The compacted file is not longer than the mapped file");
+    }
+    CachedProof found;
+    if (!reader.lookup(items[0].formula.data(), (int) items[0].formula.size(), &found)
+        || reader.lookup(items.back().formula.data(), (int) items.back().formula.size(), &found))
+    {
+        fail("A reader does not keep reading the file it mapped before it refreshes");
+    }
+    if (!reader.refresh() || reader.size() != writer.size() || reader.bytes() != writer.bytes()) {
+        fail("A refresh does not map the file that a compaction put at the path");
+    }
+    checkItems(reader, items, random, "Refreshed");
+    std::cout << "Refresh after compaction: " << reader.size() << " expressions\n";
+}
+
+// Microseconds per lookup of the items, renamed, which must all be found if found is true
+double lookupTime(ProofCache& cache, const std::vector<CacheItem>& items, bool found, std::mt19937& random) {
+    std::vector<std::vector<int>> renamed;
+    for (const CacheItem& item : items) {
+        renamed.push_back(renameVariables(item.formula, random));
+    }
+    const int repeats = 2000;
+    long hits = 0;
+    CachedProof result;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        for (const std::vector<int>& f : renamed) {
+            hits += cache.lookup(f.data(), (int) f.size(), &result);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (hits != (found ? (long) repeats * (long) items.size() : 0)) {
+        fail("Lookups of the timed items were not all the same");
+    }
+    return seconds * 1e6 / ((double) repeats * items.size());
+}
+
+void timeLookups(const std::string& path, std::mt19937& random) {
+    ProofCache cache;
+    cache.open(path.c_str());
+    cache.compact();
+    std::vector<CacheItem> inTable = makeItems(1, 100);
+    std::vector<CacheItem> appended = freshItems(cache, 400, 100);
+    for (const CacheItem& item : appended) {
+        cache.add(item.formula.data(), (int) item.formula.size(), item.proof, item.target, true);
+    }
+    std::vector<CacheItem> absent = freshItems(cache, 500, 100);
+    double tableTime = lookupTime(cache, inTable, true, random);
+    double appendedTime = lookupTime(cache, appended, true, random);
+    double absentTime = lookupTime(cache, absent, false, random);
+    std::cout << "Lookups of " << cache.size() << " expressions: " << tableTime << " us in the table, " << appendedTime
+              << " us appended, " << absentTime << " us absent\n";
+}
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : "ProofCacheTest.cache";
+    std::remove(path.c_str());
+    if (!ProofCache::create(path.c_str(), PE21LF::lawCount)) {
+        std::cout << "Cannot create the cache " << path << "\n";
+        return 2;
+    }
+    std::mt19937 random(1);
+    testRenamings(path, random);
+    testTornRecords(path);
+    testCompactionWithAppenders(path, random);
+    testRefreshAfterCompaction(path, random);
+    timeLookups(path, random);
+    std::remove(path.c_str());
+    std::cout << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+// Writes random proofs and corrupted copies of them to a proof corpus, reads it back from the file and from an
+// image in memory, and compares the verdict of DeltaVerifier on each proof of the corpus with isProofSequence on
+// the proof it was written from. Images with a corrupt header must not attach, proofs whose directory entries are
+// corrupt must not be read outside the blocks, and corrupt blocks must still be read and verified safely
+// g++ -std=c++17 -O2 -I.. ProofCorpusFuzz.cpp -o ProofCorpusFuzz
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../PE21LF.h"
+#include "../ProofCorpus.h"
+#include "RandomProofs.h"
+
+class WrittenProof {
+    public:
+        std::vector<int> formula;
+        DeltaProof delta;
+        int target;
+        bool correct;
+};
+
+long failures = 0;
+
+void fail(const char* message) {
+    if (failures < 10) {
+        std::cout << message << "\n";
+    }
+    failures++;
+}
+
+// The proof of a corpus must be the written one, and get the same verdict
+void checkProof(DeltaVerifier<PE21LF>& verifier, const CorpusProof& read, const WrittenProof& written) {
+    int fStop = indexOfStop((int*) written.formula.data(), (int) written.formula.size());
+    if (read.fLength != fStop + 1 || !std::equal(read.formula, read.formula + fStop + 1, written.formula.begin())
+        || read.stepCount != (int) written.delta.steps.size() || read.insertedLength != (int) written.delta.inserted.size()
+        || !std::equal(read.inserted, read.inserted + read.insertedLength, written.delta.inserted.begin()) || read.target != written.target) {
+        fail("a proof of the corpus differs from the written one");
+        return;
+    }
+    for (int i = 0; i < read.stepCount; i++) {
+        const DeltaStep& x = read.steps[i];
+        const DeltaStep& y = written.delta.steps[i];
+        if (x.law != y.law || x.index != y.index || x.removedLength != y.removedLength || x.insertedStart != y.insertedStart
+            || x.insertedLength != y.insertedLength) {
+            fail("a step of the corpus differs from the written one");
+            return;
+        }
+    }
+    if (verifier.isProofSequence(read.formula, read.fLength, read.steps, read.stepCount, read.inserted, read.insertedLength, read.target)
+        != written.correct) {
+        fail("a verdict differs from isProofSequence");
+    }
+}
+
+// Reads every proof of a corpus whose image may be corrupt: a proof that is read must be within the blocks
+long readCorrupt(DeltaVerifier<PE21LF>& verifier, const uint8_t* image, size_t size) {
+    ProofCorpus corpus;
+    if (!corpus.attach(image, size)) {
+        return -1;
+    }
+    ProofCorpusHeader header;
+    std::memcpy(&header, image, sizeof(ProofCorpusHeader));
+    long read = 0;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        CorpusProof proof;
+        corpus.advance(i);
+        if (!corpus.proof(i, &proof)) {
+            continue;
+        }
+        read++;
+        const uint8_t* start = (const uint8_t*) proof.formula;
+        const uint8_t* end = (const uint8_t*) (proof.inserted + proof.insertedLength);
+        if (start < image + sizeof(ProofCorpusHeader) || end > image + header.directoryOffset || proof.fLength < 1
+            || (const uint8_t*) proof.steps != start + proof.fLength * sizeof(int)
+            || (const uint8_t*) proof.inserted != (const uint8_t*) (proof.steps + proof.stepCount)) {
+            fail("a proof was read outside the blocks");
+            continue;
+        }
+        verifier.isProofSequence(proof.formula, proof.fLength, proof.steps, proof.stepCount, proof.inserted, proof.insertedLength, proof.target);
+    }
+    return read;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    // Random proofs and copies with a wrong law, symbol or target, or a missing step
+    std::vector<WrittenProof> written;
+    ProofChecker<PE21LF> checker;
+    for (int trial = 0; trial < 300; trial++) {
+        SearchProof proof;
+        if (!randomProof<PE21LF>(random, (int) (random() % 6), &proof)) {
+            continue;
+        }
+        for (int mutation = 0; mutation < 4; mutation++) {
+            SearchProof changed = proof;
+            int target = FALSE;
+            int step = (int) (random() % changed.length());
+            int kind = mutation == 0 ? 0 : 1 + (int) (random() % 4);
+            if (kind == 1) {
+                changed.laws[step] = (int) (random() % PE21LF::lawCount);
+            } else if (kind == 2) {
+                int stop = indexOfStop(changed.formulas[step].data(), changed.fLength);
+                changed.formulas[step][random() % stop] = (int) (1 + random() % 8);
+            } else if (kind == 3 && changed.length() > 1) {
+                changed.laws.erase(changed.laws.begin() + step);
+                changed.formulas.erase(changed.formulas.begin() + step);
+            } else if (kind == 4) {
+                target = TRUE;
+            }
+            std::vector<Tuple> sequence = changed.sequence();
+            WrittenProof next;
+            if (!next.delta.encode(changed.formula.data(), changed.fLength, sequence.data(), changed.length())) {
+                continue;
+            }
+            next.formula = changed.formula;
+            next.target = target;
+            next.correct = checker.isProofSequence(changed.formula.data(), changed.fLength, sequence.data(), changed.length(), target);
+            written.push_back(next);
+        }
+    }
+    const char* path = "ProofCorpusFuzz.corpus";
+    ProofCorpusWriter writer;
+    if (!writer.open(path, PE21LF::lawCount)) {
+        fail("the corpus was not written");
+        return 1;
+    }
+    for (WrittenProof& proof : written) {
+        writer.add(proof.formula.data(), (int) proof.formula.size(), proof.delta, proof.target);
+    }
+    std::vector<int> noStop(4, minVariable);
+    if (writer.add(noStop.data(), (int) noStop.size(), written[0].delta, FALSE)) {
+        fail("an expression without STOP was written");
+    }
+    writer.close();
+    // From the mapped file, and from an image in memory
+    DeltaVerifier<PE21LF> verifier;
+    long correct = 0;
+    ProofCorpus corpus;
+    if (!corpus.open(path) || corpus.size() != written.size() || corpus.lawCount() != PE21LF::lawCount) {
+        fail("the corpus did not open");
+    } else {
+        for (size_t i = 0; i < corpus.size(); i++) {
+            CorpusProof proof;
+            corpus.advance(i);
+            if (!corpus.proof(i, &proof)) {
+                fail("a proof was not read");
+                continue;
+            }
+            checkProof(verifier, proof, written[i]);
+            correct += written[i].correct;
+        }
+        CorpusProof proof;
+        if (corpus.proof(corpus.size(), &proof)) {
+            fail("a proof after the last one was read");
+        }
+    }
+    corpus.close();
+    std::ifstream input(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    std::remove(path);
+    // Whole 64-bit words, so that the image is aligned like a mapped file
+    std::vector<uint64_t> words((bytes.size() + 7) / 8);
+    uint8_t* image = (uint8_t*) words.data();
+    std::memcpy(image, bytes.data(), bytes.size());
+    size_t size = bytes.size();
+    if (!corpus.attach(image, size)) {
+        fail("the image did not attach");
+        return 1;
+    }
+    for (size_t i = 0; i < corpus.size(); i++) {
+        CorpusProof proof;
+        if (corpus.proof(i, &proof)) {
+            checkProof(verifier, proof, written[i]);
+        }
+    }
+    if (corpus.attach(image + 4, size - 4)) {
+        fail("an image that is not aligned attached");
+    }
+    ProofCorpusHeader header;
+    std::memcpy(&header, image, sizeof(ProofCorpusHeader));
+    // Corrupt headers, which must not attach, except for the law count, which the caller checks
+    long rejected = 0;
+    for (int field = 0; field < 6; field++) {
+        for (int64_t change : {(int64_t) -8, (int64_t) -1, (int64_t) 1, (int64_t) 8, ((int64_t) 1 << 40) + ((int64_t) 1 << 31)}) {
+            ProofCorpusHeader changed = header;
+            if (field == 0) changed.magic += (uint32_t) change;
+            if (field == 1) changed.version += (uint32_t) change;
+            if (field == 2) changed.lawCount += (uint32_t) change;
+            if (field == 3) changed.stepSize += (uint32_t) change;
+            if (field == 4) changed.proofCount += (uint64_t) change;
+            if (field == 5) changed.directoryOffset += (uint64_t) change;
+            std::vector<uint64_t> changedWords = words;
+            std::memcpy(changedWords.data(), &changed, sizeof(ProofCorpusHeader));
+            bool attached = corpus.attach((const uint8_t*) changedWords.data(), size);
+            if (attached != (field == 2)) {
+                fail("a corrupt header attached");
+            }
+            rejected += !attached;
+        }
+    }
+    for (size_t cut : {(size_t) 1, sizeof(ProofCorpusEntry), size - sizeof(ProofCorpusHeader) + 1}) {
+        if (corpus.attach(image, size - cut)) {
+            fail("a truncated image attached");
+        }
+        rejected++;
+    }
+    // Corrupt directory entries, whose proofs must not be read outside the blocks
+    long read = 0;
+    size_t entries = (size - header.directoryOffset) / sizeof(ProofCorpusEntry);
+    for (int trial = 0; trial < 400; trial++) {
+        std::vector<uint64_t> changedWords = words;
+        uint8_t* changed = (uint8_t*) changedWords.data();
+        for (int k = 0; k < 1 + trial % 8; k++) {
+            ProofCorpusEntry* entry = (ProofCorpusEntry*) (changed + header.directoryOffset) + random() % entries;
+            uint64_t large = (uint64_t) 1 << (random() % 64);
+            switch (random() % 6) {
+                case 0: entry->offset = random() % 2 == 0 ? entry->offset + (int) (random() % 17) - 8 : large; break;
+                case 1: entry->fLength = random() % 2 == 0 ? entry->fLength + 1 : (uint32_t) large; break;
+                case 2: entry->stepCount = random() % 2 == 0 ? entry->stepCount + 1 : (uint32_t) large; break;
+                case 3: entry->insertedLength = random() % 2 == 0 ? entry->insertedLength + 1 : (uint32_t) large; break;
+                case 4: entry->target = (int32_t) (random() % 8); break;
+                default: entry->offset = header.directoryOffset - (random() % 64) * sizeof(int); break;
+            }
+        }
+        // And corrupt blocks, whose symbols and steps the verifier must read safely
+        for (int k = 0; k < trial % 16; k++) {
+            size_t at = sizeof(ProofCorpusHeader) + random() % (header.directoryOffset - sizeof(ProofCorpusHeader));
+            changed[at] = random() % 2 == 0 ? (uint8_t) random() : (uint8_t) (changed[at] ^ 0x80);
+        }
+        long count = readCorrupt(verifier, changed, size);
+        if (count < 0) {
+            fail("an image with corrupt entries did not attach");
+        }
+        read += count;
+    }
+    std::cout << written.size() << " proofs written, " << correct << " correct, " << rejected << " corrupt headers rejected, "
+              << read << " proofs read from corrupt images: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
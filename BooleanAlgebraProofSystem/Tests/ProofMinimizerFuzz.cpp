@@ -0,0 +1,125 @@
+// Minimizes random proofs, which are random walks that step back and forth followed by a proof from a ProofSearch,
+// and checks that each minimized proof is correct for isProofSequence, starts from the same expression, is no longer
+// than the proof, is shorter by the steps counted for cycles and shortcuts, and is shorter whenever the proof comes
+// back to a state. Changed copies of the proofs that are not correct must not be minimized. With a second argument,
+// the proofs are also written as a proof corpus for MinimizeCorpus
+// g++ -std=c++17 -O2 -I.. ProofMinimizerFuzz.cpp -o ProofMinimizerFuzz
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../PE21LF.h"
+#include "../ProofCorpus.h"
+#include "../ProofMinimizer.h"
+#include "RandomProofs.h"
+
+// The proof comes back to an expression with the same variables in use
+bool hasCycle(const SearchProof& proof) {
+    ProofChecker<PE21LF> checker;
+    std::vector<std::vector<int>> formulas(1, proof.formula);
+    std::vector<std::vector<VariableRecord>> variables(1);
+    checker.storeInitialVariables((int*) proof.formula.data());
+    checker.variables().save(variables[0]);
+    int* previous = (int*) proof.formula.data();
+    for (int i = 0; i < proof.length(); i++) {
+        int* next = (int*) proof.formulas[i].data();
+        checker.isTransformationByLaw(previous, next, proof.fLength, proof.laws[i]);
+        std::vector<VariableRecord> records;
+        checker.variables().save(records);
+        for (size_t k = 0; k < formulas.size(); k++) {
+            if (formulas[k] == proof.formulas[i] && sameVariables(variables[k], records)) {
+                return true;
+            }
+        }
+        formulas.push_back(proof.formulas[i]);
+        variables.push_back(records);
+        previous = next;
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    ProofCorpusWriter corpus;
+    if (argc > 2 && !corpus.open(argv[2], PE21LF::lawCount)) {
+        std::cout << "Cannot write the proof corpus " << argv[2] << "\n";
+        return 2;
+    }
+    long proofs = 0, steps = 0, minimizedSteps = 0, cycleSteps = 0, shortcutSteps = 0, failures = 0;
+    double seconds = 0;
+    ProofMinimizer<PE21LF> minimizer;
+    ProofChecker<PE21LF> checker;
+    for (int trial = 0; trial < 1000; trial++) {
+        SearchProof proof;
+        if (!randomProof<PE21LF>(random, (int) (random() % 13), &proof)) {
+            continue;
+        }
+        proofs++;
+        std::vector<Tuple> sequence = proof.sequence();
+        if (argc > 2) {
+            DeltaProof delta;
+            if (!delta.encode(proof.formula.data(), proof.fLength, sequence.data(), proof.length())
+                || !corpus.add(proof.formula.data(), proof.fLength, delta, FALSE))
+            {
+                std::cout << "Cannot write the proof corpus " << argv[2] << "\n";
+                return 2;
+            }
+        }
+        SearchProof minimized;
+        auto start = std::chrono::steady_clock::now();
+        bool result = minimizer.minimize(proof.formula.data(), proof.fLength, sequence.data(), proof.length(), FALSE, &minimized);
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!result) {
+            std::cout << "Trial " << trial << ": a correct proof was not minimized\n";
+            failures++;
+            continue;
+        }
+        std::vector<Tuple> minimizedSequence = minimized.sequence();
+        int fStop = indexOfStop(proof.formula.data(), proof.fLength);
+        if (!checker.isProofSequence(minimized.formula.data(), minimized.fLength, minimizedSequence.data(), minimized.length(), FALSE)
+            || indexOfStop(minimized.formula.data(), minimized.fLength) != fStop
+            || !std::equal(proof.formula.begin(), proof.formula.begin() + fStop, minimized.formula.begin()))
+        {
+            std::cout << "Trial " << trial << ": the minimized proof is not correct for the expression\n";
+            failures++;
+        }
+        if (minimized.length() > proof.length()
+            || minimized.length() != proof.length() - minimizer.cycleSteps() - minimizer.shortcutSteps())
+        {
+            std::cout << "Trial " << trial << ": " << proof.length() << " steps minimized to " << minimized.length() << " with "
+                      << minimizer.cycleSteps() << " cut by cycles and " << minimizer.shortcutSteps() << " by shortcuts\n";
+            failures++;
+        }
+        if (hasCycle(proof) && minimized.length() == proof.length()) {
+            // The minimizer keeps the proof as it was when its result is not correct, which would hide a wrong cut
+            std::cout << "Trial " << trial << ": a proof that comes back to a state was not minimized\n";
+            failures++;
+        }
+        steps += proof.length();
+        minimizedSteps += minimized.length();
+        cycleSteps += minimizer.cycleSteps();
+        shortcutSteps += minimizer.shortcutSteps();
+        // A changed law or symbol that the checker rejects must be rejected by the minimizer too
+        SearchProof changed = proof;
+        int step = (int) (random() % changed.length());
+        if (random() % 2 == 0) {
+            changed.laws[step] = (int) (random() % PE21LF::lawCount);
+        } else {
+            int stop = indexOfStop(changed.formulas[step].data(), changed.fLength);
+            changed.formulas[step][random() % (stop + 1)] = (int) (random() % 9);
+        }
+        std::vector<Tuple> changedSequence = changed.sequence();
+        bool expected = checker.isProofSequence(changed.formula.data(), changed.fLength, changedSequence.data(), changed.length(), FALSE);
+        if (!expected && minimizer.minimize(changed.formula.data(), changed.fLength, changedSequence.data(), changed.length(), FALSE, &minimized)) {
+            std::cout << "Trial " << trial << ": a proof that is not correct was minimized\n";
+            failures++;
+        }
+    }
+    if (argc > 2 && !corpus.close()) {
+        std::cout << "Cannot write the proof corpus " << argv[2] << "\n";
+        return 2;
+    }
+    std::cout << proofs << " proofs: " << steps << " steps minimized to " << minimizedSteps << ", " << cycleSteps << " cut by cycles and "
+              << shortcutSteps << " by shortcuts, " << seconds * 1e6 / proofs << " us per proof: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
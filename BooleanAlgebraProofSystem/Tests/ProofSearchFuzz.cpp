@@ -0,0 +1,194 @@
+// Compares the proof searches with a brute-force evaluator and a breadth-first search on random small expressions.
+// Every proof must be accepted by isProofSequence, no proof may be shorter than the breadth-first search allows,
+// and expressions that are not tautologies or contradictions must have no proof. ProofSearch and
+// DeepeningProofSearch, with LengthBound and PatternDatabaseBound, must find proofs of the same length
+// g++ -std=c++17 -O2 -I.. ProofSearchFuzz.cpp -o ProofSearchFuzz
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+#include "../PE21LF.h"
+#include "../ProofSearch.h"
+
+void randomExpression(std::mt19937& random, int variableCount, int depth, std::vector<int>& f) {
+    int kind = (int) (random() % 10);
+    if (depth == 0 || kind < 3) {
+        int leaf = (int) (random() % 8);
+        f.push_back(leaf == 0 ? FALSE : leaf == 1 ? TRUE : minVariable + (int) (random() % variableCount));
+    } else if (kind < 5) {
+        f.push_back(NOT);
+        randomExpression(random, variableCount, depth - 1, f);
+    } else {
+        f.push_back(kind < 8 ? OR : AND);
+        randomExpression(random, variableCount, depth - 1, f);
+        randomExpression(random, variableCount, depth - 1, f);
+    }
+}
+
+bool evaluate(const std::vector<int>& f, size_t& position, uint64_t values) {
+    int symbol = f[position++];
+    if (symbol == NOT) {
+        return !evaluate(f, position, values);
+    }
+    if (symbol == OR || symbol == AND) {
+        bool left = evaluate(f, position, values);
+        bool right = evaluate(f, position, values);
+        return symbol == OR ? left || right : left && right;
+    }
+    return symbol == TRUE || (isVariable(symbol) && ((values >> (symbol - minVariable)) & 1));
+}
+
+// A state of the breadth-first search: the expression, then the fields of every variable record
+std::vector<int> stateKey(const std::vector<int>& f, int fStop, const std::vector<VariableRecord>& variables) {
+    std::vector<int> key(f.begin(), f.begin() + fStop);
+    key.push_back(STOP);
+    for (const VariableRecord& record : variables) {
+        key.insert(key.end(), {record.name, record.count, record.type, record.a, record.b});
+    }
+    return key;
+}
+
+// Fewest steps to the target up to maxSteps, or maxSteps + 1, over the same steps as the searches: those of the
+// move generator that the checker confirms, of expressions no longer than longest. Every state is kept exactly
+int breadthFirstDistance(const std::vector<int>& formula, int longest, int target, int maxSteps) {
+    int arrayLength = longest + 1;
+    ProofChecker<PE21LF> checker;
+    MoveGenerator<PE21LF> moves;
+    std::vector<int> f(arrayLength, STOP);
+    std::copy(formula.begin(), formula.end(), f.begin());
+    std::vector<VariableRecord> variables;
+    checker.storeInitialVariables(f.data());
+    checker.variables().save(variables);
+    std::set<std::vector<int>> seen = {stateKey(f, (int) formula.size(), variables)};
+    std::vector<std::pair<std::vector<int>, std::vector<VariableRecord>>> level = {{f, variables}};
+    std::vector<int> g(arrayLength);
+    std::vector<VariableRecord> nextVariables;
+    for (int steps = 1; steps <= maxSteps; steps++) {
+        std::vector<std::pair<std::vector<int>, std::vector<VariableRecord>>> next;
+        bool reached = false;
+        for (auto& state : level) {
+            int fStop = indexOfStop(state.first.data(), arrayLength);
+            checker.variables().restore(state.second.data(), (int) state.second.size());
+            moves.generate(state.first.data(), fStop, state.second.data(), (int) state.second.size(),
+                [&](int law, int index, const int* replacement, int replacementLength, int replacedLength) {
+                    int gStop = fStop - replacedLength + replacementLength;
+                    if (reached || gStop > longest) {
+                        return;
+                    }
+                    std::fill(g.begin(), g.end(), STOP);
+                    std::copy(state.first.begin(), state.first.begin() + index, g.begin());
+                    std::copy(replacement, replacement + replacementLength, g.begin() + index);
+                    std::copy(state.first.begin() + index + replacedLength, state.first.begin() + fStop, g.begin() + index + replacementLength);
+                    if (!checker.isTransformationByLaw(state.first.data(), g.data(), arrayLength, law)) {
+                        return;
+                    }
+                    checker.variables().save(nextVariables);
+                    checker.variables().restore(state.second.data(), (int) state.second.size());
+                    if (gStop == 1 && g[0] == target) {
+                        reached = true;
+                    } else if (seen.insert(stateKey(g, gStop, nextVariables)).second) {
+                        next.emplace_back(g, nextVariables);
+                    }
+                });
+            if (reached) {
+                return steps;
+            }
+        }
+        level.swap(next);
+    }
+    return maxSteps + 1;
+}
+
+long failures = 0;
+
+void fail(int trial, const char* message) {
+    if (failures < 10) {
+        std::cout << "Trial " << trial << ": " << message << "\n";
+    }
+    failures++;
+}
+
+// Length of the proof that a search found, or -1, which isProofSequence must accept
+template <class Search>
+int checkedProofLength(int trial, Search& search, std::vector<int>& f, int target) {
+    SearchProof proof;
+    if (!search.findProof(f.data(), (int) f.size(), target, &proof)) {
+        return -1;
+    }
+    std::vector<Tuple> sequence = proof.sequence();
+    ProofChecker<PE21LF> checker;
+    if (proof.length() == 0 || !checker.isProofSequence(proof.formula.data(), proof.fLength, sequence.data(), proof.length(), target)) {
+        fail(trial, "a proof that isProofSequence rejects");
+    }
+    return proof.length();
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    long proofs = 0, unproved = 0, contingents = 0, compared = 0, lengthTotal = 0;
+    ProofSearch<PE21LF> search;
+    search.setNodeLimit(100000);
+    ProofSearch<PE21LF, PatternDatabaseBound<PE21LF>> patternSearch;
+    patternSearch.setNodeLimit(100000);
+    for (int trial = 0; trial < 1500; trial++) {
+        std::vector<int> f;
+        randomExpression(random, 1 + (int) (random() % 2), 1 + (int) (random() % 3), f);
+        if (f.size() > 7 || f.size() < 2) {
+            continue;
+        }
+        bool satisfied = false, falsified = false;
+        for (uint64_t values = 0; values < 4; values++) {
+            size_t position = 0;
+            (evaluate(f, position, values) ? satisfied : falsified) = true;
+        }
+        std::vector<int> array = f;
+        array.push_back(STOP);
+        if (satisfied && falsified) {
+            // No proof of either value, which a small search exhausts or gives up on
+            contingents++;
+            ProofSearch<PE21LF> small;
+            small.setNodeLimit(2000);
+            DeepeningProofSearch<PE21LF> deepening;
+            deepening.setMaxDepth(3);
+            for (int target : {FALSE, TRUE}) {
+                if (checkedProofLength(trial, small, array, target) >= 0 || checkedProofLength(trial, deepening, array, target) >= 0) {
+                    fail(trial, "a proof of an expression that is neither a tautology nor a contradiction");
+                }
+            }
+            continue;
+        }
+        int target = satisfied ? TRUE : FALSE;
+        int length = checkedProofLength(trial, search, array, target);
+        if (length < 0) {
+            // A proof longer than the node limit allows, unless the breadth-first search finds a short one
+            if (breadthFirstDistance(f, (int) f.size() + 8, target, 3) <= 3) {
+                fail(trial, "no proof of a tautology or contradiction that has a short one");
+            }
+            unproved++;
+            continue;
+        }
+        proofs++;
+        lengthTotal += length;
+        // The other searches give a proof of the same length
+        int patternLength = checkedProofLength(trial, patternSearch, array, target);
+        DeepeningProofSearch<PE21LF> deepening;
+        deepening.setMaxDepth(length);
+        DeepeningProofSearch<PE21LF, PatternDatabaseBound<PE21LF>> patternDeepening;
+        patternDeepening.setMaxDepth(length);
+        if (patternLength != length || checkedProofLength(trial, deepening, array, target) != length
+            || checkedProofLength(trial, patternDeepening, array, target) != length) {
+            fail(trial, "proofs of different lengths");
+        }
+        // No shorter proof, with the default longest expression of 8 symbols more than the initial one
+        if (length <= 3) {
+            compared++;
+            if (breadthFirstDistance(f, (int) f.size() + 8, target, length) != length) {
+                fail(trial, "a proof that is not the shortest");
+            }
+        }
+    }
+    std::cout << proofs << " proofs of mean length " << (proofs > 0 ? (double) lengthTotal / proofs : 0) << ", "
+              << compared << " compared with breadth-first search, " << unproved << " over the node limit, " << contingents
+              << " without proofs: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
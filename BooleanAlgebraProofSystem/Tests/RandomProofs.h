@@ -0,0 +1,117 @@
+#ifndef RANDOM_PROOFS_H
+#define RANDOM_PROOFS_H
+
+#include <random>
+#include <vector>
+
+#include "../ProofSearch.h"
+
+// Random proofs of FALSE for the fuzzers: a random walk of steps from a small contradiction, which sometimes steps
+// straight back to where it was, then a proof of FALSE from where the walk ends that a ProofSearch finds
+
+// Array length of every expression of a random proof
+const int randomProofLength = 40;
+
+inline bool sameVariables(const std::vector<VariableRecord>& x, const std::vector<VariableRecord>& y) {
+    if (x.size() != y.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < x.size(); i++) {
+        if (x[i].name != y[i].name || x[i].count != y[i].count || x[i].type != y[i].type || x[i].a != y[i].a || x[i].b != y[i].b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class LawSet>
+bool randomProof(std::mt19937& random, int walkLength, SearchProof* proof) {
+    static const std::vector<std::vector<int>> starts = {
+        {AND, 7, AND, 6, NOT, 6}, {OR, AND, 6, NOT, 6, AND, 7, FALSE}, {AND, OR, 6, FALSE, NOT, OR, 6, FALSE},
+        {AND, NOT, 6, AND, 7, 6}, {OR, FALSE, AND, 6, NOT, 6}};
+    const std::vector<int>& start = starts[random() % starts.size()];
+    proof->fLength = randomProofLength;
+    proof->formula.assign(randomProofLength, STOP);
+    std::copy(start.begin(), start.end(), proof->formula.begin());
+    proof->laws.clear();
+    proof->formulas.clear();
+    StepExpander<LawSet> expander;
+    std::vector<VariableRecord> variables;
+    expander.initialVariables(proof->formula.data(), variables);
+    std::vector<int> current = proof->formula;
+    int stop = (int) start.size();
+    for (int k = 0; k < walkLength; k++) {
+        std::vector<std::vector<int>> nexts;
+        std::vector<int> laws;
+        std::vector<std::vector<VariableRecord>> nextVariables;
+        expander.expand(current.data(), stop, randomProofLength, variables.data(), (int) variables.size(),
+            [&](int law, int index, const int g[], int gStop, const std::vector<VariableRecord>& records) {
+                (void) index;
+                if (gStop <= 14) {
+                    nexts.emplace_back(g, g + randomProofLength);
+                    laws.push_back(law);
+                    nextVariables.push_back(records);
+                }
+            });
+        if (nexts.empty()) {
+            break;
+        }
+        int choice = (int) (random() % nexts.size());
+        std::vector<int> previous = current;
+        std::vector<VariableRecord> previousVariables = variables;
+        current = nexts[choice];
+        variables = nextVariables[choice];
+        stop = indexOfStop(current.data(), randomProofLength);
+        proof->laws.push_back(laws[choice]);
+        proof->formulas.push_back(current);
+        if (random() % 2 == 0) {
+            // A step back, which makes a cycle for the minimizer
+            int backLaw = noLaw;
+            expander.expand(current.data(), stop, randomProofLength, variables.data(), (int) variables.size(),
+                [&](int law, int index, const int g[], int gStop, const std::vector<VariableRecord>& records) {
+                    (void) index;
+                    (void) gStop;
+                    if (backLaw == noLaw && std::equal(g, g + randomProofLength, previous.begin()) && sameVariables(records, previousVariables)) {
+                        backLaw = law;
+                    }
+                });
+            if (backLaw != noLaw) {
+                current = previous;
+                variables = previousVariables;
+                stop = indexOfStop(current.data(), randomProofLength);
+                proof->laws.push_back(backLaw);
+                proof->formulas.push_back(current);
+            }
+        }
+    }
+    ProofSearch<LawSet> search;
+    search.setNodeLimit(20000);
+    search.setMaxLength(16);
+    SearchProof found;
+    if (!search.findProof(current.data(), randomProofLength, FALSE, &found)) {
+        return false;
+    }
+    for (int i = 0; i < found.length(); i++) {
+        std::vector<int> g(randomProofLength, STOP);
+        std::copy(found.formulas[i].begin(), found.formulas[i].begin() + std::min((int) found.formulas[i].size(), randomProofLength), g.begin());
+        proof->laws.push_back(found.laws[i]);
+        proof->formulas.push_back(g);
+    }
+    // The proof ends at the first step that reaches FALSE
+    for (int i = 0; i < proof->length(); i++) {
+        if (proof->formulas[i][0] == FALSE && proof->formulas[i][1] == STOP) {
+            proof->laws.resize(i + 1);
+            proof->formulas.resize(i + 1);
+            break;
+        }
+    }
+    if (proof->length() == 0) {
+        return false;
+    }
+    // The search starts from the variables of its own expression rather than those the walk left, which can disagree
+    std::vector<Tuple> sequence = proof->sequence();
+    ProofChecker<LawSet> checker;
+    return checker.isProofSequence(proof->formula.data(), proof->fLength, sequence.data(), proof->length(), FALSE);
+}
+
+#endif
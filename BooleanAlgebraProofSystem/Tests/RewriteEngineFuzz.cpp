@@ -0,0 +1,112 @@
+// Compares RewriteEngine with a ProofChecker on whole expressions, over random walks of generated and corrupted
+// steps with random undos, and checks that every undo restores the expression and the variables of its depth
+// g++ -std=c++17 -O2 -I.. RewriteEngineFuzz.cpp -o RewriteEngineFuzz
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../PE21LF.h"
+#include "../RewriteEngine.h"
+
+static bool sameRecords(const std::vector<VariableRecord>& x, const std::vector<VariableRecord>& y) {
+    if (x.size() != y.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < x.size(); i++) {
+        if (x[i].name != y[i].name || x[i].count != y[i].count || x[i].type != y[i].type || x[i].a != y[i].a || x[i].b != y[i].b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    const int arrayLength = 48;
+    std::vector<std::vector<int>> starts = {
+        {AND, 7, AND, 6, NOT, 6}, {OR, AND, 6, NOT, 6, AND, 7, FALSE}, {AND, OR, 6, FALSE, NOT, OR, 6, FALSE},
+        {OR, NOT, AND, 6, 7, OR, 8, TRUE}, {AND, OR, 6, 7, OR, 6, NOT, 7}};
+    long applied = 0, rejected = 0, undone = 0, failures = 0;
+    for (int walk = 0; walk < 2000; walk++) {
+        std::vector<int> start = starts[random() % starts.size()];
+        start.push_back(STOP);
+        RewriteEngine<PE21LF> engine;
+        engine.load(start.data(), (int) start.size());
+        ProofChecker<PE21LF> reference;
+        // Expression and variables at each depth, to compare with after an undo
+        std::vector<std::vector<int>> formulas(1, std::vector<int>(engine.formula(), engine.formula() + engine.length()));
+        std::vector<std::vector<VariableRecord>> tables(1);
+        engine.variables().save(tables[0]);
+        std::vector<Rewrite> rewrites;
+        for (int step = 0; step < 40; step++) {
+            if (engine.depth() > 0 && random() % 4 == 0) {
+                size_t depth = random() % engine.depth();
+                engine.undoTo(depth);
+                formulas.resize(depth + 1);
+                tables.resize(depth + 1);
+                std::vector<VariableRecord> records;
+                engine.variables().save(records);
+                if (!std::equal(formulas[depth].begin(), formulas[depth].end(), engine.formula()) || (int) formulas[depth].size() != engine.length()
+                    || engine.formula()[engine.length()] != STOP || !sameRecords(records, tables[depth])) {
+                    std::cout << "Undo to depth " << depth << " did not restore the expression or its variables\n";
+                    failures++;
+                }
+                undone++;
+                continue;
+            }
+            engine.steps(rewrites);
+            if (rewrites.empty()) {
+                break;
+            }
+            Rewrite rewrite = rewrites[random() % rewrites.size()];
+            if (random() % 3 == 0) {
+                // A corrupted step, which the engine must reject exactly when the reference does
+                rewrite.replacement[random() % rewrite.replacementLength] = (int) (random() % 9) + (random() % 2 ? 0 : 1);
+                if (random() % 4 == 0) {
+                    rewrite.index = (int) (random() % engine.length());
+                }
+            }
+            if (rewrite.index + rewrite.replacedLength > engine.length() || rewrite.replacement[0] == STOP
+                || engine.length() + rewrite.replacementLength - rewrite.replacedLength + 1 > arrayLength) {
+                continue;
+            }
+            // Whole expressions before and after the step, for the reference
+            std::vector<int> f(arrayLength, STOP), g(arrayLength, STOP);
+            std::copy(engine.formula(), engine.formula() + engine.length(), f.begin());
+            std::copy(engine.formula(), engine.formula() + rewrite.index, g.begin());
+            std::copy(rewrite.replacement, rewrite.replacement + rewrite.replacementLength, g.begin() + rewrite.index);
+            std::copy(engine.formula() + rewrite.index + rewrite.replacedLength, engine.formula() + engine.length(),
+                g.begin() + rewrite.index + rewrite.replacementLength);
+            reference.variables().restore(tables.back().data(), (int) tables.back().size());
+            bool expected = reference.isTransformationByLaw(f.data(), g.data(), arrayLength, rewrite.law);
+            bool result = engine.apply(rewrite);
+            if (result != expected) {
+                std::cout << "Step of law " << rewrite.law << " at " << rewrite.index << " was " << (result ? "applied" : "rejected") << " by the engine only\n";
+                failures++;
+                break;
+            }
+            std::vector<VariableRecord> records;
+            engine.variables().save(records);
+            if (!result) {
+                rejected++;
+                if (!sameRecords(records, tables.back())) {
+                    std::cout << "A rejected step changed the variables\n";
+                    failures++;
+                }
+                continue;
+            }
+            applied++;
+            std::vector<VariableRecord> referenceRecords;
+            reference.variables().save(referenceRecords);
+            int gStop = indexOfStop(g.data(), arrayLength);
+            if (gStop != engine.length() || !std::equal(g.begin(), g.begin() + gStop, engine.formula()) || !sameRecords(records, referenceRecords)) {
+                std::cout << "Step of law " << rewrite.law << " at " << rewrite.index << " left another expression or other variables\n";
+                failures++;
+                break;
+            }
+            formulas.emplace_back(g.begin(), g.begin() + gStop);
+            tables.push_back(records);
+        }
+    }
+    std::cout << applied << " steps applied, " << rejected << " rejected, " << undone << " undos: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
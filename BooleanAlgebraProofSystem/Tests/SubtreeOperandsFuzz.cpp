@@ -0,0 +1,214 @@
+// Compares isTransformationByLaw in subtreeOperands mode with a slow reference that parses both expressions against
+// the pattern of the law at every subtree, on steps that apply a law to random operand subtrees, with or without a
+// changed symbol after them, and on changed symbols. The variables in use after an accepted step must be those of
+// the next expression
+// g++ -std=c++17 -O2 -I.. SubtreeOperandsFuzz.cpp -o SubtreeOperandsFuzz
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../PE21LF.h"
+#include "RandomProofs.h"
+
+const int arrayLength = 96;
+
+// Symbols of the subtree at i, counted forward by arity, or 0 if no whole subtree starts there
+int spanAt(const std::vector<int>& f, int i) {
+    int stop = indexOfStop((int*) f.data(), arrayLength);
+    int needed = 1;
+    int j = i;
+    while (j < stop && needed > 0) {
+        int symbol = f[j++];
+        if (symbol == OR || symbol == AND) {
+            needed++;
+        } else if (isBoolean(symbol)) {
+            needed--;
+        } else if (symbol != NOT) {
+            return 0;
+        }
+    }
+    return needed == 0 ? j - i : 0;
+}
+
+void randomExpression(std::mt19937& random, int depth, std::vector<int>& f) {
+    int kind = (int) (random() % 10);
+    if (depth == 0 || kind < 4) {
+        int leaf = (int) (random() % 5);
+        f.push_back(leaf < 2 ? FALSE + leaf : 6 + (int) (random() % 3));
+    } else if (kind < 6) {
+        f.push_back(NOT);
+        randomExpression(random, depth - 1, f);
+    } else {
+        f.push_back(kind < 8 ? OR : AND);
+        randomExpression(random, depth - 1, f);
+        randomExpression(random, depth - 1, f);
+    }
+}
+
+// One side of a pattern with its variables replaced by the operand subtrees
+std::vector<int> instantiate(const int pattern[], int length, bool dual, const std::vector<int> operands[3]) {
+    std::vector<int> h;
+    for (int i = 0; i < length; i++) {
+        if (pattern[i] < 0) {
+            h.insert(h.end(), operands[-pattern[i] - 1].begin(), operands[-pattern[i] - 1].end());
+        } else {
+            h.push_back(dual ? dualSymbol(pattern[i]) : pattern[i]);
+        }
+    }
+    return h;
+}
+
+// Binds the variables of one side of a pattern to the subtrees of h from position, and moves position past them
+bool parseSide(const std::vector<int>& h, int stop, const int pattern[], int length, bool dual, std::vector<int> operands[3],
+    bool bound[3], int* position)
+{
+    for (int i = 0; i < length; i++) {
+        if (pattern[i] >= 0) {
+            if (*position >= stop || h[*position] != (dual ? dualSymbol(pattern[i]) : pattern[i])) {
+                return false;
+            }
+            (*position)++;
+            continue;
+        }
+        int span = spanAt(h, *position);
+        if (span == 0) {
+            return false;
+        }
+        std::vector<int> operand(h.begin() + *position, h.begin() + *position + span);
+        int variable = -pattern[i] - 1;
+        if (bound[variable] && operands[variable] != operand) {
+            return false;
+        }
+        operands[variable] = operand;
+        bound[variable] = true;
+        *position += span;
+    }
+    return true;
+}
+
+// f = prefix + one side of the law + suffix and g = prefix + the other side + suffix, for some subtree of f
+bool reference(const std::vector<int>& f, const std::vector<int>& g, const LawRule& law) {
+    int fStop = indexOfStop((int*) f.data(), arrayLength);
+    int gStop = indexOfStop((int*) g.data(), arrayLength);
+    if (fStop == gStop && std::equal(f.begin(), f.begin() + fStop, g.begin())) {
+        return false;
+    }
+    const LawPattern& pattern = lawPatterns[law.matcher];
+    for (int root = 0; root < fStop && (root == 0 || f[root - 1] == g[root - 1]); root++) {
+        if (spanAt(f, root) == 0) {
+            continue;
+        }
+        for (int dual = law.form == AND; dual <= (law.form != OR); dual++) {
+            for (int direction = 0; direction < 2; direction++) {
+                std::vector<int> operands[3];
+                bool bound[3] = {false, false, false};
+                int fEnd = root;
+                int gEnd = root;
+                if (!parseSide(f, fStop, direction == 0 ? pattern.previous : pattern.next,
+                        direction == 0 ? pattern.previousLength : pattern.nextLength, dual, operands, bound, &fEnd)
+                    || !parseSide(g, gStop, direction == 0 ? pattern.next : pattern.previous,
+                        direction == 0 ? pattern.nextLength : pattern.previousLength, dual, operands, bound, &gEnd))
+                {
+                    continue;
+                }
+                if (fStop - fEnd == gStop - gEnd && std::equal(f.begin() + fEnd, f.begin() + fStop, g.begin() + gEnd)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    long steps = 0, accepted = 0, failures = 0;
+    ProofChecker<PE21LF> checker, reader;
+    checker.setOperandMode(subtreeOperands);
+    for (int trial = 0; trial < 60000; trial++) {
+        std::vector<int> f;
+        randomExpression(random, 2 + (int) (random() % 3), f);
+        if ((int) f.size() > 40) {
+            continue;
+        }
+        int fStop = (int) f.size();
+        f.resize(arrayLength, STOP);
+        int law = (int) (random() % PE21LF::lawCount);
+        const LawRule& rule = PE21LF::rules[law];
+        if (rule.matcher == substitutionMatcher) {
+            continue;
+        }
+        const LawPattern& pattern = lawPatterns[rule.matcher];
+        int root = (int) (random() % fStop);
+        int span = spanAt(f, root);
+        int direction = (int) (random() % 2);
+        bool dual = rule.form == AND || (rule.form == bothForms && random() % 2 == 0);
+        std::vector<int> operands[3];
+        for (int variable = 0; variable < 3; variable++) {
+            randomExpression(random, (int) (random() % 3), operands[variable]);
+        }
+        std::vector<int> previous = instantiate(direction == 0 ? pattern.previous : pattern.next,
+            direction == 0 ? pattern.previousLength : pattern.nextLength, dual, operands);
+        std::vector<int> next = instantiate(direction == 0 ? pattern.next : pattern.previous,
+            direction == 0 ? pattern.nextLength : pattern.previousLength, dual, operands);
+        std::vector<int> g;
+        int kind = (int) (random() % 5);
+        if (kind == 0 || kind == 4) {
+            // Both sides of the law in place of the subtree at root, with a changed symbol after them in g for kind 4
+            std::vector<int> h(f.begin(), f.begin() + root);
+            g = h;
+            h.insert(h.end(), previous.begin(), previous.end());
+            h.insert(h.end(), f.begin() + root + span, f.begin() + fStop);
+            g.insert(g.end(), next.begin(), next.end());
+            g.insert(g.end(), f.begin() + root + span, f.begin() + fStop);
+            if ((int) h.size() >= arrayLength || (int) g.size() >= arrayLength) {
+                continue;
+            }
+            f = h;
+            f.resize(arrayLength, STOP);
+            int end = root + (int) next.size();
+            if (kind == 4 && end < (int) g.size()) {
+                g[end + random() % (g.size() - end)] = 1 + (int) (random() % 8);
+            }
+        } else if (kind == 1) {
+            // One side of the law in place of the subtree at root, which is rarely the other side
+            g.assign(f.begin(), f.begin() + root);
+            g.insert(g.end(), next.begin(), next.end());
+            g.insert(g.end(), f.begin() + root + span, f.begin() + fStop);
+            if ((int) g.size() >= arrayLength) {
+                continue;
+            }
+        } else {
+            g = f;
+            g[random() % fStop] = 1 + (int) (random() % 8);
+            if (kind == 3) {
+                g[random() % fStop] = 1 + (int) (random() % 8);
+            }
+        }
+        g.resize(arrayLength, STOP);
+        steps++;
+        checker.storeInitialVariables(f.data());
+        bool result = checker.isTransformationByLaw(f.data(), g.data(), arrayLength, law);
+        bool expected = reference(f, g, rule);
+        if (result != expected) {
+            if (failures < 5) {
+                std::cout << "Law " << law << ": the step was " << (result ? "accepted" : "rejected")
+                          << " and the reference disagrees\n";
+            }
+            failures++;
+        }
+        if (result) {
+            accepted++;
+            std::vector<VariableRecord> counted, read;
+            checker.variables().save(counted);
+            reader.storeInitialVariables(g.data());
+            reader.variables().save(read);
+            if (!sameVariables(counted, read)) {
+                std::cout << "Law " << law << ": wrong variables in use after the step\n";
+                failures++;
+            }
+        }
+    }
+    std::cout << steps << " steps, " << accepted << " accepted: " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+// Compares every level of scanning kernels with the scalar kernels on random arrays that end at a guard page,
+// then times each level on long arrays
+// g++ -std=c++17 -O2 -I.. SymbolKernelsFuzz.cpp -o SymbolKernelsFuzz
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../SymbolKernels.h"
+
+template <class Symbol>
+int fuzz(std::mt19937& random, char* pageEnd) {
+    int failures = 0;
+    for (int trial = 0; trial < 200000; trial++) {
+        int n = (int) (random() % 300);
+        // Both arrays end at the guard page, so reading a symbol after n faults
+        Symbol* f = (Symbol*) pageEnd - n;
+        Symbol* g = (Symbol*) (pageEnd - 4096) - n;
+        for (int i = 0; i < n; i++) {
+            f[i] = (Symbol) (1 + random() % 3);
+            g[i] = f[i];
+        }
+        if (n > 0 && random() % 4 != 0) {
+            g[random() % n] = (Symbol) (random() % 4);
+            f[random() % n] = 0;
+        }
+        int mismatch = scalarFirstMismatch(f, g, n);
+        int stop = scalarFindStop(f, n);
+        for (int level = scalarKernels; level <= supportedKernelLevel(); level++) {
+            SymbolKernels<Symbol> kernels;
+            kernels.select(level);
+            if (kernels.firstMismatch(f, g, n) != mismatch || kernels.findStop(f, n) != stop) {
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+template <class Symbol>
+int benchmark(const char* name) {
+    int failures = 0;
+    std::vector<Symbol> f(1 << 16, 1), g(1 << 16, 1);
+    for (int level = scalarKernels; level <= supportedKernelLevel(); level++) {
+        SymbolKernels<Symbol> kernels;
+        kernels.select(level);
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < 2000; r++) {
+            int mismatch = (int) f.size() - 1 - r % 8;
+            g[mismatch] = 2;
+            if (kernels.firstMismatch(f.data(), g.data(), (int) f.size()) != mismatch || kernels.findStop(f.data(), (int) f.size()) != (int) f.size()) {
+                failures++;
+            }
+            g[mismatch] = 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << " level " << level << ": " << seconds * 1e9 / (2000.0 * 2 * f.size()) << " ns per symbol\n";
+    }
+    return failures;
+}
+
+int main() {
+    long pageSize = sysconf(_SC_PAGESIZE);
+    char* pages = (char*) mmap(nullptr, 3 * pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    mprotect(pages + 2 * pageSize, pageSize, PROT_NONE);
+    char* pageEnd = pages + 2 * pageSize;
+    std::mt19937 random(1);
+    int failures = fuzz<uint8_t>(random, pageEnd) + fuzz<uint16_t>(random, pageEnd) + fuzz<int>(random, pageEnd);
+    failures += benchmark<uint8_t>("8-bit") + benchmark<uint16_t>("16-bit") + benchmark<int>("32-bit");
+    std::cout << "Kernel levels up to " << supportedKernelLevel() << ": " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+// Compares TruthTable with a brute-force evaluator on random expressions of up to 14 variables at every lane width:
+// the class of each expression, and the value of every assignment that findAssignment, isTautology and
+// isContradiction return. Loads that fail, of expressions without STOP or that are not one Polish expression,
+// must leave no expression loaded
+// g++ -std=c++17 -O2 -I.. TruthTableFuzz.cpp -o TruthTableFuzz
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../TruthTable.h"
+
+void randomExpression(std::mt19937& random, int variableCount, int depth, std::vector<int>& f) {
+    int kind = (int) (random() % 10);
+    if (depth == 0 || kind < 3) {
+        int leaf = (int) (random() % 12);
+        f.push_back(leaf == 0 ? FALSE : leaf == 1 ? TRUE : minVariable + (int) (random() % variableCount));
+    } else if (kind < 5) {
+        f.push_back(NOT);
+        randomExpression(random, variableCount, depth - 1, f);
+    } else {
+        f.push_back(kind < 8 ? OR : AND);
+        randomExpression(random, variableCount, depth - 1, f);
+        randomExpression(random, variableCount, depth - 1, f);
+    }
+}
+
+// Value of the subexpression at position, which moves past it, where variable v has the value of bit v - minVariable
+bool evaluate(const std::vector<int>& f, size_t& position, uint64_t values) {
+    int symbol = f[position++];
+    if (symbol == NOT) {
+        return !evaluate(f, position, values);
+    }
+    if (symbol == OR || symbol == AND) {
+        bool left = evaluate(f, position, values);
+        bool right = evaluate(f, position, values);
+        return symbol == OR ? left || right : left && right;
+    }
+    return symbol == TRUE || (isVariable(symbol) && ((values >> (symbol - minVariable)) & 1));
+}
+
+// Value under an assignment of the variables that the checker lists, in its order
+bool evaluateAssignment(const std::vector<int>& f, const std::vector<int>& names, const std::vector<char>& assignment) {
+    uint64_t values = 0;
+    for (size_t v = 0; v < names.size() && v < assignment.size(); v++) {
+        values |= (uint64_t) (assignment[v] != 0) << (names[v] - minVariable);
+    }
+    size_t position = 0;
+    return evaluate(f, position, values);
+}
+
+long failures = 0;
+
+void fail(int trial, int lanes, const char* message) {
+    if (failures < 10) {
+        std::cout << "Trial " << trial << ", " << lanes << " lanes: " << message << "\n";
+    }
+    failures++;
+}
+
+int main(int argc, char** argv) {
+    std::mt19937 random(argc > 1 ? atoi(argv[1]) : 1);
+    long counts[3] = {0, 0, 0};
+    for (int trial = 0; trial < 20000; trial++) {
+        int variableCount = 1 + (int) (random() % 14);
+        std::vector<int> f;
+        randomExpression(random, variableCount, 2 + (int) (random() % 6), f);
+        // The class of the expression over every assignment of the variables it has
+        std::vector<int> names;
+        for (int symbol : f) {
+            if (isVariable(symbol) && std::find(names.begin(), names.end(), symbol) == names.end()) {
+                names.push_back(symbol);
+            }
+        }
+        uint64_t mask = 0;
+        for (int name : names) {
+            mask |= 1ULL << (name - minVariable);
+        }
+        bool satisfied = false, falsified = false;
+        for (uint64_t values = 0; ; values = (values - mask) & mask) {
+            size_t position = 0;
+            (evaluate(f, position, values) ? satisfied : falsified) = true;
+            if (((values - mask) & mask) == 0) {
+                break;
+            }
+        }
+        int expected = !falsified ? tautology : !satisfied ? contradiction : contingent;
+        counts[expected]++;
+        std::vector<int> array = f;
+        array.resize(f.size() + 1 + random() % 4, STOP);
+        TruthTable table;
+        for (int lanes : {64, 256, 512}) {
+            table.selectLanes(lanes);
+            if (!table.load(array.data(), (int) array.size())) {
+                fail(trial, lanes, "an expression was not loaded");
+                continue;
+            }
+            std::vector<int> sorted = names;
+            std::sort(sorted.begin(), sorted.end());
+            if (table.variables() != sorted || table.variableCount() != (int) names.size()) {
+                fail(trial, lanes, "wrong variables");
+            }
+            if (table.classify() != expected) {
+                fail(trial, lanes, "wrong class");
+            }
+            for (bool value : {false, true}) {
+                std::vector<char> assignment;
+                bool found = table.findAssignment(value, &assignment);
+                if (found != (value ? satisfied : falsified)
+                    || (found && evaluateAssignment(f, table.variables(), assignment) != value)) {
+                    fail(trial, lanes, "wrong assignment");
+                }
+            }
+            std::vector<char> counterexample;
+            if (table.isTautology(&counterexample) != (expected == tautology)
+                || (expected != tautology && evaluateAssignment(f, table.variables(), counterexample))) {
+                fail(trial, lanes, "wrong tautology verdict");
+            }
+            if (table.isContradiction(&counterexample) != (expected == contradiction)
+                || (expected != contradiction && !evaluateAssignment(f, table.variables(), counterexample))) {
+                fail(trial, lanes, "wrong contradiction verdict");
+            }
+        }
+        // A load that fails after this expression leaves none loaded
+        std::vector<int> broken = f;
+        int kind = (int) (random() % 3);
+        if (kind == 0) {
+            // No STOP
+            broken.resize(f.size());
+        } else if (kind == 1) {
+            // An operand is missing
+            broken.pop_back();
+            broken.push_back(STOP);
+        } else {
+            // Two expressions
+            broken.push_back(minVariable);
+            broken.push_back(STOP);
+        }
+        if (table.load(broken.data(), (int) broken.size())) {
+            fail(trial, table.lanes(), "an expression that is not one Polish expression was loaded");
+        }
+        std::vector<char> assignment;
+        if (table.classify() != notLoaded || table.isTautology(nullptr) || table.isContradiction(nullptr)
+            || table.findAssignment(true, &assignment) || table.findAssignment(false, &assignment)) {
+            fail(trial, table.lanes(), "a failed load left an expression loaded");
+        }
+    }
+    std::cout << counts[contingent] << " contingent, " << counts[tautology] << " tautologies, " << counts[contradiction]
+              << " contradictions, lanes up to " << TruthTable().lanes() << ": " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
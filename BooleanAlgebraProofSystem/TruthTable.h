@@ -0,0 +1,177 @@
+#ifndef TRUTH_TABLE_H
+#define TRUTH_TABLE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "FormulaTape.h"
+#include "ProofEngine.h"
+
+// Bitsliced truth-table evaluator for Boolean expressions in Polish notation.
+// The expression is compiled once into a FormulaTape, and each pass runs the tape once on blocks of 64, 256 or 512 assignments, where bit i of a block is
+// the value under assignment i. The first variables are fixed bit patterns within a block, and every other
+// variable is a whole block of ones or zeros that is toggled between passes, so there is no limit on the
+// number of variables apart from the number of passes
+
+// Classes of Boolean expressions
+const int contingent = 0; // Satisfied by some assignments but not all
+const int tautology = 1; // Satisfied by every assignment
+const int contradiction = 2; // Satisfied by no assignment
+const int notLoaded = 3; // No expression is loaded, or the last one could not be compiled
+
+class TruthTable {
+    public:
+        TruthTable();
+        bool load(int f[], int fLength);
+        int variableCount() const;
+        const std::vector<int>& variables() const;
+        int lanes() const;
+        void selectLanes(int laneCount);
+        bool findAssignment(bool value, std::vector<char>* assignment);
+        bool isTautology(std::vector<char>* counterexample);
+        bool isContradiction(std::vector<char>* counterexample);
+        int classify();
+    private:
+        FormulaTape tape;
+        bool loaded;
+        int laneCount; // Assignments per pass
+        std::vector<uint64_t> blockStorage; // Registers of the tape, in blocks
+        template <int words> bool search(bool value, std::vector<char>* assignment);
+#ifdef SYMBOL_KERNELS_X86
+        __attribute__((target("avx2"))) bool searchAvx2(bool value, std::vector<char>* assignment);
+        __attribute__((target("avx512f"))) bool searchAvx512(bool value, std::vector<char>* assignment);
+#endif
+};
+
+inline TruthTable::TruthTable() {
+    int level = supportedKernelLevel();
+    laneCount = level >= avx512Kernels ? 512 : level >= avx2Kernels ? 256 : 64;
+    loaded = false;
+}
+
+inline bool TruthTable::load(int f[], int fLength) {
+    loaded = tape.compile(f, fLength);
+    return loaded;
+}
+
+inline int TruthTable::variableCount() const {
+    return tape.variableCount();
+}
+
+inline const std::vector<int>& TruthTable::variables() const {
+    return tape.variables();
+}
+
+inline int TruthTable::lanes() const {
+    return laneCount;
+}
+
+inline void TruthTable::selectLanes(int lanes) {
+    // A lower width than the processor supports, such as for benchmarks
+    int level = supportedKernelLevel();
+    laneCount = lanes >= 512 && level >= avx512Kernels ? 512 : lanes >= 256 && level >= avx2Kernels ? 256 : 64;
+}
+
+template <int words>
+__attribute__((always_inline)) inline bool TruthTable::search(bool value, std::vector<char>* assignment) {
+    const int laneBits = words == 1 ? 6 : words == 4 ? 8 : 9; // log2 of the assignments per pass
+    int variableTotal = variableCount();
+    blockStorage.assign(tape.registerCount() * words, 0);
+    AssignmentBlock<words>* registers = reinterpret_cast<AssignmentBlock<words>*>(blockStorage.data());
+    // Variables 0 to 5 alternate within each word, and the next variables alternate between the words of a block
+    const uint64_t patterns[6] = {0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+        0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+    int laneVariables = std::min(variableTotal, laneBits);
+    for (int v = 0; v < laneVariables; v++) {
+        for (int w = 0; w < words; w++) {
+            registers[v].bits[w] = v < 6 ? patterns[v] : ((w >> (v - 6)) & 1 ? ~0ULL : 0);
+        }
+    }
+    // The other variables count the passes, starting with all of them false
+    int passVariables = variableTotal - laneVariables;
+    std::vector<uint64_t> pass((passVariables + 63) / 64 + 1, 0);
+    while (true) {
+        tape.run<words>(registers);
+        AssignmentBlock<words> result = tape.result<words>(registers);
+        for (int w = 0; w < words; w++) {
+            uint64_t found = value ? result.bits[w] : ~result.bits[w];
+            if (found != 0) {
+                if (assignment != nullptr) {
+                    int lane = w * 64 + __builtin_ctzll(found);
+                    assignment->assign(variableTotal, false);
+                    for (int v = 0; v < laneVariables; v++) {
+                        (*assignment)[v] = (lane >> v) & 1;
+                    }
+                    for (int v = 0; v < passVariables; v++) {
+                        (*assignment)[laneVariables + v] = (pass[v / 64] >> (v % 64)) & 1;
+                    }
+                }
+                return true;
+            }
+        }
+        // Toggle the pass variables like a binary counter, which only touches the variables whose bits change
+        int v = 0;
+        while (v < passVariables) {
+            pass[v / 64] ^= 1ULL << (v % 64);
+            bool set = (pass[v / 64] >> (v % 64)) & 1;
+            for (int w = 0; w < words; w++) {
+                registers[laneVariables + v].bits[w] = set ? ~0ULL : 0;
+            }
+            if (set) {
+                break;
+            }
+            v++;
+        }
+        if (v == passVariables) {
+            // Every assignment has been evaluated
+            return false;
+        }
+    }
+}
+
+#ifdef SYMBOL_KERNELS_X86
+// The same search compiled for wider registers, where 4 or 8 words of a block fit in one register
+inline bool TruthTable::searchAvx2(bool value, std::vector<char>* assignment) {
+    return search<4>(value, assignment);
+}
+
+inline bool TruthTable::searchAvx512(bool value, std::vector<char>* assignment) {
+    return search<8>(value, assignment);
+}
+#endif
+
+inline bool TruthTable::findAssignment(bool value, std::vector<char>* assignment) {
+    // Finds an assignment under which the expression has the given value, and stops at the first one
+    if (!loaded) {
+        return false;
+    }
+#ifdef SYMBOL_KERNELS_X86
+    if (laneCount == 512) {
+        return searchAvx512(value, assignment);
+    } else if (laneCount == 256) {
+        return searchAvx2(value, assignment);
+    }
+#endif
+    return search<1>(value, assignment);
+}
+
+inline bool TruthTable::isTautology(std::vector<char>* counterexample) {
+    return loaded && !findAssignment(false, counterexample);
+}
+
+inline bool TruthTable::isContradiction(std::vector<char>* counterexample) {
+    return loaded && !findAssignment(true, counterexample);
+}
+
+inline int TruthTable::classify() {
+    if (!loaded) {
+        return notLoaded;
+    }
+    if (!findAssignment(true, nullptr)) {
+        return contradiction;
+    }
+    return findAssignment(false, nullptr) ? contingent : tautology;
+}
+
+#endif
@@ -0,0 +1,69 @@
+// VerifyCorpus checks every proof of a proof corpus in order and writes a bit for each proof to a verdict file.
+// The corpus is mapped and read in place, with pages read ahead and dropped behind the current proof, so memory
+// stays bounded whatever the size of the corpus. The law set is PE21LF, or PE12L when compiled with CORPUS_PE12L.
+// Usage: VerifyCorpus <corpus> <verdicts> [<rules>]
+
+#include <chrono>
+#include <iostream>
+
+#ifdef CORPUS_PE12L
+#include "PE12L.h"
+typedef PE12L CorpusLawSet;
+#else
+#include "PE21LF.h"
+typedef PE21LF CorpusLawSet;
+#endif
+#include "ProofCorpus.h"
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <corpus> <verdicts> [<rules>]\n";
+        return 2;
+    }
+    ProofCorpus corpus;
+    if (!corpus.open(argv[1])) {
+        std::cerr << "Cannot read the proof corpus " << argv[1] << "\n";
+        return 2;
+    }
+    if (corpus.lawCount() != CorpusLawSet::lawCount) {
+        std::cerr << "The proof corpus is for a law set with " << corpus.lawCount() << " laws instead of "
+            << CorpusLawSet::lawCount << "\n";
+        return 2;
+    }
+    DeltaVerifier<CorpusLawSet> verifier;
+    RuleSet rules;
+    if (argc == 4) {
+        if (!rules.load(argv[3])) {
+            if (rules.errorLine() == 0) {
+                std::cerr << "Cannot read the rewrite rules " << argv[3] << "\n";
+            } else {
+                std::cerr << "Cannot compile the rewrite rule on line " << rules.errorLine() << " of " << argv[3] << "\n";
+            }
+            return 2;
+        }
+        verifier.setRules(&rules);
+    }
+    ProofVerdictWriter verdicts;
+    if (!verdicts.open(argv[2])) {
+        std::cerr << "Cannot write the verdicts " << argv[2] << "\n";
+        return 2;
+    }
+    auto start = std::chrono::steady_clock::now();
+    CorpusProof proof;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        corpus.advance(i);
+        // A proof that does not fit in the file is not correct
+        verdicts.add(corpus.proof(i, &proof) && verifier.isProofSequence(proof.formula, proof.fLength,
+            proof.steps, proof.stepCount, proof.inserted, proof.insertedLength, proof.target));
+    }
+    uint64_t proofCount = verdicts.proofCount();
+    uint64_t correctCount = verdicts.correctCount();
+    if (!verdicts.close()) {
+        std::cerr << "Cannot write the verdicts " << argv[2] << "\n";
+        return 2;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << proofCount << " proofs: " << correctCount << " correct, " << proofCount - correctCount
+        << " NOT correct, in " << seconds << " seconds\n";
+    return correctCount == proofCount ? 0 : 1;
+}